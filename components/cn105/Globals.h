@@ -9,4 +9,5 @@
 #include "esphome/components/uart/uart.h"
 
 #define CUSTOM_MILLIS esphome::millis()
+#define CUSTOM_MICROS esphome::micros()
 #define CUSTOM_DELAY(x) esphome::delay(x)
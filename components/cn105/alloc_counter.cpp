@@ -0,0 +1,74 @@
+#include "alloc_counter.h"
+
+#ifdef CN105_ALLOC_TRACKING
+
+#include <cstdlib>
+#include <new>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome {
+
+    volatile uint32_t AllocCounter::count_ = 0;
+    volatile uint32_t AllocCounter::bytes_ = 0;
+
+    static bool watching = false;
+#ifdef USE_ESP32
+    static TaskHandle_t watched_task = nullptr;
+#endif
+
+    void AllocCounter::watch_current_task() {
+#ifdef USE_ESP32
+        watched_task = xTaskGetCurrentTaskHandle();
+#endif
+        watching = true;
+    }
+
+    void AllocCounter::record(size_t size) {
+        if (!watching) {
+            return;     // constructeurs statiques, avant le scheduler FreeRTOS
+        }
+#ifdef USE_ESP32
+        if (xTaskGetCurrentTaskHandle() != watched_task) {
+            return;
+        }
+#endif
+        count_ = count_ + 1;
+        bytes_ = bytes_ + size;
+    }
+
+}
+
+static void* counted_alloc(size_t size) {
+    esphome::AllocCounter::record(size);
+    return malloc(size != 0 ? size : 1);
+}
+
+static void* counted_alloc_or_fail(size_t size) {
+    void* p = counted_alloc(size);
+    if (p == nullptr) {
+#if __cpp_exceptions
+        throw std::bad_alloc();
+#else
+        abort();
+#endif
+    }
+    return p;
+}
+
+void* operator new(size_t size) { return counted_alloc_or_fail(size); }
+void* operator new[](size_t size) { return counted_alloc_or_fail(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#endif
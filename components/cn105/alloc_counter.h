@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace esphome {
+
+    /**
+     * @class AllocCounter
+     * @brief Nombre et taille des allocations (operator new) faites par la tâche du loop ESPHome.
+     *
+     * Actif seulement avec -DCN105_ALLOC_TRACKING (loop_profiler: track_allocations: true): operator new
+     * est alors remplacé dans alloc_counter.cpp. Sans ce flag, count() vaut toujours 0 et le LoopProfiler
+     * ne mesure rien de plus.
+     * Rien n'est compté avant watch_current_task(), appelé depuis setup(). Sur ESP32, seule cette tâche est
+     * comptée: la tâche RX, l'émulateur et le serveur HTTP allouent de leur côté. Les appels directs à
+     * malloc() (lwIP, logger) ne passent pas par ici.
+     */
+    class AllocCounter {
+    public:
+#ifdef CN105_ALLOC_TRACKING
+        static constexpr bool ENABLED = true;
+        static void watch_current_task();
+        static void record(size_t size);
+        static uint32_t count() { return count_; }
+        static uint32_t bytes() { return bytes_; }
+
+    private:
+        static volatile uint32_t count_;
+        static volatile uint32_t bytes_;
+#else
+        static constexpr bool ENABLED = false;
+        static void watch_current_task() {}
+        static uint32_t count() { return 0; }
+        static uint32_t bytes() { return 0; }
+#endif
+    };
+
+}
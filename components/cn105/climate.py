@@ -28,11 +28,15 @@ from esphome.const import (
     CONF_ENTITY_CATEGORY,
     ENTITY_CATEGORY_DIAGNOSTIC,
     STATE_CLASS_TOTAL_INCREASING,
+    STATE_CLASS_MEASUREMENT,
     UNIT_SECOND,
+    UNIT_MILLISECOND,
+    UNIT_PERCENT,
     ICON_TIMER,
     DEVICE_CLASS_DURATION,
     CONF_TX_PIN,
     CONF_RX_PIN,
+    __version__ as ESPHOME_VERSION,
 )
 from esphome.components.sensor import (
     CONF_UNIT_OF_MEASUREMENT as SENSOR_CONF_UNIT_OF_MEASUREMENT,
@@ -64,6 +68,7 @@ CONF_VERTICAL_SWING_SELECT = "vertical_vane_select"
 CONF_COMPRESSOR_FREQUENCY_SENSOR = "compressor_frequency_sensor"
 CONF_INPUT_POWER_SENSOR = "input_power_sensor"
 CONF_KWH_SENSOR = "kwh_sensor"
+CONF_TOTAL_ENERGY_SENSOR = "total_energy_sensor"
 CONF_RUNTIME_HOURS_SENSOR = "runtime_hours_sensor"
 CONF_OUTSIDE_AIR_TEMPERATURE_SENSOR = "outside_air_temperature_sensor"
 CONF_ISEE_SENSOR = "isee_sensor"
@@ -109,6 +114,33 @@ CONF_REMOTE_TEMP_TIMEOUT = "remote_temperature_timeout"
 CONF_DEBOUNCE_DELAY = "debounce_delay"
 CONF_CONNECTION_BOOTSTRAP_DELAY = "connection_bootstrap_delay"
 CONF_INSTALLER_MODE = "installer_mode"
+CONF_UART_RX_TASK = "uart_rx_task"
+CONF_EVENT_DRIVEN_LOOP = "event_driven_loop"
+CONF_WARM_START = "warm_start"
+CONF_COMPACT_BUFFERS = "compact_buffers"
+CONF_BAUD_RATES = "baud_rates"
+CONF_LINK_LOSS_DETECTION_SENSOR = "link_loss_detection_sensor"
+CONF_LINK_RECONNECT_SENSOR = "link_reconnect_sensor"
+CONF_RESTORED_STATE_SENSOR = "restored_state_sensor"
+CONF_EMULATOR_PROXY_MODE = "emulator_proxy_mode"
+CONF_REMOTE_EMULATOR = "remote_emulator"
+CONF_DEADBAND = "deadband"
+CONF_MIN_INTERVAL = "min_interval"
+CONF_MAX_INTERVAL = "max_interval"
+CONF_TELEMETRY_HISTORY = "telemetry_history"
+CONF_SIZE = "size"
+CONF_PORT = "port"
+CONF_LOOP_PROFILER = "loop_profiler"
+CONF_REPORT_INTERVAL = "report_interval"
+CONF_MAX_SENSOR = "max_sensor"
+CONF_P99_SENSOR = "p99_sensor"
+CONF_TRACK_ALLOCATIONS = "track_allocations"
+CONF_ALLOCATIONS_SENSOR = "allocations_sensor"
+CONF_LINK_STATS = "link_stats"
+CONF_BUSY_SENSOR = "busy_sensor"
+CONF_ERRORS_SENSOR = "errors_sensor"
+CONF_TX_BYTES_SENSOR = "tx_bytes_sensor"
+CONF_RX_BYTES_SENSOR = "rx_bytes_sensor"
 
 # Définitions des classes C++ (identiques à votre version)
 VaneOrientationSelect = cg.global_ns.class_(
@@ -119,6 +151,7 @@ CompressorFrequencySensor = cg.global_ns.class_(
 )
 InputPowerSensor = cg.global_ns.class_("InputPowerSensor", sensor.Sensor, cg.Component)
 kWhSensor = cg.global_ns.class_("kWhSensor", sensor.Sensor, cg.Component)
+TotalEnergySensor = cg.global_ns.class_("TotalEnergySensor", sensor.Sensor, cg.Component)
 RuntimeHoursSensor = cg.global_ns.class_(
     "RuntimeHoursSensor", sensor.Sensor, cg.Component
 )
@@ -126,6 +159,9 @@ OutsideAirTemperatureSensor = cg.global_ns.class_(
     "OutsideAirTemperatureSensor", sensor.Sensor, cg.Component
 )
 ISeeSensor = cg.global_ns.class_("ISeeSensor", binary_sensor.BinarySensor, cg.Component)
+RestoredStateSensor = cg.global_ns.class_(
+    "RestoredStateSensor", binary_sensor.BinarySensor, cg.Component
+)
 StageSensor = cg.global_ns.class_("StageSensor", text_sensor.TextSensor, cg.Component)
 FunctionsSensor = cg.global_ns.class_(
     "FunctionsSensor", text_sensor.TextSensor, cg.Component
@@ -147,6 +183,7 @@ HVACOptionSwitch = cg.global_ns.class_("HVACOptionSwitch", switch.Switch, cg.Com
 HardwareSettingSelect = cg.global_ns.class_(
     "HardwareSettingSelect", select.Select, cg.Component
 )
+HPEmulator = cg.global_ns.namespace("HVAC").class_("HPEmulator", cg.Component)
 
 
 # --- Fonction d'aide pour récupérer les pins TX/RX (identique à votre version corrigée) ---
@@ -193,28 +230,54 @@ def get_uart_port_index(core_config, target_uart_id_str):
 
 # --- FIN de la fonction d'aide ---
 
+# Politique de publication des capteurs de télémétrie (ThrottledSensor): bande morte
+# par rapport à la dernière valeur publiée, intervalle min entre deux publications,
+# republication forcée après max_interval. 0 = désactivé (publie à chaque changement).
+TELEMETRY_THROTTLE_SCHEMA = {
+    cv.Optional(CONF_DEADBAND, default=0.0): cv.positive_float,
+    cv.Optional(CONF_MIN_INTERVAL, default="0s"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_MAX_INTERVAL, default="0s"): cv.positive_time_period_milliseconds,
+}
+
+
+def throttle_to_code(sensor_var, conf_item):
+    cg.add(sensor_var.set_deadband(conf_item[CONF_DEADBAND]))
+    cg.add(sensor_var.set_min_interval(conf_item[CONF_MIN_INTERVAL].total_milliseconds))
+    cg.add(sensor_var.set_max_interval(conf_item[CONF_MAX_INTERVAL].total_milliseconds))
+
+
 # Schémas pour les entités optionnelles (identiques à votre version)
 SELECT_SCHEMA = select.select_schema(VaneOrientationSelect).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(VaneOrientationSelect)}
 )
 COMPRESSOR_FREQUENCY_SENSOR_SCHEMA = sensor.sensor_schema(
     CompressorFrequencySensor
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(CompressorFrequencySensor)})
+).extend({cv.GenerateID(CONF_ID): cv.declare_id(CompressorFrequencySensor)}).extend(
+    TELEMETRY_THROTTLE_SCHEMA
+)
 INPUT_POWER_SENSOR_SCHEMA = sensor.sensor_schema(InputPowerSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(InputPowerSensor)}
-)
+).extend(TELEMETRY_THROTTLE_SCHEMA)
 KWH_SENSOR_SCHEMA = sensor.sensor_schema(kWhSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(kWhSensor)}
-)
+).extend(TELEMETRY_THROTTLE_SCHEMA)
+TOTAL_ENERGY_SENSOR_SCHEMA = sensor.sensor_schema(TotalEnergySensor).extend(
+    {cv.GenerateID(CONF_ID): cv.declare_id(TotalEnergySensor)}
+).extend(TELEMETRY_THROTTLE_SCHEMA)
 RUNTIME_HOURS_SENSOR_SCHEMA = sensor.sensor_schema(RuntimeHoursSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(RuntimeHoursSensor)}
-)
+).extend(TELEMETRY_THROTTLE_SCHEMA)
 OUTSIDE_AIR_TEMPERATURE_SENSOR_SCHEMA = sensor.sensor_schema(
     OutsideAirTemperatureSensor
-).extend({cv.GenerateID(CONF_ID): cv.declare_id(OutsideAirTemperatureSensor)})
+).extend({cv.GenerateID(CONF_ID): cv.declare_id(OutsideAirTemperatureSensor)}).extend(
+    TELEMETRY_THROTTLE_SCHEMA
+)
 ISEE_SENSOR_SCHEMA = binary_sensor.binary_sensor_schema(ISeeSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(ISeeSensor)}
 )
+RESTORED_STATE_SENSOR_SCHEMA = binary_sensor.binary_sensor_schema(
+    RestoredStateSensor, entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+).extend({cv.GenerateID(CONF_ID): cv.declare_id(RestoredStateSensor)})
 FUNCTIONS_SENSOR_SCHEMA = text_sensor.text_sensor_schema(FunctionsSensor).extend(
     {cv.GenerateID(CONF_ID): cv.declare_id(FunctionsSensor)}
 )
@@ -240,6 +303,15 @@ STAGE_SENSOR_CONFIG_SCHEMA = text_sensor.text_sensor_schema(StageSensor).extend(
 )
 
 # Schéma pour HP_UP_TIME_CONNECTION_SENSOR (identique à votre version)
+# Perte du lien CN105: délai de détection et de reconnexion (ms), publiés à chaque perte
+LINK_TIME_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    device_class=DEVICE_CLASS_DURATION,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
 HP_UP_TIME_CONNECTION_SENSOR_SCHEMA = sensor.sensor_schema(
     HpUpTimeConnectionSensor,
     unit_of_measurement=UNIT_SECOND,
@@ -262,6 +334,7 @@ HARDWARE_SETTING_ITEM_SCHEMA = select.select_schema(HardwareSettingSelect).exten
 )
 
 CONF_HARDWARE_SETTINGS_LIST = "list"
+CONF_WRITE_RESULT = "write_result"
 
 HARDWARE_SETTING_SCHEMA = cv.Schema(
     {
@@ -269,6 +342,92 @@ HARDWARE_SETTING_SCHEMA = cv.Schema(
         cv.Required(CONF_HARDWARE_SETTINGS_LIST): cv.ensure_list(
             HARDWARE_SETTING_ITEM_SCHEMA
         ),
+        # Résultat de la dernière écriture (codes acceptés / refusés par l'unité après relecture)
+        cv.Optional(CONF_WRITE_RESULT): text_sensor.text_sensor_schema(
+            FunctionsSensor, entity_category=ENTITY_CATEGORY_DIAGNOSTIC
+        ),
+    }
+)
+
+# disable_loop() et enable_loop_soon_any_context() n'existent qu'à partir d'ESPHome 2025.7
+EVENT_DRIVEN_LOOP_MIN_VERSION = cv.Version(2025, 7, 0)
+
+
+def validate_event_driven_loop(value):
+    value = cv.boolean(value)
+    if value and cv.Version.parse(ESPHOME_VERSION) < EVENT_DRIVEN_LOOP_MIN_VERSION:
+        raise cv.Invalid(
+            f"{CONF_EVENT_DRIVEN_LOOP} requires ESPHome {EVENT_DRIVEN_LOOP_MIN_VERSION} or later"
+        )
+    return value
+
+
+# Émulateur de PAC pour une télécommande filaire, lié à ce climate et à son propre UART
+REMOTE_EMULATOR_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(HPEmulator),
+        cv.Required(CONF_UART_ID): cv.use_id(uart.UARTComponent),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+# Historique compressé de la télémétrie, téléchargeable en HTTP (/history.bin, /history.csv)
+TELEMETRY_HISTORY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_SIZE, default=16384): cv.int_range(min=1024, max=4194304),
+        cv.Optional(CONF_PORT, default=8082): cv.port,
+    }
+)
+
+# Profil du loop par phase (min/moyenne/p99/max en µs), rapport périodique dans les logs
+LOOP_TIME_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement="µs",
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+LOOP_PROFILER_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_REPORT_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MAX_SENSOR): LOOP_TIME_SENSOR_SCHEMA,
+        cv.Optional(CONF_P99_SENSOR): LOOP_TIME_SENSOR_SCHEMA,
+        # Compte les allocations (operator new) par phase; remplace operator new pour tout le firmware
+        cv.Optional(CONF_TRACK_ALLOCATIONS, default=False): cv.boolean,
+        cv.Optional(CONF_ALLOCATIONS_SENSOR): sensor.sensor_schema(
+            icon="mdi:memory",
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+    }
+)
+
+# Statistiques du lien CN105 (occupation, erreurs, octets), blob binaire sur /stats.bin si telemetry_history
+LINK_BYTES_SENSOR_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement="B",
+    icon="mdi:swap-horizontal",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+LINK_STATS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_REPORT_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_BUSY_SENSOR): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            icon="mdi:gauge",
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_ERRORS_SENSOR): sensor.sensor_schema(
+            icon="mdi:alert-circle-outline",
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+        ),
+        cv.Optional(CONF_TX_BYTES_SENSOR): LINK_BYTES_SENSOR_SCHEMA,
+        cv.Optional(CONF_RX_BYTES_SENSOR): LINK_BYTES_SENSOR_SCHEMA,
     }
 )
 
@@ -293,6 +452,8 @@ CONFIG_SCHEMA = (
             ): COMPRESSOR_FREQUENCY_SENSOR_SCHEMA,
             cv.Optional(CONF_INPUT_POWER_SENSOR): INPUT_POWER_SENSOR_SCHEMA,
             cv.Optional(CONF_KWH_SENSOR): KWH_SENSOR_SCHEMA,
+            # total persisté en flash, indépendant du compteur 16 bits de la PAC
+            cv.Optional(CONF_TOTAL_ENERGY_SENSOR): TOTAL_ENERGY_SENSOR_SCHEMA,
             cv.Optional(CONF_RUNTIME_HOURS_SENSOR): RUNTIME_HOURS_SENSOR_SCHEMA,
             cv.Optional(
                 CONF_OUTSIDE_AIR_TEMPERATURE_SENSOR
@@ -321,6 +482,33 @@ CONFIG_SCHEMA = (
                 cv.update_interval
             ),
             cv.Optional(CONF_INSTALLER_MODE, default=False): cv.boolean,
+            # Lecture UART dans une tâche dédiée (trames validées remises au loop)
+            cv.Optional(CONF_UART_RX_TASK, default=False): cv.boolean,
+            # Désactive le loop entre deux échéances (économie CPU à l'arrêt)
+            cv.Optional(CONF_EVENT_DRIVEN_LOOP, default=False): validate_event_driven_loop,
+            # Republie au boot le dernier état confirmé (flash), handshake sans attendre le WiFi
+            cv.Optional(CONF_WARM_START, default=False): cv.boolean,
+            # Buffers de trame à la taille maximale d'une trame CN105 (22 octets au lieu de 64/256)
+            cv.Optional(CONF_COMPACT_BUFFERS, default=False): cv.boolean,
+            # Débits essayés au CONNECT (le premier qui répond est mémorisé), ex: [2400, 4800, 9600]
+            cv.Optional(CONF_BAUD_RATES): cv.ensure_list(
+                cv.one_of(2400, 4800, 9600, int=True)
+            ),
+            cv.Optional(CONF_RESTORED_STATE_SENSOR): RESTORED_STATE_SENSOR_SCHEMA,
+            cv.Optional(CONF_LINK_LOSS_DETECTION_SENSOR): LINK_TIME_SENSOR_SCHEMA,
+            cv.Optional(CONF_LINK_RECONNECT_SENSOR): LINK_TIME_SENSOR_SCHEMA,
+            # Émulateur: relaie les trames SET de la télécommande filaire sans passer par wantedSettings
+            cv.Optional(CONF_EMULATOR_PROXY_MODE, default=False): cv.boolean,
+            # driver UART et serveur HTTP d'ESP-IDF: ni ESP8266 ni Arduino
+            cv.Optional(CONF_REMOTE_EMULATOR): cv.All(
+                REMOTE_EMULATOR_SCHEMA, cv.only_with_esp_idf
+            ),
+            # serveur HTTP ESP-IDF: rien pour le servir sur ESP8266
+            cv.Optional(CONF_TELEMETRY_HISTORY): cv.All(
+                TELEMETRY_HISTORY_SCHEMA, cv.only_on_esp32
+            ),
+            cv.Optional(CONF_LOOP_PROFILER): LOOP_PROFILER_SCHEMA,
+            cv.Optional(CONF_LINK_STATS): LINK_STATS_SCHEMA,
             cv.Optional(
                 CONF_HP_UP_TIME_CONNECTION_SENSOR
             ): HP_UP_TIME_CONNECTION_SENSOR_SCHEMA,
@@ -359,6 +547,14 @@ def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID], uart_var)
 
     cg.add(var.set_installer_mode(config[CONF_INSTALLER_MODE]))
+    cg.add(var.set_uart_rx_task(config[CONF_UART_RX_TASK]))
+    cg.add(var.set_event_driven_loop(config[CONF_EVENT_DRIVEN_LOOP]))
+    cg.add(var.set_warm_start(config[CONF_WARM_START]))
+    if config[CONF_COMPACT_BUFFERS]:
+        cg.add_build_flag("-DCN105_COMPACT_BUFFERS")
+    for baud in config.get(CONF_BAUD_RATES, []):
+        cg.add(var.add_baud_rate(baud))
+    cg.add(var.set_emulator_proxy_mode(config[CONF_EMULATOR_PROXY_MODE]))
 
     cg.add(uart_var.set_data_bits(8))
     cg.add(uart_var.set_parity(UARTParityOptions.UART_CONFIG_PARITY_EVEN))
@@ -466,6 +662,7 @@ def to_code(config):
         ):  # S'assurer de ne pas l'écraser si l'user l'a mis
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
         cg.add(var.set_compressor_frequency_sensor(sensor_var))
 
     if CONF_INPUT_POWER_SENSOR in config:
@@ -473,6 +670,7 @@ def to_code(config):
         if "force_update" not in conf_item:
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
         cg.add(var.set_input_power_sensor(sensor_var))
 
     if CONF_KWH_SENSOR in config:
@@ -480,13 +678,23 @@ def to_code(config):
         if "force_update" not in conf_item:
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
         cg.add(var.set_kwh_sensor(sensor_var))
 
+    if CONF_TOTAL_ENERGY_SENSOR in config:
+        conf_item = config[CONF_TOTAL_ENERGY_SENSOR]
+        if "force_update" not in conf_item:
+            conf_item["force_update"] = False
+        sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
+        cg.add(var.set_total_energy_sensor(sensor_var))
+
     if CONF_RUNTIME_HOURS_SENSOR in config:
         conf_item = config[CONF_RUNTIME_HOURS_SENSOR]
         if "force_update" not in conf_item:
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
         cg.add(var.set_runtime_hours_sensor(sensor_var))
 
     if CONF_OUTSIDE_AIR_TEMPERATURE_SENSOR in config:
@@ -494,12 +702,25 @@ def to_code(config):
         if "force_update" not in conf_item:
             conf_item["force_update"] = False
         sensor_var = yield sensor.new_sensor(conf_item)
+        throttle_to_code(sensor_var, conf_item)
         cg.add(var.set_outside_air_temperature_sensor(sensor_var))
 
     if CONF_ISEE_SENSOR in config:
         bsensor_var = yield binary_sensor.new_binary_sensor(config[CONF_ISEE_SENSOR])
         cg.add(var.set_isee_sensor(bsensor_var))
 
+    if CONF_LINK_LOSS_DETECTION_SENSOR in config:
+        sensor_var = yield sensor.new_sensor(config[CONF_LINK_LOSS_DETECTION_SENSOR])
+        cg.add(var.set_link_loss_detection_sensor(sensor_var))
+
+    if CONF_LINK_RECONNECT_SENSOR in config:
+        sensor_var = yield sensor.new_sensor(config[CONF_LINK_RECONNECT_SENSOR])
+        cg.add(var.set_link_reconnect_sensor(sensor_var))
+
+    if CONF_RESTORED_STATE_SENSOR in config:
+        bsensor_var = yield binary_sensor.new_binary_sensor(config[CONF_RESTORED_STATE_SENSOR])
+        cg.add(var.set_restored_state_sensor(bsensor_var))
+
     if CONF_FUNCTIONS_SENSOR in config:
         tsensor_var = yield text_sensor.new_text_sensor(config[CONF_FUNCTIONS_SENSOR])
         cg.add(var.set_functions_sensor(tsensor_var))
@@ -592,13 +813,10 @@ def to_code(config):
             code = setting_conf[CONF_CODE]
             options_map = setting_conf[CONF_OPTIONS]
 
-            # Build inline initializer list for std::map: {{key1, "val1"}, {key2, "val2"}, ...}
-            map_entries = ", ".join(
-                [f'{{{val}, "{label}"}}' for val, label in options_map.items()]
-            )
-            map_expr = cg.RawExpression(f"std::map<int, std::string>{{{map_entries}}}")
+            # Labels des valeurs 1, 2, 3 en littéraux (nullptr si la valeur n'est pas proposée)
+            labels = [options_map.get(val, cg.nullptr) for val in (1, 2, 3)]
 
-            setting_var = cg.new_Pvariable(setting_conf[CONF_ID], code, map_expr)
+            setting_var = cg.new_Pvariable(setting_conf[CONF_ID], code, *labels)
 
             # Extract options list sorted by key (1, 2, 3...) to ensure consistent order
             options_list = [options_map[k] for k in sorted(options_map.keys())]
@@ -608,5 +826,56 @@ def to_code(config):
 
             cg.add(var.add_hardware_setting(setting_var))
 
+        if CONF_WRITE_RESULT in hw_config:
+            tsensor_var = yield text_sensor.new_text_sensor(hw_config[CONF_WRITE_RESULT])
+            cg.add(var.set_hardware_settings_result_sensor(tsensor_var))
+
+    if CONF_REMOTE_EMULATOR in config:
+        conf = config[CONF_REMOTE_EMULATOR]
+        emulator = cg.new_Pvariable(conf[CONF_ID])
+        yield cg.register_component(emulator, conf)
+        re_uart_var = yield cg.get_variable(conf[CONF_UART_ID])
+        # la télécommande parle le même protocole que la PAC: 8E1
+        cg.add(re_uart_var.set_data_bits(8))
+        cg.add(re_uart_var.set_parity(UARTParityOptions.UART_CONFIG_PARITY_EVEN))
+        cg.add(re_uart_var.set_stop_bits(1))
+        cg.add(emulator.set_remote_uart(re_uart_var))
+        cg.add(emulator.set_climate(var))
+
+    if CONF_TELEMETRY_HISTORY in config:
+        history = config[CONF_TELEMETRY_HISTORY]
+        cg.add(var.set_telemetry_history(history[CONF_SIZE], history[CONF_PORT]))
+
+    if CONF_LOOP_PROFILER in config:
+        profiler = config[CONF_LOOP_PROFILER]
+        cg.add(var.set_loop_profiler(profiler[CONF_REPORT_INTERVAL].total_milliseconds))
+        if CONF_MAX_SENSOR in profiler:
+            sensor_var = yield sensor.new_sensor(profiler[CONF_MAX_SENSOR])
+            cg.add(var.set_loop_max_sensor(sensor_var))
+        if CONF_P99_SENSOR in profiler:
+            sensor_var = yield sensor.new_sensor(profiler[CONF_P99_SENSOR])
+            cg.add(var.set_loop_p99_sensor(sensor_var))
+        if profiler[CONF_TRACK_ALLOCATIONS]:
+            cg.add_build_flag("-DCN105_ALLOC_TRACKING")
+            if CONF_ALLOCATIONS_SENSOR in profiler:
+                sensor_var = yield sensor.new_sensor(profiler[CONF_ALLOCATIONS_SENSOR])
+                cg.add(var.set_loop_allocs_sensor(sensor_var))
+
+    if CONF_LINK_STATS in config:
+        stats = config[CONF_LINK_STATS]
+        cg.add(var.set_link_stats(stats[CONF_REPORT_INTERVAL].total_milliseconds))
+        if CONF_BUSY_SENSOR in stats:
+            sensor_var = yield sensor.new_sensor(stats[CONF_BUSY_SENSOR])
+            cg.add(var.set_link_busy_sensor(sensor_var))
+        if CONF_ERRORS_SENSOR in stats:
+            sensor_var = yield sensor.new_sensor(stats[CONF_ERRORS_SENSOR])
+            cg.add(var.set_link_errors_sensor(sensor_var))
+        if CONF_TX_BYTES_SENSOR in stats:
+            sensor_var = yield sensor.new_sensor(stats[CONF_TX_BYTES_SENSOR])
+            cg.add(var.set_link_tx_bytes_sensor(sensor_var))
+        if CONF_RX_BYTES_SENSOR in stats:
+            sensor_var = yield sensor.new_sensor(stats[CONF_RX_BYTES_SENSOR])
+            cg.add(var.set_link_rx_bytes_sensor(sensor_var))
+
     yield cg.register_component(var, config)
     yield climate.register_climate(var, config)
@@ -12,7 +12,9 @@ using namespace esphome;
 
 void CN105Climate::checkPendingWantedSettings() {
     long now = CUSTOM_MILLIS;
-    if (!(this->wantedSettings.hasChanged) || (now - this->wantedSettings.lastChange < this->debounce_delay_)) {
+    wantedHeatpumpSettings pending;
+    this->wantedSettingsSlot_.read(pending);
+    if (!(pending.hasChanged) || (now - pending.lastChange < this->debounce_delay_)) {
         return;
     }
 
@@ -29,23 +31,10 @@ void CN105Climate::checkPendingWantedRunStates() {
     this->sendWantedRunStates();
 }
 
-void logCheckWantedSettingsMutex(wantedHeatpumpSettings& settings) {
-
-    if (settings.hasBeenSent) {
-        ESP_LOGE("control", "Mutex lock faillure: wantedSettings should be locked while sending.");
-        ESP_LOGD("control", "-- This is an assertion test on wantedSettings.hasBeenSent");
-        ESP_LOGD("control", "-- wantedSettings.hasBeenSent = true is unexpected");
-        ESP_LOGD("control", "-- should be false because mutex should prevent running this while sending");
-        ESP_LOGD("control", "-- and mutex should be released only when hasBeenSent is false");
-    }
-
-}
 void CN105Climate::controlDelegate(const esphome::climate::ClimateCall& call) {
     ESP_LOGD("control", "espHome control() interface method called...");
     bool updated = false;
 
-    logCheckWantedSettingsMutex(this->wantedSettings);
-
     updated = this->processModeChange(call) || updated;
     updated = this->processTemperatureChange(call) || updated;
     updated = this->processFanChange(call) || updated;
@@ -233,23 +222,30 @@ void CN105Climate::finalizeControlIfUpdated(bool updated) {
         return;
     }
     ESP_LOGD(LOG_ACTION_EVT_TAG, "clim.control() -> User changed something...");
-    logCheckWantedSettingsMutex(this->wantedSettings);
-    this->wantedSettings.hasChanged = true;
-    this->wantedSettings.hasBeenSent = false;
-    this->wantedSettings.lastChange = CUSTOM_MILLIS;
+    this->commitWantedSettings();
     this->debugSettings("control (wantedSettings)", this->wantedSettings);
     this->publish_state();
 }
 
 void CN105Climate::control(const esphome::climate::ClimateCall& call) {
-
-#ifdef USE_ESP32
-    std::lock_guard<std::mutex> guard(wantedSettingsMutex);
+    // pas de verrou: les modifications sont publiées en un seul instantané par commitWantedSettings()
     this->controlDelegate(call);
-#else    
-    this->emulateMutex("CONTROL_WANTED_SETTINGS", std::bind(&CN105Climate::controlDelegate, this, call));
-#endif    
+}
+
+/**
+ * Publishes the wantedSettings draft as one complete snapshot for the TX path
+ */
+void CN105Climate::commitWantedSettings() {
+    this->wantedSettings.hasChanged = true;
+    this->wantedSettings.hasBeenSent = false;
+    this->wantedSettings.lastChange = CUSTOM_MILLIS;
+    this->wantedSettingsSlot_.publish(this->wantedSettings);
+    this->wakeLoop();
+}
 
+void CN105Climate::publishWantedSettings(const wantedHeatpumpSettings& settings) {
+    this->wantedSettings = settings;
+    this->commitWantedSettings();
 }
 
 
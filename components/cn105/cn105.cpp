@@ -67,15 +67,14 @@ CN105Climate::CN105Climate(uart::UARTComponent* uart) :
     this->circulator_switch_ = nullptr;
 
     this->powerRequestWithoutResponses = 0;     // power request is not supported by all heatpump #112
+    this->link_.configure(LINK_RESPONSE_TIMEOUT_MS, LINK_MISSES_BEFORE_LOST, LINK_RETRY_MIN_MS, LINK_RETRY_MAX_MS);
 
     this->remote_temp_timeout_ = 4294967295;    // uint32_t max
     this->generateExtraComponents();
     this->loopCycle.init();
     this->wantedSettings.resetSettings();
+    this->wantedSettingsSlot_.publish(this->wantedSettings);
     this->wantedRunStates.resetSettings();
-#ifndef USE_ESP32
-    this->wantedSettingsMutex = false;
-#endif
 
     // Register info requests moved to setup() to ensure hardware_settings_ are populated
 }
@@ -86,22 +85,22 @@ void CN105Climate::registerInfoRequests() {
     // 0x02 Settings
     InfoRequest r_settings("settings", "Settings", 0x02, 3, 0);
     r_settings.onResponse = [this](CN105Climate& self) { (void)self; this->getSettingsFromResponsePacket(); };
-    scheduler_.register_request(r_settings);
+    scheduler_.register_request(std::move(r_settings));
 
     // 0x03 Room temperature
     InfoRequest r_room("room_temp", "Room temperature", 0x03, 3, 0);
     r_room.onResponse = [this](CN105Climate& self) { (void)self; this->getRoomTemperatureFromResponsePacket(); };
-    scheduler_.register_request(r_room);
+    scheduler_.register_request(std::move(r_room));
 
     // 0x06 Status
     InfoRequest r_status("status", "Status", 0x06, 3, 0);
     r_status.onResponse = [this](CN105Climate& self) { (void)self; this->getOperatingAndCompressorFreqFromResponsePacket(); };
-    scheduler_.register_request(r_status);
+    scheduler_.register_request(std::move(r_status));
 
     // 0x09 Standby/Power
     InfoRequest r_power("standby", "Power/Standby", 0x09, 3, 500);
     r_power.onResponse = [this](CN105Climate& self) { (void)self; this->getPowerFromResponsePacket(); };
-    scheduler_.register_request(r_power);
+    scheduler_.register_request(std::move(r_power));
 
     // 0x42 HVAC options
     InfoRequest r_hvac_opts("hvac_options", "HVAC options", 0x42, 3, 500);
@@ -110,16 +109,16 @@ void CN105Climate::registerInfoRequests() {
         return (this->air_purifier_switch_ != nullptr || this->night_mode_switch_ != nullptr || this->circulator_switch_ != nullptr);
         };
     r_hvac_opts.onResponse = [this](CN105Climate& self) { (void)self; this->getHVACOptionsFromResponsePacket(); };
-    scheduler_.register_request(r_hvac_opts);
+    scheduler_.register_request(std::move(r_hvac_opts));
 
     // Placeholders
     InfoRequest r_unknown("unknown", "Unknown", 0x04, 1, 0);
     r_unknown.disabled = true;
-    scheduler_.register_request(r_unknown);
+    scheduler_.register_request(std::move(r_unknown));
 
     InfoRequest r_timers("timers", "Timers", 0x05, 1, 0);
     r_timers.disabled = true;
-    scheduler_.register_request(r_timers);
+    scheduler_.register_request(std::move(r_timers));
 
     // Appel vers la nouvelle méthode dédiée
     this->registerHardwareSettingsRequests();
@@ -173,7 +172,7 @@ void CN105Climate::registerHardwareSettingsRequests() {
                 ESP_LOGD(LOG_FUNCTIONS_TAG, "Got functions packet 1 (via InfoRequest)");
             }
             };
-        scheduler_.register_request(r_funcs1);
+        scheduler_.register_request(std::move(r_funcs1));
 
         // --- Part 2 (0x22) ---
         InfoRequest r_funcs2("functions2", "Functions Part 2", 0x22, 3, 0, interval, LOG_FUNCTIONS_TAG);
@@ -187,7 +186,7 @@ void CN105Climate::registerHardwareSettingsRequests() {
                 self.functionsArrived();
             }
             };
-        scheduler_.register_request(r_funcs2);
+        scheduler_.register_request(std::move(r_funcs2));
 
     } else {
         ESP_LOGD(LOG_FUNCTIONS_TAG, "No hardware settings configured in YAML, skipping 0x20/0x22 requests");
@@ -264,6 +263,12 @@ bool CN105Climate::is_circulator() {
 // SERIAL_8E1
 void CN105Climate::setupUART() {
 
+    // baud_rates: débit choisi différent de celui avec lequel le driver UART a été installé
+    if (this->link_baud_ != 0 && this->link_baud_ != this->parent_->get_baud_rate()) {
+        this->parent_->set_baud_rate(this->link_baud_);
+        this->force_low_level_uart_reinit();
+    }
+
     log_info_uint32(TAG, "setupUART() with baudrate ", this->parent_->get_baud_rate());
     ESP_LOGI(LOG_CONN_TAG, "setupUART(): baud=%d tx=%d rx=%d (UART port=%d)", this->parent_->get_baud_rate(), this->tx_pin_, this->rx_pin_, this->uart_port_);
     this->setHeatpumpConnected(false);
@@ -278,6 +283,13 @@ void CN105Climate::setupUART() {
         ESP_LOGI(LOG_CONN_TAG, "UART configuré en SERIAL_8E1");
         this->isUARTConnected_ = true;
         this->initBytePointer();
+        if (this->use_uart_rx_task_) {
+            if (this->rx_task_.is_running()) {
+                this->rx_task_.request_resync();
+            } else {
+                this->rx_task_.start(this->parent_);
+            }
+        }
     } else {
         ESP_LOGW(LOG_CONN_TAG, "UART n'est pas configuré en SERIAL_8E1");
     }
@@ -310,6 +322,7 @@ void CN105Climate::disconnectUART() {
 void CN105Climate::reconnectUART() {
     ESP_LOGD(TAG, "reconnectUART()");
     this->lastReconnectTimeMs = CUSTOM_MILLIS;
+    this->link_stats_.onReconnect();
     this->disconnectUART();
     // Désactivé: le fallback UART bas-niveau (ESP-IDF 5.4.x) peut interférer avec les
     // tests de handshake/fallback. On laisse UARTComponent gérer la réinit standard.
@@ -320,35 +333,169 @@ void CN105Climate::reconnectUART() {
 
 
 void CN105Climate::reconnectIfConnectionLost() {
+    // la détection et le rythme des reconnexions (backoff) sont gérés par le LinkMonitor
+    this->checkLinkLiveness();
+}
 
-    long reconnectTimeMs = CUSTOM_MILLIS - this->lastReconnectTimeMs;
 
-    if (reconnectTimeMs < this->update_interval_) {
-        return;
+bool CN105Climate::isHeatpumpConnectionActive() {
+    // vivant tant que le LinkMonitor n'a pas compté LINK_MISSES_BEFORE_LOST battements manqués d'affilée
+    return !this->link_.is_lost();
+}
+
+void CN105Climate::checkLinkLiveness() {
+    const uint32_t now = CUSTOM_MILLIS;
+    switch (this->link_.poll(now)) {
+    case LinkMonitor::Event::MISSED: {
+        ESP_LOGW(LOG_CONN_TAG, "No response for %u ms (%u missed in a row)", (unsigned)LINK_RESPONSE_TIMEOUT_MS,
+            (unsigned)this->link_.get_missed());
+        // battement suivant tout de suite: on renvoie la requête du cycle restée sans réponse
+        const int code = this->scheduler_.awaiting_code();
+        if (this->isHeatpumpConnected_ && this->loopCycle.isCycleRunning() && code >= 0) {
+            this->buildAndSendInfoPacket((uint8_t)code);
+        }
+        break;
+    }
+    case LinkMonitor::Event::LOST:
+        ESP_LOGW(LOG_CONN_TAG, "Heatpump link lost: detected %u ms after the last response, reconnecting",
+            (unsigned)this->link_.get_last_detection_ms());
+        if (this->link_loss_detection_sensor_ != nullptr) {
+            this->link_loss_detection_sensor_->publish_state(this->link_.get_last_detection_ms());
+        }
+        if (this->loopCycle.isCycleRunning()) {
+            this->loopCycle.cycleEnded(true);
+        }
+        break;      // la première tentative (RETRY) part au passage suivant
+    case LinkMonitor::Event::RETRY:
+        ESP_LOGI(LOG_CONN_TAG, "Reconnect attempt %u", (unsigned)this->link_.get_attempts());
+        if (!this->isHeatpumpConnected_) {
+            this->fallbackToStandardHandshake();
+        }
+        this->reconnectUART();
+        break;
+    case LinkMonitor::Event::RECOVERED:
+        ESP_LOGI(LOG_CONN_TAG, "Heatpump link back %u ms after the loss was detected (%u attempts, %u losses since boot)",
+            (unsigned)this->link_.get_last_reconnect_ms(), (unsigned)this->link_.get_attempts(), (unsigned)this->link_.get_losses());
+        if (this->link_reconnect_sensor_ != nullptr) {
+            this->link_reconnect_sensor_->publish_state(this->link_.get_last_reconnect_ms());
+        }
+        break;
+    case LinkMonitor::Event::NONE:
+        break;
     }
+}
+
+void CN105Climate::fallbackToStandardHandshake() {
+    // Fallback automatique: si le mode installateur est demandé mais que la PAC ignore 0x5B,
+    // on retente une fois en mode standard (0x5A) pour préserver la connectivité.
+    if (this->installer_mode_ && this->installer_mode_effective_ && !this->installer_mode_fallback_done_) {
+        this->installer_mode_effective_ = false;
+        this->installer_mode_fallback_done_ = true;
+        this->installer_probe_missed_ = true;
+        ESP_LOGW(LOG_CONN_TAG, "No reply to installer handshake (0x5B). Falling back to standard handshake (0x5A).");
+    }
+}
 
-    if (!this->isHeatpumpConnectionActive()) {
-        long connectTimeMs = CUSTOM_MILLIS - this->lastConnectRqTimeMs;
-        if (connectTimeMs > this->update_interval_) {
-            long lrTimeMs = CUSTOM_MILLIS - this->lastResponseMs;
-            ESP_LOGW(TAG, "Heatpump has not replied for %ld s", lrTimeMs / 1000);
-            ESP_LOGI(TAG, "We think Heatpump is not connected anymore..");
-            this->reconnectUART();
+void CN105Climate::setupHandshakeCache() {
+    this->handshake_pref_ = global_preferences->make_preference<handshakeCache>(
+        this->get_object_id_hash() ^ HANDSHAKE_PREF_HASH_SALT, true);
+    handshakeCache saved{};
+    if (!this->baud_rates_.empty()) {
+        this->link_baud_ = this->baud_rates_[0];
+    }
+    if (!this->handshake_pref_.load(&saved) || saved.version != HANDSHAKE_VERSION) {
+        return;
+    }
+    for (uint32_t baud : this->baud_rates_) {
+        if (baud == saved.baud) {
+            this->link_baud_ = baud;
         }
     }
+    this->handshake_cache_ = saved;
+    ESP_LOGI(LOG_CONN_TAG, "Handshake cache: 0x%02X accepted at %u baud, reply in %u ms (probe timeout %u ms)",
+        saved.command, (unsigned)saved.baud, saved.latencyMs, (unsigned)this->handshakeProbeTimeoutMs());
+    // cette unité a déjà ignoré 0x5B: pas de nouvelle sonde, on part directement en standard
+    if (this->installer_mode_ && saved.command == 0x5A) {
+        this->installer_mode_effective_ = false;
+        this->installer_mode_fallback_done_ = true;
+    }
 }
 
+void CN105Climate::selectNextBaudRate() {
+    size_t i = 0;
+    while (i < this->baud_rates_.size() && this->baud_rates_[i] != this->link_baud_) {
+        i++;
+    }
+    this->link_baud_ = this->baud_rates_[(i + 1) % this->baud_rates_.size()];
+    // appliqué par force_low_level_uart_reinit() au reconnectUART() qui suit
+    this->parent_->set_baud_rate(this->link_baud_);
+    // la sonde 0x5B n'a de sens qu'au bon débit: on la refait à chaque débit
+    if (this->installer_mode_ && this->handshake_cache_.command != 0x5A) {
+        this->installer_mode_effective_ = true;
+        this->installer_mode_fallback_done_ = false;
+    }
+    ESP_LOGI(LOG_CONN_TAG, "No reply to CONNECT, trying %u baud", (unsigned)this->link_baud_);
+}
 
-bool CN105Climate::isHeatpumpConnectionActive() {
-    long lrTimeMs = CUSTOM_MILLIS - this->lastResponseMs;
+uint32_t CN105Climate::handshakeProbeTimeoutMs() const {
+    if (this->handshake_cache_.latencyMs == 0) {
+        return HANDSHAKE_PROBE_DEFAULT_MS;
+    }
+    const uint32_t timeout = (uint32_t)this->handshake_cache_.latencyMs * HANDSHAKE_PROBE_LATENCY_FACTOR;
+    return (timeout < HANDSHAKE_PROBE_MIN_MS) ? HANDSHAKE_PROBE_MIN_MS :
+        (timeout > HANDSHAKE_PROBE_MAX_MS) ? HANDSHAKE_PROBE_MAX_MS : timeout;
+}
 
-    // if (lrTimeMs > MAX_DELAY_RESPONSE_FACTOR * this->update_interval_) {
-    //     ESP_LOGV(TAG, "Heatpump has not replied for %ld s", lrTimeMs / 1000);
-    //     ESP_LOGV(TAG, "We think Heatpump is not connected anymore..");
-    //     this->disconnectUART();
-    // }
+void CN105Climate::handshakeSucceeded(uint8_t replyCommand) {
+    this->cancel_timeout("handshakeProbe");
+    // 0x7A répond à 0x5A, 0x7B à 0x5B: une réponse à un CONNECT précédent ne mesure rien
+    if (replyCommand != this->handshake_sent_command_ + 0x20) {
+        return;
+    }
+    handshakeCache updated = this->handshake_cache_;
+    updated.version = HANDSHAKE_VERSION;
+    const uint32_t latency = CUSTOM_MILLIS - this->handshake_sent_ms_;
+    updated.latencyMs = (uint16_t)((updated.latencyMs == 0) ? latency : (3u * updated.latencyMs + latency) / 4);
+    // la variante n'apprend quelque chose que si le mode installateur est demandé
+    if (this->installer_mode_ && this->handshake_sent_command_ == 0x5B) {
+        updated.command = 0x5B;
+        updated.installerMisses = 0;
+    } else if (this->installer_mode_ && this->installer_probe_missed_ && updated.command != 0x5A) {
+        // 0x5B vient d'être ignoré mais l'unité répond: on ne fige 0x5A qu'après plusieurs échecs
+        if (updated.installerMisses < HANDSHAKE_INSTALLER_MISSES) {
+            updated.installerMisses++;
+        }
+        if (updated.installerMisses >= HANDSHAKE_INSTALLER_MISSES) {
+            updated.command = 0x5A;
+            ESP_LOGI(LOG_CONN_TAG, "Installer handshake (0x5B) ignored %u times in a row, using 0x5A from now on",
+                (unsigned)updated.installerMisses);
+        } else {
+            ESP_LOGI(LOG_CONN_TAG, "Installer handshake (0x5B) ignored (%u/%u), probing it again on next connection",
+                (unsigned)updated.installerMisses, (unsigned)HANDSHAKE_INSTALLER_MISSES);
+        }
+    }
+    if (!this->baud_rates_.empty()) {
+        updated.baud = this->parent_->get_baud_rate();
+    }
+    if (!this->link_baud_locked_) {
+        // débit utile en 8E1: 11 bits par octet sur le fil
+        const uint32_t baud = this->parent_->get_baud_rate();
+        ESP_LOGI(LOG_CONN_TAG, "Link up at %u baud: %u bytes/s, %u ms per %d-byte frame, CONNECT answered in %u ms",
+            (unsigned)baud, (unsigned)(baud / 11), (unsigned)(PACKET_LEN * 11 * 1000 / baud), PACKET_LEN, (unsigned)latency);
+        this->link_baud_locked_ = true;
+    }
 
-    return  (lrTimeMs < MAX_DELAY_RESPONSE_FACTOR * this->update_interval_);
+    // écriture flash seulement si la variante change ou si la latence a bougé de plus d'un quart
+    this->installer_probe_missed_ = false;     // un échec de sonde ne compte qu'une fois
+    const uint16_t previous = this->handshake_cache_.latencyMs;
+    const bool changed = updated.version != this->handshake_cache_.version || updated.command != this->handshake_cache_.command ||
+        updated.baud != this->handshake_cache_.baud || updated.installerMisses != this->handshake_cache_.installerMisses ||
+        updated.latencyMs > previous + previous / 4 || updated.latencyMs + previous / 4 < previous;
+    this->handshake_cache_ = updated;
+    ESP_LOGD(LOG_CONN_TAG, "Handshake 0x%02X answered in %u ms", this->handshake_sent_command_, (unsigned)latency);
+    if (changed) {
+        this->handshake_pref_.save(&this->handshake_cache_);
+    }
 }
 
 void CN105Climate::force_low_level_uart_reinit() {
@@ -424,6 +571,8 @@ void CN105Climate::force_low_level_uart_reinit() {
     uart_get_baudrate(port, &eff_baud);
     ESP_LOGD(TAG, "UART effective baud=%lu tx_pin=%d rx_pin=%d", (unsigned long)eff_baud, this->tx_pin_, this->rx_pin_);
 #else
-    // Pas d’ESP32: rien à faire
+    // ESP8266: pas de reconfiguration basse couche, mais le débit choisi (baud_rates) doit être appliqué
+    // par le composant UART lui-même (sinon set_baud_rate() ne change que la valeur mémorisée)
+    this->parent_->load_settings(false);
 #endif
 }
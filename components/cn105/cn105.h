@@ -1,16 +1,21 @@
 #pragma once
 #include "Globals.h"
 #include "esphome/components/uart/uart.h"
+#include "esphome/core/preferences.h"
 #include "heatpumpFunctions.h"
 #include "van_orientation_select.h"
 #include "uptime_connection_sensor.h"
 #include "compressor_frequency_sensor.h"
 #include "input_power_sensor.h"
 #include "kwh_sensor.h"
+#include "total_energy_sensor.h"
+#include "energy_integrator.h"
+#include "telemetry_history.h"
 #include "runtime_hours_sensor.h"
 #include "outside_air_temperature_sensor.h"
 #include "auto_sub_mode_sensor.h"
 #include "isee_sensor.h"
+#include "restored_state_sensor.h"
 #include "stage_sensor.h"
 #include "functions_sensor.h"
 #include "functions_number.h"
@@ -21,6 +26,11 @@
 #include "localization.h"
 #include "info_request.h"
 #include "request_scheduler.h"
+#include "uart_rx_task.h"
+#include "seqlock_slot.h"
+#include "link_monitor.h"
+#include "loop_profiler.h"
+#include "link_stats.h"
 #include <esphome/components/sensor/sensor.h>
 #include <esphome/components/button/button.h>
 #include <esphome/components/binary_sensor/binary_sensor.h>
@@ -48,12 +58,16 @@ namespace esphome {
         void set_vertical_vane_select(VaneOrientationSelect* vertical_vane_select);
         void set_horizontal_vane_select(VaneOrientationSelect* horizontal_vane_select, const std::vector<std::string>& options = {});
         void set_airflow_control_select(VaneOrientationSelect* airflow_control_select);
-        void set_compressor_frequency_sensor(esphome::sensor::Sensor* compressor_frequency_sensor);
-        void set_input_power_sensor(esphome::sensor::Sensor* input_power_sensor);
-        void set_kwh_sensor(esphome::sensor::Sensor* kwh_sensor);
-        void set_runtime_hours_sensor(esphome::sensor::Sensor* runtime_hours_sensor);
-        void set_outside_air_temperature_sensor(esphome::sensor::Sensor* outside_air_temperature_sensor);
+        void set_compressor_frequency_sensor(ThrottledSensor* compressor_frequency_sensor);
+        void set_input_power_sensor(ThrottledSensor* input_power_sensor);
+        void set_kwh_sensor(ThrottledSensor* kwh_sensor);
+        void set_total_energy_sensor(ThrottledSensor* total_energy_sensor);
+        void set_runtime_hours_sensor(ThrottledSensor* runtime_hours_sensor);
+        void set_outside_air_temperature_sensor(ThrottledSensor* outside_air_temperature_sensor);
         void set_isee_sensor(esphome::binary_sensor::BinarySensor* iSee_sensor);
+        void set_link_loss_detection_sensor(sensor::Sensor* sensor) { this->link_loss_detection_sensor_ = sensor; }
+        void set_link_reconnect_sensor(sensor::Sensor* sensor) { this->link_reconnect_sensor_ = sensor; }
+        void set_restored_state_sensor(esphome::binary_sensor::BinarySensor* restored_state_sensor) { this->restored_state_sensor_ = restored_state_sensor; }
         void set_stage_sensor(esphome::text_sensor::TextSensor* Stage_sensor);
         void set_use_stage_for_operating_status(bool value);
         void set_use_fahrenheit_support_mode(FahrenheitMode mode);
@@ -63,6 +77,12 @@ namespace esphome {
 
         void add_hardware_setting(HardwareSettingSelect* setting);
         void set_hardware_settings_interval(uint32_t interval_ms) { this->hardware_settings_interval_ms_ = interval_ms; }
+        void set_hardware_settings_result_sensor(esphome::text_sensor::TextSensor* sensor) { this->hardware_settings_result_sensor_ = sensor; }
+        // Transaction d'écriture des fonctions: stageFunction() groupe les changements, commitFunctions() les envoie
+        // sans attendre la fin du debounce. Résultat (codes acceptés/refusés) dans hardware_settings_result_sensor_.
+        bool stageFunction(int code, int value);
+        void commitFunctions();
+        void set_telemetry_history(uint32_t size_bytes, uint16_t port) { this->telemetry_history_.configure(size_bytes, port); }
 
         void set_functions_sensor(esphome::text_sensor::TextSensor* Functions_sensor);
         void set_functions_get_button(FunctionsButton* Button);
@@ -76,6 +96,7 @@ namespace esphome {
 
         //sensor::Sensor* compressor_frequency_sensor;
         binary_sensor::BinarySensor* iSee_sensor_ = nullptr;
+        binary_sensor::BinarySensor* restored_state_sensor_ = nullptr;
         text_sensor::TextSensor* stage_sensor_{ nullptr }; // to save ref if needed
         bool use_stage_for_operating_status_{ false };
         FahrenheitSupport fahrenheitSupport_;
@@ -91,6 +112,7 @@ namespace esphome {
         HVACOptionSwitch* circulator_switch_ = nullptr;
         std::vector<HardwareSettingSelect*> hardware_settings_;
         uint32_t hardware_settings_interval_ms_{ 86400000 };  // Default 24h
+        text_sensor::TextSensor* hardware_settings_result_sensor_ = nullptr;
 
         // The value of the code and value for the functions set.
         int functions_code_;
@@ -106,15 +128,17 @@ namespace esphome {
         std::vector<std::string> horizontal_vane_options_strings_;  // Store strings for horizontal vane options
         VaneOrientationSelect* airflow_control_select_ =
             nullptr;
-        sensor::Sensor* compressor_frequency_sensor_ =
+        ThrottledSensor* compressor_frequency_sensor_ =
             nullptr;  // Sensor to store compressor frequency
-        sensor::Sensor* input_power_sensor_ =
+        ThrottledSensor* input_power_sensor_ =
             nullptr;  // Sensor to store compressor frequency
-        sensor::Sensor* kwh_sensor_ =
+        ThrottledSensor* kwh_sensor_ =
             nullptr;  // Sensor to store compressor frequency
-        sensor::Sensor* runtime_hours_sensor_ =
+        ThrottledSensor* total_energy_sensor_ =
+            nullptr;  // Persisted energy total, independent of the 16-bit kWh counter
+        ThrottledSensor* runtime_hours_sensor_ =
             nullptr;  // Sensor to store compressor frequency
-        sensor::Sensor* outside_air_temperature_sensor_ =
+        ThrottledSensor* outside_air_temperature_sensor_ =
             nullptr;  // Outside air temperature
 
         // sensor to monitor heatpump connection time
@@ -146,6 +170,8 @@ namespace esphome {
 
         void setup() override;
         void loop() override;
+        void on_shutdown() override;
+        void dump_config() override;
 
         void set_baud_rate(int baud_rate);
         void set_tx_rx_pins(int tx_pin, int rx_pin);
@@ -159,6 +185,16 @@ namespace esphome {
         void buildAndSendInfoPacket(uint8_t code);
         bool isHeatpumpConnectionActive();
         void reconnectIfConnectionLost();
+        // battements manqués, perte du lien et reconnexion avec backoff (LinkMonitor)
+        void checkLinkLiveness();
+        void fallbackToStandardHandshake();
+        // cache du handshake par unité (variante acceptée, latence mesurée)
+        void setupHandshakeCache();
+        void handshakeSucceeded(uint8_t replyCommand);
+        uint32_t handshakeProbeTimeoutMs() const;
+        // détection du débit (baud_rates)
+        void selectNextBaudRate();
+        bool isBaudProbing() const { return this->baud_rates_.size() > 1 && !this->link_baud_locked_; }
 
         void sendWantedSettings();
         void sendWantedSettingsDelegate();
@@ -215,6 +251,37 @@ namespace esphome {
             this->installer_mode_fallback_done_ = false;
         }
 
+        // Warm start: republie au boot le dernier état confirmé (flash) et lance le handshake sans attendre le WiFi
+        void set_warm_start(bool enabled) { this->warm_start_ = enabled; }
+        void set_loop_profiler(uint32_t report_interval_ms) { this->loop_profile_interval_ms_ = report_interval_ms; }
+        void set_loop_max_sensor(sensor::Sensor* sensor) { this->loop_max_sensor_ = sensor; }
+        void set_loop_p99_sensor(sensor::Sensor* sensor) { this->loop_p99_sensor_ = sensor; }
+        void set_loop_allocs_sensor(sensor::Sensor* sensor) { this->loop_allocs_sensor_ = sensor; }
+        // Statistiques du lien: octets/trames par code, erreurs, occupation; rapport périodique (log + capteurs + /stats.bin)
+        void set_link_stats(uint32_t report_interval_ms) { this->link_stats_interval_ms_ = report_interval_ms; }
+        void set_link_busy_sensor(sensor::Sensor* sensor) { this->link_busy_sensor_ = sensor; }
+        void set_link_errors_sensor(sensor::Sensor* sensor) { this->link_errors_sensor_ = sensor; }
+        void set_link_tx_bytes_sensor(sensor::Sensor* sensor) { this->link_tx_bytes_sensor_ = sensor; }
+        void set_link_rx_bytes_sensor(sensor::Sensor* sensor) { this->link_rx_bytes_sensor_ = sensor; }
+        /// blob binaire des statistiques du lien (format: link_stats.h), 0 si out est trop petit
+        size_t get_link_stats_blob(uint8_t* out, size_t max);
+        // Débits essayés au CONNECT, dans l'ordre, en commençant par le dernier qui a répondu
+        void add_baud_rate(uint32_t baud) { this->baud_rates_.push_back(baud); }
+
+        // Lecture UART dans une tâche dédiée: les trames validées sont remises au loop via une file SPSC
+        void set_uart_rx_task(bool enabled) { this->use_uart_rx_task_ = enabled; }
+        // Loop événementiel: le loop est désactivé entre deux échéances (cycle, timeout, données UART)
+        void set_event_driven_loop(bool enabled) { this->event_driven_loop_ = enabled; }
+        // Réveille le loop s'il dort (à appeler depuis le contexte loop/callbacks ESPHome)
+        void wakeLoop();
+        // Mode proxy de l'émulateur: les trames SET de la télécommande filaire partent telles quelles vers la PAC
+        void set_emulator_proxy_mode(bool enabled) { this->emulator_proxy_mode_ = enabled; }
+        bool is_emulator_proxy_mode() const { return this->emulator_proxy_mode_; }
+        // Place une trame SET (0x41) dans le prochain créneau libre du bus CN105
+        bool proxySetPacket(const uint8_t* packet, int length);
+        /// table des requêtes INFO (lecture seule: empreinte mémoire, harness host)
+        const RequestScheduler& get_request_scheduler() const { return this->scheduler_; }
+
         // Configure the climate object with traits that we support.
 
 
@@ -239,7 +306,19 @@ namespace esphome {
         void getFunctions();
         void getFunctionsPart2();
         void functionsArrived();
-        bool setFunctions(heatpumpFunctions const& functions);
+        // bloc de fonctions persisté avec son hash (heatpumpFunctions.cpp)
+        void setupFunctionsCache();
+        void saveFunctionsCache();
+        // transaction d'écriture (heatpumpFunctions.cpp)
+        void startFunctionsTransaction();
+        void functionsTransactionAck();
+        bool functionsTransactionResponse(uint8_t code);
+        void finishFunctionsTransaction(const char* failure);
+        void sendFunctionsPart(const heatpumpFunctions& block, uint8_t setCode);
+        heatpumpFunctionsTransaction functions_tx_;
+        // dernière trame écrite (commande, code): un 0x61 n'acquitte que celle-là
+        uint8_t last_write_command_ = 0;
+        uint8_t last_write_code_ = 0;
 
         // helpers
         const char* getIfNotNull(const char* what, const char* defaultValue);
@@ -271,6 +350,7 @@ namespace esphome {
         }
 
         bool processInput(void);
+        bool processQueuedFrames();
         void parse(uint8_t inputData);
         void checkHeader(uint8_t inputData);
         void initBytePointer();
@@ -288,13 +368,13 @@ namespace esphome {
         bool checkSum();
         uint8_t checkSum(uint8_t bytes[], int len);
 
-        const char* getModeSetting();
-        const char* getPowerSetting();
-        const char* getVaneSetting();
-        const char* getWideVaneSetting();
+        const char* getModeSetting(const wantedHeatpumpSettings& wanted);
+        const char* getPowerSetting(const wantedHeatpumpSettings& wanted);
+        const char* getVaneSetting(const wantedHeatpumpSettings& wanted);
+        const char* getWideVaneSetting(wantedHeatpumpSettings& wanted);
         const char* getAirflowControlSetting();
-        const char* getFanSpeedSetting();
-        float getTemperatureSetting();
+        const char* getFanSpeedSetting(const wantedHeatpumpSettings& wanted);
+        float getTemperatureSetting(const wantedHeatpumpSettings& wanted);
         bool getAirPurifierRunState();
         bool getNightModeRunState();
         bool getCirculatorRunState();
@@ -320,7 +400,7 @@ namespace esphome {
         void prepareInfoPacket(uint8_t* packet, int length);
         void prepareSetPacket(uint8_t* packet, int length);
 
-        void publishWantedSettingsStateToHA();
+        void publishWantedSettingsStateToHA(wantedHeatpumpSettings& settings);
         void publishWantedRunStatesStateToHA();
 
         void publishStateToHA(heatpumpSettings& settings);
@@ -349,11 +429,6 @@ namespace esphome {
         void debugSettingsAndStatus(const char* settingName, heatpumpSettings settings, heatpumpStatus status);
         void debugClimate(const char* settingName);
 
-#ifndef USE_ESP32
-        void emulateMutex(const char* retryName, std::function<void()>&& f);
-#endif
-
-
 
         void controlDelegate(const esphome::climate::ClimateCall& call);
         // Refactor helpers for controlDelegate
@@ -368,18 +443,52 @@ namespace esphome {
         void handleDualSetpointHighOnly(float high);
         void handleSingleTargetInAutoOrDry(float requested);
 
-        void createPacket(uint8_t* packet);
+        void createPacket(uint8_t* packet, wantedHeatpumpSettings& wanted);
         void createInfoPacket(uint8_t* packet, uint8_t code);
 
     public:
         // KIRBY: Made public for HPEmulator access
         heatpumpSettings currentSettings{};
+        // lecture seule pour l'émulateur (réponses 0x03/0x06/0x42 à la télécommande)
+        const heatpumpStatus& getCurrentStatus() const { return this->currentStatus; }
+        const heatpumpRunStates& getCurrentRunStates() const { return this->currentRunStates; }
+        // Listeners appelés depuis le loop avec le delta de chaque changement décodé (settings, status, run states)
+        void add_on_state_change_callback(std::function<void(const heatpumpStateDelta&)>&& callback) {
+            this->state_change_callback_.add(std::move(callback));
+        }
+        // brouillon des producteurs (control(), selects, émulateur), rendu visible au TX par commitWantedSettings()
         wantedHeatpumpSettings wantedSettings{};
+        void commitWantedSettings();
+        void publishWantedSettings(const wantedHeatpumpSettings& settings);
+        // dernier instantané publié: hasChanged/hasBeenSent se lisent ici, pas dans le brouillon
+        wantedHeatpumpSettings getCommittedWantedSettings() const {
+            wantedHeatpumpSettings committed;
+            this->wantedSettingsSlot_.read(committed);
+            return committed;
+        }
         void debugSettings(const char* settingName, heatpumpSettings& settings);
         void debugSettings(const char* settingName, wantedHeatpumpSettings& settings);
 
     private:
         void heatpumpUpdate(heatpumpSettings& settings);
+        void notifyStateChange(uint16_t changed);
+        // publie l'entité climate si marquée dans publish_dirty_, et les capteurs selon leur politique (fin de cycle)
+        void flushPendingPublish();
+        uint8_t publish_dirty_{ 0 };
+
+        // total_energy_sensor: intégrateur persisté en flash
+        void setupEnergyIntegrator();
+        void updateEnergyIntegrator(float inputPowerW, uint16_t counterRaw);
+        void saveEnergyIntegrator(bool force);
+        EnergyIntegrator energy_integrator_;
+        ESPPreferenceObject energy_pref_;
+
+        // historique compressé, un échantillon par cycle (fin de cycle)
+        void recordTelemetrySample();
+        TelemetryHistory telemetry_history_;
+        double energy_saved_kwh_{ 0 };
+        uint32_t energy_saved_ms_{ 0 };
+        CallbackManager<void(const heatpumpStateDelta&)> state_change_callback_;
         heatpumpRunStates currentRunStates{};
         wantedHeatpumpRunStates wantedRunStates{};
         cycleManagement loopCycle{};
@@ -389,11 +498,8 @@ namespace esphome {
         void registerInfoRequests();
         void registerHardwareSettingsRequests();
 
-#ifdef USE_ESP32
-        std::mutex wantedSettingsMutex;
-#else
-        volatile bool wantedSettingsMutex = false;
-#endif
+        // dernier instantané complet de wantedSettings, consommé par sendWantedSettingsDelegate()
+        SeqlockSlot<wantedHeatpumpSettings> wantedSettingsSlot_;
 
         unsigned long lastResponseMs;
 
@@ -418,6 +524,10 @@ namespace esphome {
         // initialise to all off, then it will update shortly after connect;
         heatpumpStatus currentStatus{ 0, 0, false, {TIMER_MODE_MAP[0], 0, 0, 0, 0}, 0, 0, 0, 0 };
         heatpumpFunctions functions;
+        heatpumpFunctions functions_published_;     // dernier bloc publié (selects, text sensor)
+        bool functions_published_valid_{ false };
+        uint32_t functions_saved_hash_{ 0 };
+        ESPPreferenceObject functions_pref_;
 
         bool tempMode = false;
         bool wideVaneAdj;
@@ -430,6 +540,10 @@ namespace esphome {
         // is the counter > MAX_NON_RESPONSE_REQ then we conclude uart is not connected anymore
         int nonResponseCounter = 0;
 
+        LinkMonitor link_;
+        sensor::Sensor* link_loss_detection_sensor_ = nullptr;
+        sensor::Sensor* link_reconnect_sensor_ = nullptr;
+
         int powerRequestWithoutResponses = 0;
 
         bool isReading = false;
@@ -462,9 +576,76 @@ namespace esphome {
         bool conn_timeout_armed_ = false;
         uint32_t conn_bootstrap_delay_ms_{ 10000 };  // par défaut 10s
 
+        // Warm start (warm_start.cpp)
+        void setupWarmStart();
+        void applyWarmStart(const warmStartSnapshot& snapshot);
+        void buildWarmStart(warmStartSnapshot& snapshot);
+        void saveWarmStart(bool force);
+        void confirmWarmStart();
+        bool warm_start_{ false };
+        bool warm_start_restored_{ false };         // état affiché = snapshot, pas encore confirmé par la PAC
+        ESPPreferenceObject warm_start_pref_;
+        warmStartSnapshot warm_start_saved_{};
+        uint32_t warm_start_saved_ms_{ 0 };
+
         bool installer_mode_{ false };
         bool installer_mode_effective_{ false };
         bool installer_mode_fallback_done_{ false };
+        bool installer_probe_missed_{ false };  // 0x5B ignoré à cette connexion, compté au prochain succès 0x5A
+        ESPPreferenceObject handshake_pref_;
+        handshakeCache handshake_cache_{};
+        uint8_t handshake_sent_command_{ 0 };
+        uint32_t handshake_sent_ms_{ 0 };
+        std::vector<uint32_t> baud_rates_;
+        uint32_t link_baud_{ 0 };               // débit courant du lien, 0 = celui de la config UART
+        bool link_baud_locked_{ false };        // la PAC a répondu à ce débit depuis le boot
         bool supports_dual_setpoint_ = false;
+
+        // Mode tâche de lecture UART (uart_rx_task)
+        bool use_uart_rx_task_{ false };
+        UartRxTask rx_task_;
+        uint32_t rx_task_overflows_ = 0;
+        uint32_t rx_task_dropped_frames_ = 0;
+
+        // Loop événementiel (event_driven_loop) et mesure du temps CPU passé dans loop()
+        void runLoopOnce();
+        void scheduleIdleSleep();
+        bool event_driven_loop_{ false };
+        bool loop_sleeping_ = false;
+        uint64_t loop_cpu_us_ = 0;     // µs cumulées sur LOOP_CPU_REPORT_INTERVAL_MS: 32 bits débordent en ~71 min de CPU
+        uint32_t loop_passes_ = 0;
+        // loop_profiler: temps par phase du loop, rapport périodique (log + capteurs)
+        void reportLoopProfile();
+        LoopProfiler profiler_;
+        uint32_t loop_profile_interval_ms_{ 0 };
+        sensor::Sensor* loop_max_sensor_{ nullptr };
+        sensor::Sensor* loop_p99_sensor_{ nullptr };
+        // allocations en régime établi (CN105_ALLOC_TRACKING): fenêtre entière connectée, sans reconnexion
+        sensor::Sensor* loop_allocs_sensor_{ nullptr };
+        bool profile_window_connected_{ false };
+        uint32_t profile_window_reconnects_{ 0 };
+        // link_stats: comptabilité du lien, mise à jour à chaque trame écrite ou lue
+        void reportLinkStats();
+        LinkStats link_stats_;
+        uint32_t link_stats_interval_ms_{ 0 };
+        sensor::Sensor* link_busy_sensor_{ nullptr };
+        sensor::Sensor* link_errors_sensor_{ nullptr };
+        sensor::Sensor* link_tx_bytes_sensor_{ nullptr };
+        sensor::Sensor* link_rx_bytes_sensor_{ nullptr };
+
+        // Mode proxy de l'émulateur (emulator_proxy_mode): une seule trame en attente, la plus récente gagne
+        void flushProxyPacket();
+        void resumeAfterProxy();
+        // réglages écrits en attente de leur ACK 0x61: publiés vers HA seulement une fois acquittés
+        void settingsWriteAck();
+        wantedHeatpumpSettings settings_ack_pending_{};
+        bool settings_ack_waiting_ = false;
+        bool emulator_proxy_mode_{ false };
+        uint8_t proxy_packet_[PACKET_LEN] = {};
+        int proxy_packet_len_ = 0;
+        bool proxy_packet_pending_ = false;
+        // code INFO dont la réponse a cédé son créneau à la trame proxy: le cycle reprend à l'ACK 0x61
+        uint8_t proxy_resume_code_ = 0;
+        bool proxy_resume_pending_ = false;
     };
 }
@@ -4,8 +4,13 @@
 #include <cstring>
 #include <string>
 
-#define MAX_DATA_BYTES     64         
-#define MAX_DELAY_RESPONSE_FACTOR 10  
+// Buffers de trame: 64 octets par défaut (marge), ou la trame CN105 maximale avec compact_buffers:
+// 5 (header) + 16 (data) + 1 (checksum) = 22
+#ifdef CN105_COMPACT_BUFFERS
+#define MAX_DATA_BYTES     22
+#else
+#define MAX_DATA_BYTES     64
+#endif
 
 static const char* LOG_ACTION_EVT_TAG = "EVT_SETS";
 static const char* TAG = "CN105"; 
@@ -26,8 +31,63 @@ static const char* LOG_CONN_TAG = "CN105_CONN";
 static const char* SHEDULER_REMOTE_TEMP_TIMEOUT = "->remote_temp_timeout";
 
 static const int DEFER_SCHEDULE_UPDATE_LOOP_DELAY = 750;
+// event_driven_loop: en dessous de ce délai on ne désactive pas le loop (le loop ESPHome tourne déjà toutes les ~16ms)
+static const uint32_t EVENT_LOOP_MIN_SLEEP_MS = 50;
+static const uint32_t LOOP_CPU_REPORT_INTERVAL_MS = 3600000;
 static const uint32_t RECEIVED_SETPOINT_GRACE_WINDOW_MS = 3000;
 static const uint32_t UI_SETPOINT_ANTIREBOUND_MS = 600;
+// Lien CN105 (LinkMonitor): une réponse arrive en ~100-300 ms (22 octets à 2400 bauds = 92 ms)
+static const uint32_t LINK_RESPONSE_TIMEOUT_MS = 1000;
+static const uint8_t LINK_MISSES_BEFORE_LOST = 3;
+static const uint32_t LINK_RETRY_MIN_MS = 500;
+static const uint32_t LINK_RETRY_MAX_MS = 15000;
+// emulator_proxy_mode: sans ACK 0x61 de la trame relayée dans ce délai, le cycle reprend quand même
+static const uint32_t PROXY_RESUME_TIMEOUT_MS = 500;
+// écriture des réglages (0x41/0x01): sans ACK 0x61 dans ce délai, l'état demandé n'est pas publié
+static const uint32_t SETTINGS_ACK_TIMEOUT_MS = 1000;
+// Handshake: variante de CONNECT acceptée par l'unité (0x5A/0x5B) et latence de sa réponse, mémorisées en flash.
+// Le timeout de sonde 0x5B vaut HANDSHAKE_PROBE_LATENCY_FACTOR x la latence mesurée, borné; une unité qui
+// ignore 0x5B est ainsi basculée en 0x5A en moins d'une seconde au lieu de 10 s.
+// Avec baud_rates, le même délai sert à passer au débit suivant; le débit qui a répondu est mémorisé aussi.
+static const uint32_t HANDSHAKE_PREF_HASH_SALT = 0x48534B45;  // "HSKE"
+static const uint8_t HANDSHAKE_VERSION = 3;
+// 0x5A n'est mémorisé qu'après ce nombre de sondes 0x5B sans réponse (suivies d'un 0x5A qui, lui, répond):
+// une réponse 0x5B perdue une fois ne coupe pas le mode installateur pour toujours
+static const uint8_t HANDSHAKE_INSTALLER_MISSES = 3;
+static const uint32_t HANDSHAKE_PROBE_DEFAULT_MS = 800;       // aucune latence mesurée encore
+static const uint32_t HANDSHAKE_PROBE_MIN_MS = 250;
+static const uint32_t HANDSHAKE_PROBE_MAX_MS = 1000;
+static const uint8_t HANDSHAKE_PROBE_LATENCY_FACTOR = 4;
+
+struct handshakeCache {
+    uint8_t version;
+    uint8_t command;        // CONNECT accepté: 0x5A (standard) ou 0x5B (installateur), 0 = inconnu
+    uint16_t latencyMs;     // CONNECT -> 0x7A/0x7B, moyenne glissante
+    uint32_t baud;          // débit qui a répondu (baud_rates), 0 = inconnu
+    uint8_t installerMisses; // sondes 0x5B consécutives restées sans réponse alors que 0x5A répondait
+};
+// total_energy_sensor: écritures flash groupées (au plus une toutes les 10 min, et seulement si l'énergie a
+// avancé d'au moins 0.5 kWh; sinon une par heure s'il y a du nouveau). Le compteur matériel persisté
+// rattrape de toute façon l'énergie non sauvegardée au redémarrage.
+static const uint32_t ENERGY_PREF_HASH_SALT = 0x454E5247;     // "ENRG"
+static const double ENERGY_SAVE_MIN_DELTA_KWH = 0.5;
+static const uint32_t ENERGY_SAVE_MIN_INTERVAL_MS = 600000;
+static const uint32_t ENERGY_SAVE_MAX_INTERVAL_MS = 3600000;
+// Bloc de fonctions 0x20/0x22 persisté: restauré au boot si son hash est cohérent, réécrit quand il change
+static const uint32_t FUNCTIONS_PREF_HASH_SALT = 0x46554E43;  // "FUNC"
+static const uint32_t FUNCTIONS_CACHE_VERSION = 1;
+
+// hardware_settings: les changements arrivent un par un depuis HA; ceux faits dans cette fenêtre partent
+// dans une seule écriture 0x1F/0x21, vérifiée par relecture 0x20/0x22
+static const uint32_t FUNCTIONS_TX_DEBOUNCE_MS = 1500;
+static const uint32_t FUNCTIONS_TX_STEP_TIMEOUT_MS = 2000;
+
+struct functionsCache {
+    uint32_t version;
+    uint32_t hash;          // heatpumpFunctions::hash() des 30 octets
+    uint8_t data1[15];
+    uint8_t data2[15];
+};
 
 static const int PACKET_LEN = 22;
 static const int PACKET_TYPE_DEFAULT = 99;
@@ -181,6 +241,8 @@ struct wantedHeatpumpSettings : heatpumpSettings {
             heatpumpSettings::operator=(other);
             hasChanged = other.hasChanged;
             hasBeenSent = other.hasBeenSent;
+            nb_deffered_requests = other.nb_deffered_requests;
+            lastChange = other.lastChange;
         }
         return *this;
     }
@@ -283,6 +345,77 @@ struct heatpumpRunStates {
     }
 };
 
+// Bits of heatpumpStateDelta::changed
+static const uint16_t STATE_CHANGED_POWER = 1 << 0;
+static const uint16_t STATE_CHANGED_MODE = 1 << 1;
+static const uint16_t STATE_CHANGED_TARGET_TEMP = 1 << 2;      // temperature and dual setpoints
+static const uint16_t STATE_CHANGED_FAN = 1 << 3;
+static const uint16_t STATE_CHANGED_VANE = 1 << 4;
+static const uint16_t STATE_CHANGED_WIDEVANE = 1 << 5;
+static const uint16_t STATE_CHANGED_ROOM_TEMP = 1 << 6;
+static const uint16_t STATE_CHANGED_OUTSIDE_TEMP = 1 << 7;
+static const uint16_t STATE_CHANGED_OPERATING = 1 << 8;        // operating flag and compressor frequency
+static const uint16_t STATE_CHANGED_ENERGY = 1 << 9;           // input power, kWh and runtime
+static const uint16_t STATE_CHANGED_RUN_STATES = 1 << 10;      // purifier, night mode, circulator, airflow control
+static const uint16_t STATE_CHANGED_SETTINGS = STATE_CHANGED_POWER | STATE_CHANGED_MODE | STATE_CHANGED_TARGET_TEMP |
+    STATE_CHANGED_FAN | STATE_CHANGED_VANE | STATE_CHANGED_WIDEVANE;
+static const uint16_t STATE_CHANGED_STATUS = STATE_CHANGED_ROOM_TEMP | STATE_CHANGED_OUTSIDE_TEMP |
+    STATE_CHANGED_OPERATING | STATE_CHANGED_ENERGY;
+
+// Bits of CN105Climate::publish_dirty_: the decoders only mark, flushPendingPublish() publishes once per cycle
+// (the telemetry sensors are ThrottledSensor and decide for themselves at each flush)
+static const uint8_t PUBLISH_DIRTY_CLIMATE = 1 << 0;
+
+// What the last decoded packet changed, with the up to date state (passed to the CN105Climate state listeners)
+struct heatpumpStateDelta {
+    uint16_t changed;
+    const heatpumpSettings& settings;
+    const heatpumpStatus& status;
+    const heatpumpRunStates& runStates;
+
+    bool has(uint16_t bits) const { return (changed & bits) != 0; }
+};
+
+// warm_start: last confirmed state, saved to flash and republished at boot before the first cycle.
+// Settings, capabilities and functions are saved as soon as they change (rare); telemetry at most hourly.
+static const uint32_t WARM_START_VERSION = 1;
+static const uint32_t WARM_START_PREF_HASH_SALT = 0x5741524D;   // "WARM"
+static const uint8_t WARM_START_UNKNOWN = 0xFF;                 // map index never received
+static const uint32_t WARM_START_SAVE_MIN_INTERVAL_MS = 60000;
+static const uint32_t WARM_START_STATUS_SAVE_INTERVAL_MS = 3600000;
+
+struct warmStartSnapshot {
+    struct Settings {
+        uint32_t version;
+        uint8_t power;                  // indexes in POWER_MAP, MODE_MAP, FAN_MAP, VANE_MAP, WIDEVANE_MAP
+        uint8_t mode;
+        uint8_t fan;
+        uint8_t vane;
+        uint8_t wideVane;
+        uint8_t iSee;
+        uint8_t installerFallback;      // the unit ignored the installer CONNECT (0x5B)
+        uint8_t functionsUnsupported;   // 0x20/0x22 answered only zeros
+        float temperature;
+        float dualLow;
+        float dualHigh;
+        uint8_t functionsValid;
+        uint8_t functions1[15];
+        uint8_t functions2[15];
+    } settings;
+    struct Status {
+        float roomTemperature;
+        float outsideAirTemperature;
+        float compressorFrequency;
+        float inputPower;
+        float kWh;
+        float runtimeHours;
+        uint8_t operating;
+        uint8_t stage;                  // indexes in STAGE_MAP, SUB_MODE_MAP, AUTO_SUB_MODE_MAP
+        uint8_t subMode;
+        uint8_t autoSubMode;
+    } status;
+};
+
 struct wantedHeatpumpRunStates : heatpumpRunStates {
     bool hasChanged;
     bool hasBeenSent;
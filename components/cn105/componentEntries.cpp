@@ -1,5 +1,4 @@
 #include "cn105.h"
-#include "hp_emulator_idf.h"
 #ifdef USE_WIFI
 #include "esphome/components/wifi/wifi_component.h"
 #endif
@@ -13,8 +12,6 @@ using namespace esphome;
  * setupUART will handle the
 */
 
-HVAC::HPEmulator myhp;
-
 void CN105Climate::setup() {
 
     ESP_LOGD(TAG, "Component initialization: setup call");
@@ -36,6 +33,13 @@ void CN105Climate::setup() {
     // Register info requests here to ensure all dependencies (like hardware_settings) are ready
     this->registerInfoRequests();
 
+    this->setupHandshakeCache();
+    this->setupFunctionsCache();
+    this->setupEnergyIntegrator();
+    if (this->telemetry_history_.is_configured()) {
+        this->telemetry_history_.begin();
+    }
+
     ESP_LOGI(TAG, "tx_pin: %d rx_pin: %d", this->tx_pin_, this->rx_pin_);
     //ESP_LOGI(TAG, "remote_temp_timeout is set to %lu", this->remote_temp_timeout_);
     log_info_uint32(TAG, "remote_temp_timeout is set to ", this->remote_temp_timeout_);
@@ -48,10 +52,34 @@ void CN105Climate::setup() {
     // Initialize the internal flag based on the static configuration provided by YAML/Python
     this->supports_dual_setpoint_ = this->traits_.has_feature_flags(climate::CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE);
     ESP_LOGI(TAG, "Dual setpoint support configured: %s", this->supports_dual_setpoint_ ? "YES" : "NO");
-    
-    //KIRBY was here
-    g_cn105 = this;  // Set global pointer so HPEmulator can access CN105Climate
-    myhp.setup();
+
+#if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 7, 0)
+    if (this->event_driven_loop_ && this->use_uart_rx_task_) {
+        // la tâche RX nous réveille dès qu'une trame est prête (appel depuis un autre contexte)
+        this->rx_task_.set_frame_callback([this]() { this->enable_loop_soon_any_context(); });
+    }
+#endif
+
+    // mesure du coût CPU du loop (comparaison avec/sans event_driven_loop)
+    this->set_interval("cn105_loop_cpu", LOOP_CPU_REPORT_INTERVAL_MS, [this]() {
+        ESP_LOGI(TAG, "loop CPU: %u ms over %u passes during the last hour (event driven: %s)",
+            (unsigned)(this->loop_cpu_us_ / 1000), (unsigned)this->loop_passes_, this->event_driven_loop_ ? "YES" : "NO");
+        this->loop_cpu_us_ = 0;
+        this->loop_passes_ = 0;
+        });
+
+    if (this->loop_profile_interval_ms_ > 0) {
+        this->profiler_.set_enabled(true);
+        AllocCounter::watch_current_task();     // setup() tourne dans la tâche du loop
+        this->set_interval("cn105_loop_profile", this->loop_profile_interval_ms_, [this]() { this->reportLoopProfile(); });
+    }
+
+    if (this->link_stats_interval_ms_ > 0) {
+        this->set_interval("cn105_link_stats", this->link_stats_interval_ms_, [this]() { this->reportLinkStats(); });
+    }
+
+    // en dernier: les traits (dual setpoint) et les requêtes doivent être prêts
+    this->setupWarmStart();
 
 }
 
@@ -61,21 +89,96 @@ void CN105Climate::setup() {
  * This function is called repeatedly in the main program loop.
  */
 void CN105Climate::loop() {
+    const uint32_t start_us = CUSTOM_MICROS;
+    LoopProfiler::Scope pass(this->profiler_, LoopProfiler::PASS, start_us);
+
+    if (this->loop_sleeping_) {
+        // réveillé par l'échéance, par la tâche RX ou par un producteur
+        this->loop_sleeping_ = false;
+        this->cancel_timeout("cn105_wake");
+    }
+
+    this->runLoopOnce();
+    {
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::IDLE_SLEEP, CUSTOM_MICROS);
+        this->scheduleIdleSleep();
+    }
+
+    this->loop_cpu_us_ += CUSTOM_MICROS - start_us;
+    this->loop_passes_++;
+}
+
+/**
+ * @brief Empreinte RAM du composant pour cette configuration de build (statique, tas, piles des tâches)
+ */
+void CN105Climate::dump_config() {
+    ESP_LOGCONFIG(TAG, "CN105:");
+#ifdef CN105_COMPACT_BUFFERS
+    ESP_LOGCONFIG(TAG, "  Frame buffers: %u B (compact_buffers)", (unsigned)MAX_DATA_BYTES);
+#else
+    ESP_LOGCONFIG(TAG, "  Frame buffers: %u B", (unsigned)MAX_DATA_BYTES);
+#endif
+    ESP_LOGCONFIG(TAG, "  RAM per instance: %u B (rx frame %u, pending/proxy packets %u, RX task + queue %u, link stats %u, loop profiler %u)",
+        (unsigned)sizeof(CN105Climate), (unsigned)sizeof(this->storedInputData),
+        (unsigned)(sizeof(this->pending_packet_) + sizeof(this->proxy_packet_)), (unsigned)sizeof(this->rx_task_),
+        (unsigned)sizeof(this->link_stats_), (unsigned)sizeof(this->profiler_));
+    ESP_LOGCONFIG(TAG, "  Heap: request table %u B, telemetry history %u B",
+        (unsigned)(this->scheduler_.requests().capacity() * sizeof(InfoRequest)),
+        (unsigned)this->telemetry_history_.get_allocated_bytes());
+    if (this->use_uart_rx_task_) {
+        ESP_LOGCONFIG(TAG, "  RX task stack: %u B", (unsigned)UartRxTask::STACK_SIZE);
+    }
+    if (this->telemetry_history_.is_configured()) {
+        ESP_LOGCONFIG(TAG, "  History server stack: %u B", (unsigned)TelemetryHistory::SERVER_STACK_SIZE);
+    }
+}
+
+/**
+ * @brief Appelé par ESPHome avant un redémarrage (OTA, reboot): sauvegarde l'énergie cumulée
+ */
+void CN105Climate::on_shutdown() {
+    this->saveEnergyIntegrator(true);
+    this->saveWarmStart(true);
+}
+
+void CN105Climate::runLoopOnce() {
     // Bootstrap connexion CN105 (UART + CONNECT) depuis loop()
-    this->maybe_start_connection_();
+    {
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::CONNECTION, CUSTOM_MICROS);
+        this->maybe_start_connection_();
+    }
+    if (this->conn_bootstrap_started_) {
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::LINK, CUSTOM_MICROS);
+        this->checkLinkLiveness();
+    }
+
+    // cycle terminé sans terminateCycle() (timeout) ou réponse reçue hors cycle: publier ce qui attend
+    if (this->publish_dirty_ != 0 && !this->loopCycle.isCycleRunning()) {
+        this->flushPendingPublish();
+    }
 
     // Tant que la connexion n'a pas réussi, on ne lance AUCUN cycle/écriture (sinon ça court-circuite le délai).
     // On continue quand même à lire/processer l'input afin de détecter le 0x7A/0x7B (connection success).
     const bool can_talk_to_hp = this->isHeatpumpConnected_;
 
-    //KIRBY was here
-    myhp.run();
-    
-    if (!this->processInput()) {                                            // if we don't get any input: no read op
+    bool gotInput;
+    {
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::INPUT, CUSTOM_MICROS);
+        gotInput = this->processInput();
+    }
+    if (!gotInput) {                                                        // if we don't get any input: no read op
         if (!can_talk_to_hp) {
             return;
         }
-        if ((this->wantedSettings.hasChanged) && (!this->loopCycle.isCycleRunning())) {
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::SCHEDULE, CUSTOM_MICROS);
+        if ((this->proxy_packet_pending_) && (!this->loopCycle.isCycleRunning())) {
+            this->flushProxyPacket();                                       // emulator_proxy_mode: cycle ended without giving its slot
+        } else if (this->functions_tx_.inFlight()) {
+            // transaction d'écriture des fonctions en cours: ni cycle ni autre écriture avant sa fin
+        } else if ((this->functions_tx_.state == FunctionsTxState::STAGED) && (!this->loopCycle.isCycleRunning()) &&
+            (CUSTOM_MILLIS - this->functions_tx_.stagedMs >= FUNCTIONS_TX_DEBOUNCE_MS)) {
+            this->startFunctionsTransaction();
+        } else if ((this->getCommittedWantedSettings().hasChanged) && (!this->loopCycle.isCycleRunning())) {
             this->checkPendingWantedSettings();
         } else if ((this->wantedRunStates.hasChanged) && (!this->loopCycle.isCycleRunning())) {
             this->checkPendingWantedRunStates();
@@ -91,9 +194,160 @@ void CN105Climate::loop() {
     }
 }
 
+/**
+ * event_driven_loop (ESPHome 2025.7+): when nothing is due, disables the component loop until the
+ * earliest deadline (next update cycle, or cycle timeout when the RX task is
+ * collecting the responses). Producers and the RX task wake it up earlier.
+ */
+void CN105Climate::scheduleIdleSleep() {
+#if ESPHOME_VERSION_CODE < VERSION_CODE(2025, 7, 0)
+    // pas de disable_loop() avant ESPHome 2025.7: polling classique (climate.py refuse event_driven_loop)
+    return;
+#else
+    if (!this->event_driven_loop_ || !this->isHeatpumpConnected_) {
+        return;
+    }
+    // un changement attend la fin de son debounce: on continue à tourner
+    if (this->getCommittedWantedSettings().hasChanged || this->wantedRunStates.hasChanged || this->has_pending_packet_ || this->proxy_packet_pending_ || this->publish_dirty_ != 0 ||
+        this->functions_tx_.state != FunctionsTxState::IDLE) {
+        return;
+    }
+
+    unsigned long sleepMs;
+    if (this->loopCycle.isCycleRunning()) {
+        // sans tâche RX, les réponses sont lues par le loop lui-même
+        if (!this->rx_task_.is_running()) {
+            return;
+        }
+        sleepMs = this->loopCycle.msUntilTimeout(this->update_interval_);
+    } else {
+        if (!this->rx_task_.is_running() && this->available() > 0) {
+            return;
+        }
+        sleepMs = this->loopCycle.msUntilNextCycle(this->get_update_interval());
+    }
+
+    // timeout de réponse ou tentative de reconnexion du LinkMonitor
+    const uint32_t linkMs = this->link_.msUntilDeadline(CUSTOM_MILLIS);
+    if (linkMs < sleepMs) {
+        sleepMs = linkMs;
+    }
+
+    if (sleepMs < EVENT_LOOP_MIN_SLEEP_MS) {
+        return;
+    }
+
+    ESP_LOGV(LOG_CYCLE_TAG, "idle, loop disabled for %lu ms", sleepMs);
+    this->loop_sleeping_ = true;
+    this->set_timeout("cn105_wake", sleepMs, [this]() { this->wakeLoop(); });
+    this->disable_loop();
+#endif
+}
+
+void CN105Climate::reportLoopProfile() {
+    ESP_LOGI(TAG, "loop profile over %u ms (µs, phases are inclusive: decode is part of input):",
+        (unsigned)this->loop_profile_interval_ms_);
+    for (uint8_t phase = 0; phase < LoopProfiler::PHASE_COUNT; phase++) {
+        const LoopProfiler::Stats& s = this->profiler_.stats(phase);
+        if (s.count == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-10s n=%-7u min=%-6u mean=%-6u p99=%-7u max=%-7u allocs=%u", LoopProfiler::phase_name(phase),
+            (unsigned)s.count, (unsigned)s.min_us, (unsigned)s.mean_us(), (unsigned)this->profiler_.p99_us(phase), (unsigned)s.max_us,
+            (unsigned)s.allocs);
+    }
+#ifdef USE_ESP32
+    // marges de pile minimales depuis le boot (octets): pire cas vu sur le loop, la tâche RX et le serveur HTTP
+    ESP_LOGI(TAG, "  stack: loop %u B free, rx task %u B free, history server %u B free",
+        (unsigned)uxTaskGetStackHighWaterMark(nullptr), (unsigned)this->rx_task_.get_stack_free(),
+        (unsigned)this->telemetry_history_.get_handler_stack_free());
+#endif
+    if (AllocCounter::ENABLED) {
+        // régime établi: connecté sur toute la fenêtre. Seule la publication (API ESPHome) a le droit d'allouer.
+        const uint32_t passAllocs = this->profiler_.stats(LoopProfiler::PASS).allocs;
+        const uint32_t publishAllocs = this->profiler_.stats(LoopProfiler::PUBLISH).allocs;
+        const uint32_t steadyAllocs = (passAllocs > publishAllocs) ? passAllocs - publishAllocs : 0;
+        const bool steady = this->profile_window_connected_ && this->isHeatpumpConnected_ &&
+            this->link_stats_.get_reconnects() == this->profile_window_reconnects_;
+        ESP_LOGI(TAG, "  heap: %u allocation(s) in loop, %u outside publish, %u B since boot",
+            (unsigned)passAllocs, (unsigned)steadyAllocs, (unsigned)AllocCounter::bytes());
+        if (steady && steadyAllocs > 0) {
+            ESP_LOGW(TAG, "steady-state polling allocated %u time(s) outside publish (see allocs= per phase)", (unsigned)steadyAllocs);
+        }
+        if (steady && this->loop_allocs_sensor_ != nullptr) {
+            this->loop_allocs_sensor_->publish_state(steadyAllocs);
+        }
+        this->profile_window_connected_ = this->isHeatpumpConnected_;
+        this->profile_window_reconnects_ = this->link_stats_.get_reconnects();
+    }
+    if (this->loop_max_sensor_ != nullptr) {
+        this->loop_max_sensor_->publish_state(this->profiler_.stats(LoopProfiler::PASS).max_us);
+    }
+    if (this->loop_p99_sensor_ != nullptr) {
+        this->loop_p99_sensor_->publish_state(this->profiler_.p99_us(LoopProfiler::PASS));
+    }
+    this->profiler_.reset();
+}
+
+size_t CN105Climate::get_link_stats_blob(uint8_t* out, size_t max) {
+    // les timeouts soft sont tenus par le scheduler: recopiés au moment de sérialiser
+    for (const auto& req : this->scheduler_.requests()) {
+        this->link_stats_.setSoftTimeouts(req.code, req.soft_timeouts);
+    }
+    return this->link_stats_.serialize(out, max, this->parent_->get_baud_rate(), CUSTOM_MILLIS,
+        (uint32_t)this->nbCycles_, (uint32_t)this->nbCompleteCycles_);
+}
+
+void CN105Climate::reportLinkStats() {
+    const uint32_t baud = this->parent_->get_baud_rate();
+    const uint16_t busy = this->link_stats_.busyPermille(CUSTOM_MILLIS, baud);
+    ESP_LOGI(TAG, "link stats: busy %u.%u%% @%u bauds, tx %u B/%u frames, rx %u B/%u frames, "
+        "errors %u (checksum %u, header %u, overflow %u), reconnects %u, complete cycles %lu/%lu",
+        busy / 10, busy % 10, (unsigned)baud,
+        (unsigned)this->link_stats_.get_tx_bytes(), (unsigned)this->link_stats_.get_tx_frames(),
+        (unsigned)this->link_stats_.get_rx_bytes(), (unsigned)this->link_stats_.get_rx_frames(),
+        (unsigned)this->link_stats_.get_errors(), (unsigned)this->link_stats_.get_checksum_failures(),
+        (unsigned)this->link_stats_.get_header_mismatches(), (unsigned)this->link_stats_.get_overflow_resets(),
+        (unsigned)this->link_stats_.get_reconnects(), this->nbCompleteCycles_, this->nbCycles_);
+    if (this->link_busy_sensor_ != nullptr) {
+        this->link_busy_sensor_->publish_state(busy / 10.0f);
+    }
+    if (this->link_errors_sensor_ != nullptr) {
+        this->link_errors_sensor_->publish_state(this->link_stats_.get_errors());
+    }
+    if (this->link_tx_bytes_sensor_ != nullptr) {
+        this->link_tx_bytes_sensor_->publish_state(this->link_stats_.get_tx_bytes());
+    }
+    if (this->link_rx_bytes_sensor_ != nullptr) {
+        this->link_rx_bytes_sensor_->publish_state(this->link_stats_.get_rx_bytes());
+    }
+    if (this->telemetry_history_.is_configured()) {
+        uint8_t blob[LinkStats::MAX_BLOB_SIZE];
+        const size_t len = this->get_link_stats_blob(blob, sizeof(blob));
+        this->telemetry_history_.set_stats_blob(blob, len);
+    }
+}
+
+void CN105Climate::wakeLoop() {
+#if ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 7, 0)
+    if (this->loop_sleeping_) {
+        this->enable_loop();
+    }
+#endif
+}
+
 void CN105Climate::maybe_start_connection_() {
     if (this->conn_bootstrap_started_) return;
 
+    // warm_start: l'état restauré couvre l'attente, le handshake part tout de suite, en parallèle du WiFi
+    if (this->warm_start_) {
+        this->conn_bootstrap_started_ = true;
+        ESP_LOGI(LOG_CONN_TAG, "Bootstrap connexion: warm start, init UART + envoi CONNECT sans attendre le WiFi");
+        this->setupUART();
+        this->sendFirstConnectionPacket();
+        return;
+    }
+
     // Timeout global: au bout de 2 minutes on démarre même sans WiFi
     if (!this->conn_timeout_armed_) {
         this->conn_timeout_armed_ = true;
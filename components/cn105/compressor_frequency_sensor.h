@@ -1,12 +1,11 @@
 #pragma once
 
-#include "esphome/components/sensor/sensor.h"
-#include "esphome/core/component.h"
+#include "throttled_sensor.h"
 
 
 namespace esphome {
 
-    class CompressorFrequencySensor : public sensor::Sensor, public Component {
+    class CompressorFrequencySensor : public ThrottledSensor {
     public:
         CompressorFrequencySensor() {
             this->set_unit_of_measurement("Hz");
@@ -63,3 +63,17 @@ bool cycleManagement::doesCycleTimeOut(unsigned int update_interval) {
     if (CUSTOM_MILLIS < lastCycleStartMs) return false;         // must be checked because operands are they are unsigned
     return (CUSTOM_MILLIS - lastCycleStartMs) > (2 * update_interval) + 1000;
 }
+
+// delay until hasUpdateIntervalPassed() becomes true (0 if already due)
+unsigned long cycleManagement::msUntilNextCycle(unsigned int update_interval) {
+    unsigned long due = lastCompleteCycleMs + update_interval + 1;
+    unsigned long now = CUSTOM_MILLIS;
+    return (now < due) ? due - now : 0;
+}
+
+// delay until doesCycleTimeOut() becomes true (0 if already due)
+unsigned long cycleManagement::msUntilTimeout(unsigned int update_interval) {
+    unsigned long due = lastCycleStartMs + (2 * update_interval) + 1000 + 1;
+    unsigned long now = CUSTOM_MILLIS;
+    return (now < due) ? due - now : 0;
+}
@@ -14,5 +14,7 @@ struct cycleManagement {
     bool isCycleRunning();
     void deferCycle();
     void checkTimeout(unsigned int update_interval);
+    unsigned long msUntilNextCycle(unsigned int update_interval);
+    unsigned long msUntilTimeout(unsigned int update_interval);
 
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+// Generated from web/emulator_index.html, do not edit by hand:
+//   python3 -c "import gzip,sys; sys.stdout.buffer.write(gzip.compress(open('web/emulator_index.html','rb').read(), 9, mtime=0))" | xxd -i
+// The ETag is the CRC32 of the compressed bytes.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace HVAC {
+
+static const char EMULATOR_INDEX_ETAG[] = "\"a9740623\"";
+static const size_t EMULATOR_INDEX_GZ_LEN = 1616;
+static const uint8_t EMULATOR_INDEX_GZ[EMULATOR_INDEX_GZ_LEN] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x58, 0xef, 0x6e, 0xdb, 0x36,
+    0x10, 0xff, 0xde, 0xa7, 0xb8, 0xaa, 0x1f, 0x22, 0xad, 0xb1, 0x6c, 0x37, 0x4d, 0x11, 0x3b, 0xb6,
+    0x87, 0x2c, 0x4b, 0x90, 0x0e, 0xed, 0x5a, 0x20, 0x59, 0x81, 0x21, 0xc8, 0x07, 0x5a, 0x3a, 0xd9,
+    0x6c, 0xf5, 0x6f, 0x24, 0x65, 0xc7, 0xfd, 0xf3, 0x4e, 0x7b, 0x86, 0x3d, 0xd9, 0x8e, 0xa4, 0x64,
+    0xcb, 0xb2, 0x9c, 0x04, 0xd8, 0x6c, 0x24, 0x22, 0x8f, 0xc7, 0xbb, 0xe3, 0xdd, 0xef, 0x78, 0x27,
+    0x8f, 0x9e, 0xff, 0xfa, 0xe1, 0xfc, 0xe6, 0xcf, 0x8f, 0x17, 0x30, 0x57, 0x49, 0x3c, 0x79, 0x36,
+    0xd2, 0x0f, 0x88, 0x59, 0x3a, 0x1b, 0x3b, 0x98, 0x3a, 0x9a, 0x80, 0x2c, 0x9c, 0x3c, 0x03, 0xfa,
+    0x8c, 0x12, 0x54, 0x0c, 0x82, 0x39, 0x13, 0x12, 0xd5, 0xd8, 0xf9, 0xe3, 0xe6, 0xb2, 0x73, 0xe2,
+    0xd4, 0x97, 0x52, 0x96, 0xe0, 0xd8, 0x59, 0x70, 0x5c, 0xe6, 0x99, 0x50, 0x0e, 0x04, 0x59, 0xaa,
+    0x30, 0x25, 0xd6, 0x25, 0x0f, 0xd5, 0x7c, 0x1c, 0xe2, 0x82, 0x07, 0xd8, 0x31, 0x93, 0x43, 0xe0,
+    0x29, 0x57, 0x9c, 0xc5, 0x1d, 0x19, 0xb0, 0x18, 0xc7, 0x7d, 0xbf, 0x57, 0x89, 0x52, 0x5c, 0xc5,
+    0x38, 0xb9, 0xfa, 0x08, 0x17, 0x49, 0x11, 0x33, 0x95, 0x89, 0x51, 0xd7, 0x92, 0xec, 0xb2, 0x54,
+    0xab, 0x6a, 0xac, 0x3f, 0xd3, 0x2c, 0x5c, 0xc1, 0xb7, 0xf5, 0x54, 0x7f, 0x22, 0x52, 0xdb, 0x89,
+    0x58, 0xc2, 0xe3, 0xd5, 0x10, 0xce, 0x04, 0x29, 0x39, 0x04, 0xc9, 0x52, 0xd9, 0x91, 0x28, 0x78,
+    0x74, 0xba, 0xc5, 0x9b, 0x30, 0x31, 0xe3, 0xe9, 0x10, 0xfa, 0xbd, 0xfc, 0x7e, 0x7b, 0x65, 0xca,
+    0x82, 0x2f, 0x33, 0x91, 0x15, 0x69, 0xd8, 0x09, 0xb2, 0x38, 0x13, 0x43, 0x78, 0x11, 0x1d, 0xeb,
+    0xef, 0xe9, 0xae, 0x32, 0xc9, 0xbf, 0x22, 0xc9, 0x38, 0xaa, 0xcb, 0xf8, 0xb1, 0x1e, 0xf9, 0xda,
+    0x0f, 0x8c, 0xa7, 0x28, 0x1a, 0x86, 0xee, 0xaa, 0x58, 0xce, 0xb9, 0xc2, 0x6d, 0x05, 0x39, 0x0b,
+    0x43, 0x9e, 0xce, 0x48, 0xfc, 0xf1, 0x8e, 0x89, 0x99, 0x08, 0x51, 0x74, 0x04, 0x0b, 0x79, 0x21,
+    0x87, 0xf0, 0x66, 0x77, 0xfd, 0xbe, 0x23, 0xe7, 0x2c, 0xcc, 0x96, 0x43, 0xe8, 0xc1, 0xab, 0xfc,
+    0x1e, 0x5e, 0xd3, 0x9f, 0x98, 0x4d, 0x99, 0xdb, 0x3b, 0x34, 0x5f, 0xbf, 0xef, 0x35, 0xfd, 0x71,
+    0x6f, 0x03, 0x34, 0x84, 0x41, 0x6f, 0xc7, 0x27, 0x95, 0xb7, 0x7a, 0xc0, 0x0a, 0x95, 0xb5, 0x9d,
+    0x75, 0xde, 0x6f, 0x9c, 0xb1, 0xf2, 0xdd, 0xd1, 0xd1, 0xd1, 0xb6, 0x2c, 0x85, 0xf7, 0xaa, 0xc3,
+    0x62, 0x3e, 0x23, 0x79, 0x01, 0xa1, 0x04, 0xc5, 0x3e, 0x5d, 0x3d, 0x73, 0x74, 0xe8, 0xed, 0x75,
+    0xfc, 0xab, 0xde, 0x1e, 0xc7, 0xcf, 0x04, 0x0f, 0x1b, 0xf6, 0x84, 0x5c, 0xe6, 0x31, 0x23, 0x60,
+    0xe8, 0xb5, 0x6d, 0x89, 0x9a, 0xd2, 0x51, 0x98, 0xd0, 0xba, 0x42, 0x1d, 0x91, 0x22, 0x49, 0xc9,
+    0xad, 0xfd, 0x48, 0xe8, 0xbf, 0x06, 0x2f, 0xcb, 0x9b, 0xa0, 0xa9, 0xe9, 0x95, 0x8a, 0xa9, 0x42,
+    0x76, 0x28, 0x96, 0xc9, 0xa3, 0x21, 0x7f, 0x11, 0x0d, 0xf4, 0x77, 0x5f, 0xd0, 0x7b, 0x7b, 0x82,
+    0x1e, 0x63, 0xa4, 0x86, 0x40, 0x88, 0x03, 0x99, 0xc5, 0x74, 0xca, 0x17, 0xaf, 0xcf, 0xcf, 0x2e,
+    0x8f, 0x7b, 0x0f, 0x02, 0xe4, 0xe8, 0x71, 0x73, 0xfd, 0x84, 0xcb, 0x84, 0xa9, 0x60, 0xde, 0xb4,
+    0x7b, 0xa3, 0x75, 0x63, 0x78, 0x34, 0x38, 0xe9, 0xf5, 0x1e, 0xcf, 0x9a, 0x28, 0x3a, 0xc2, 0xde,
+    0x43, 0x8a, 0x63, 0x36, 0xc5, 0xb8, 0x2d, 0x89, 0x97, 0xc8, 0x67, 0x73, 0x3a, 0xe6, 0x34, 0x8b,
+    0x1b, 0xb1, 0xaa, 0x84, 0x1f, 0x1f, 0x3f, 0x90, 0x8f, 0xfd, 0xa6, 0xef, 0x0c, 0xe6, 0x94, 0xa0,
+    0xbb, 0x20, 0xca, 0x44, 0x32, 0x84, 0x22, 0xcf, 0x51, 0x04, 0x4c, 0x62, 0x1b, 0xf4, 0x3a, 0xd3,
+    0x4c, 0xa9, 0x2c, 0x69, 0xe4, 0x55, 0xcd, 0xfa, 0x05, 0x8b, 0x0b, 0x94, 0x9d, 0x7d, 0xd9, 0xfd,
+    0x7f, 0x22, 0xed, 0xe4, 0x21, 0x13, 0xc8, 0xd0, 0xfb, 0x86, 0xee, 0x87, 0x92, 0x6b, 0x67, 0xbb,
+    0x5a, 0xe5, 0xd8, 0xe6, 0x7d, 0xeb, 0xc5, 0x41, 0xd3, 0x89, 0x95, 0xeb, 0x4f, 0x4e, 0x4e, 0x1e,
+    0x74, 0xdb, 0x23, 0x68, 0x33, 0xba, 0xf7, 0xab, 0xed, 0xbf, 0xd9, 0xa7, 0xb7, 0x0d, 0xe8, 0x0f,
+    0xa0, 0xa5, 0xa6, 0x39, 0xca, 0x32, 0xb5, 0x13, 0xa6, 0xa7, 0xdd, 0x43, 0x1d, 0x95, 0xe5, 0x6d,
+    0xd9, 0x58, 0xb7, 0xb8, 0xb7, 0xcf, 0xe2, 0xc1, 0x60, 0xd0, 0xb4, 0x67, 0xd4, 0x2d, 0xeb, 0xd8,
+    0xa8, 0x6b, 0x0b, 0xec, 0x48, 0x17, 0xb2, 0xb2, 0xc4, 0x85, 0x7c, 0x01, 0x41, 0xcc, 0xa4, 0x1c,
+    0x3b, 0x6b, 0x70, 0x39, 0x9b, 0x92, 0x37, 0x9a, 0xf7, 0x27, 0x57, 0xc8, 0x54, 0x5e, 0x24, 0x79,
+    0xad, 0x48, 0x12, 0x75, 0xc3, 0x52, 0x13, 0xa1, 0xc1, 0xe6, 0x00, 0x0f, 0xcb, 0xd1, 0x64, 0xd4,
+    0xa5, 0xc5, 0x76, 0x56, 0xeb, 0x20, 0xcb, 0x5c, 0x8e, 0xdb, 0x34, 0xad, 0xf7, 0xd7, 0x87, 0x32,
+    0x10, 0x3c, 0x57, 0x76, 0xd2, 0xed, 0xc2, 0x35, 0x8a, 0x05, 0x86, 0x30, 0xfb, 0xca, 0x73, 0xf2,
+    0x43, 0x92, 0x0b, 0x94, 0x92, 0xe6, 0x91, 0xc8, 0x12, 0x88, 0x48, 0xdb, 0xfc, 0x14, 0xd4, 0x1c,
+    0x41, 0x83, 0x01, 0x35, 0x03, 0x4a, 0xbb, 0xd6, 0xb5, 0xf0, 0xf0, 0x3f, 0xcb, 0x2c, 0xd5, 0x1c,
+    0xe6, 0x1f, 0x74, 0x71, 0x41, 0xa1, 0x91, 0x10, 0x62, 0x4c, 0x7d, 0x86, 0x54, 0x02, 0x59, 0xf2,
+    0xcc, 0xba, 0x38, 0x95, 0x0a, 0x44, 0xb6, 0x94, 0x30, 0x86, 0xdb, 0xf5, 0xa1, 0x6e, 0x9d, 0x3c,
+    0x5b, 0x92, 0xf5, 0x87, 0xe0, 0x7c, 0x34, 0x83, 0xbb, 0x43, 0xa2, 0x25, 0x59, 0x88, 0x9a, 0xf4,
+    0x5e, 0x3f, 0x0d, 0x25, 0x62, 0xa9, 0x26, 0x5c, 0xb2, 0x14, 0xae, 0x73, 0xc4, 0x50, 0x53, 0xd3,
+    0x22, 0x8e, 0x0f, 0x6b, 0x92, 0xa8, 0xd9, 0xb9, 0xa1, 0x54, 0xd5, 0x7c, 0x37, 0x84, 0x05, 0x54,
+    0xa0, 0xa7, 0xe0, 0xfe, 0xf3, 0xf7, 0xb9, 0x67, 0xa5, 0x94, 0x1c, 0x97, 0x2d, 0x2c, 0x97, 0x9a,
+    0xa5, 0x26, 0x8c, 0x05, 0xaa, 0x60, 0x71, 0x25, 0xef, 0xcc, 0xcc, 0x76, 0xe4, 0x6d, 0x98, 0x2e,
+    0x5b, 0xb8, 0x9a, 0x22, 0x17, 0x2c, 0x35, 0xa7, 0xfa, 0x44, 0x4f, 0xf8, 0x84, 0x42, 0x71, 0xea,
+    0xa8, 0xac, 0x20, 0xaa, 0xe4, 0xf8, 0xa9, 0xbe, 0x7c, 0x95, 0x09, 0xfe, 0x55, 0x43, 0x8a, 0x18,
+    0x8c, 0x88, 0xbb, 0xd3, 0x9a, 0x1b, 0x6d, 0x30, 0xc6, 0xf0, 0x0d, 0xb0, 0x8c, 0xf5, 0x10, 0xbe,
+    0xfd, 0x38, 0x04, 0x94, 0xf9, 0x9c, 0x22, 0xa4, 0x27, 0xf0, 0xa3, 0xbe, 0xc1, 0xd4, 0xd7, 0x31,
+    0x84, 0x59, 0x50, 0x24, 0x14, 0x1f, 0x9f, 0x4e, 0x7e, 0x11, 0xa3, 0x1e, 0xfe, 0xb2, 0x7a, 0x1b,
+    0xba, 0x16, 0x70, 0x65, 0x87, 0x41, 0x37, 0x2e, 0xb8, 0xeb, 0x70, 0x41, 0x16, 0x99, 0xa8, 0x79,
+    0xb5, 0x6c, 0xe4, 0x11, 0xb8, 0xcf, 0x89, 0x48, 0x34, 0x23, 0xd9, 0xe7, 0x29, 0x75, 0x6c, 0xea,
+    0x2c, 0xfc, 0xcc, 0x74, 0x62, 0x5e, 0xdd, 0xbc, 0x7f, 0xe7, 0x3a, 0x53, 0x24, 0x41, 0x88, 0x69,
+    0x48, 0x67, 0x3a, 0x30, 0xd8, 0x35, 0x89, 0xa4, 0xdb, 0x4e, 0xc9, 0xa7, 0x3c, 0xe6, 0x8a, 0x6e,
+    0xdc, 0x39, 0x0f, 0x43, 0x4c, 0x4f, 0x2b, 0xac, 0x1f, 0x78, 0xa7, 0xa6, 0x17, 0xe5, 0x69, 0x81,
+    0xa7, 0xb5, 0x0b, 0xe1, 0x29, 0x4a, 0xb6, 0x12, 0xfa, 0xa0, 0x9e, 0x2c, 0xb5, 0xaa, 0x69, 0x33,
+    0xe6, 0x00, 0x5e, 0xea, 0x33, 0xdd, 0xf6, 0xee, 0x68, 0x70, 0x40, 0xca, 0x77, 0x99, 0x4d, 0xa5,
+    0x73, 0x26, 0x15, 0x67, 0xdf, 0x70, 0x96, 0x46, 0xc2, 0xcb, 0xfd, 0xba, 0x9a, 0xa5, 0xc6, 0x79,
+    0x02, 0xbb, 0x2e, 0x0b, 0xdb, 0x46, 0x6c, 0xae, 0x7b, 0x67, 0xb2, 0x9d, 0xcd, 0x2d, 0xa6, 0x1a,
+    0xe6, 0xca, 0x83, 0x4f, 0x35, 0xf1, 0x11, 0x9d, 0x16, 0x47, 0xff, 0x4d, 0x65, 0x7d, 0xb1, 0x84,
+    0xd6, 0x8f, 0x1a, 0x24, 0x23, 0xc2, 0xa3, 0x1b, 0x78, 0x30, 0x9e, 0xd0, 0x03, 0xc6, 0xe3, 0x31,
+    0x50, 0x2f, 0x82, 0x11, 0x39, 0x2d, 0x84, 0x9f, 0x6b, 0xe3, 0x21, 0xbc, 0x67, 0x6a, 0xee, 0x9b,
+    0x56, 0x85, 0x18, 0x7f, 0x82, 0x01, 0x74, 0xe1, 0x98, 0xc2, 0x71, 0xf4, 0xca, 0xab, 0x10, 0x5b,
+    0xa4, 0x81, 0xe2, 0x74, 0x0d, 0x09, 0x42, 0x02, 0x0a, 0xb7, 0x8e, 0xd5, 0x1a, 0x9a, 0x25, 0x25,
+    0x99, 0x86, 0xf3, 0xad, 0x53, 0x65, 0x8d, 0x4e, 0xb7, 0x32, 0x67, 0x9c, 0x3b, 0xaf, 0x51, 0x6f,
+    0x4c, 0x92, 0xdd, 0xea, 0x4d, 0x77, 0x7e, 0x75, 0x71, 0x90, 0xcd, 0x91, 0xdb, 0xb2, 0xd0, 0x68,
+    0xce, 0xeb, 0x1c, 0xb5, 0x3b, 0x62, 0x67, 0xf7, 0x66, 0xcd, 0x6b, 0xab, 0x83, 0x8f, 0x67, 0xe2,
+    0x76, 0x36, 0xae, 0x53, 0xa7, 0x51, 0xdc, 0xb4, 0x00, 0xd3, 0xe2, 0xee, 0xbf, 0x01, 0x6c, 0x3a,
+    0x78, 0x6d, 0x3b, 0x2d, 0xa4, 0x69, 0xaf, 0x69, 0x3b, 0xff, 0x2a, 0x50, 0xac, 0xae, 0x31, 0xc6,
+    0x80, 0xfc, 0x77, 0x16, 0xc7, 0xae, 0xb3, 0xd5, 0x27, 0x38, 0xad, 0x22, 0x18, 0xed, 0x36, 0xe7,
+    0xf6, 0x2b, 0xcf, 0xdf, 0x5a, 0x85, 0x74, 0xf9, 0x4d, 0x37, 0x6b, 0x36, 0x12, 0xd5, 0xd2, 0xb6,
+    0x20, 0x6b, 0x05, 0xd1, 0x7d, 0xdd, 0x07, 0x9c, 0xdb, 0x17, 0x56, 0xda, 0xca, 0x76, 0xa0, 0xe3,
+    0x74, 0x1c, 0x02, 0x0d, 0x6b, 0xdd, 0xde, 0x6f, 0x6e, 0x9f, 0xee, 0xd9, 0x3e, 0xdd, 0xde, 0x6e,
+    0x8e, 0x6e, 0x72, 0xe0, 0x1d, 0x97, 0xca, 0x57, 0xd9, 0x6c, 0x16, 0xa3, 0xeb, 0x54, 0x3d, 0x38,
+    0xe1, 0x88, 0xc1, 0x73, 0x12, 0x34, 0x6d, 0x8d, 0xe3, 0xde, 0x6b, 0xb7, 0x2c, 0xdd, 0x5e, 0xc3,
+    0x28, 0xe7, 0x1d, 0x5f, 0x20, 0xb8, 0x0b, 0x87, 0x50, 0x6e, 0x5d, 0xb3, 0xa0, 0x91, 0xe3, 0x39,
+    0x8d, 0x1c, 0xb3, 0x58, 0xf2, 0x73, 0x91, 0xdd, 0xaf, 0xb4, 0xe5, 0xf0, 0x1d, 0xec, 0xd8, 0xd4,
+    0x4f, 0x3a, 0x85, 0xe3, 0x78, 0xb4, 0xb1, 0x64, 0x13, 0x98, 0x90, 0xb6, 0xb7, 0xa9, 0xd6, 0x23,
+    0xb2, 0xb8, 0xdc, 0x60, 0xa9, 0xf4, 0x92, 0x6f, 0xd0, 0x43, 0xf4, 0xf5, 0xbe, 0x2d, 0x55, 0x9a,
+    0x75, 0xa7, 0xc1, 0x70, 0xea, 0x59, 0xbd, 0x4e, 0x42, 0x96, 0xe7, 0xf1, 0xca, 0x4d, 0xe4, 0x6c,
+    0x4f, 0x1a, 0x7e, 0xc1, 0x95, 0x86, 0xf2, 0x87, 0xe9, 0x67, 0xc2, 0x90, 0x4f, 0x33, 0x69, 0x98,
+    0xdb, 0x60, 0xad, 0x59, 0x75, 0x7c, 0x36, 0x09, 0x0b, 0xdf, 0xbf, 0xc3, 0x86, 0x5a, 0xa6, 0xae,
+    0x57, 0x09, 0xa3, 0xf8, 0x50, 0x7b, 0x58, 0xa6, 0x18, 0xb1, 0x11, 0xbc, 0x48, 0xb4, 0x19, 0x35,
+    0x70, 0x89, 0xb1, 0x2c, 0x7b, 0x1a, 0xb3, 0x4a, 0x4e, 0xaf, 0x18, 0xdb, 0x02, 0x58, 0xdd, 0x2b,
+    0x5b, 0xe7, 0x45, 0x0a, 0xbc, 0xeb, 0xd4, 0xdb, 0x20, 0x1d, 0x48, 0x6a, 0x84, 0x5c, 0x57, 0x98,
+    0x6b, 0x4d, 0x18, 0xa2, 0xeb, 0x95, 0x54, 0xe3, 0x97, 0x52, 0x84, 0x3e, 0xdc, 0x92, 0xa7, 0xf4,
+    0xc2, 0xef, 0x5f, 0xe8, 0x86, 0xe9, 0x3a, 0x2b, 0x44, 0x80, 0x75, 0x17, 0x58, 0x5f, 0x95, 0xdd,
+    0xd4, 0x18, 0x52, 0x5c, 0x42, 0x8d, 0x93, 0xf4, 0xda, 0xa5, 0x7a, 0xbe, 0x59, 0x8a, 0x4f, 0x6f,
+    0xa4, 0x86, 0x53, 0x23, 0x15, 0xa9, 0x04, 0xb9, 0xe6, 0xd6, 0xd6, 0xad, 0x85, 0x8b, 0xc6, 0x2e,
+    0x1b, 0xa0, 0xdf, 0xae, 0x3f, 0xfc, 0xee, 0xe7, 0xfa, 0x27, 0x22, 0x17, 0xfd, 0x90, 0x29, 0xe6,
+    0x79, 0x4f, 0x91, 0x65, 0x1a, 0xbb, 0xa7, 0xcb, 0x5a, 0x37, 0xd1, 0x65, 0xd3, 0x39, 0xea, 0xda,
+    0xf6, 0x99, 0xba, 0x60, 0xf3, 0x33, 0xd6, 0xbf, 0xcf, 0x33, 0x38, 0xcf, 0xd7, 0x12, 0x00, 0x00,
+};
+
+} // namespace HVAC
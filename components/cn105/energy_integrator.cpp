@@ -0,0 +1,89 @@
+#include "energy_integrator.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+
+    static const char* const ENERGY_TAG = "ENERGY";
+
+    bool EnergyIntegrator::restore(const EnergyIntegratorState& saved) {
+        // v1: même disposition, sans sinceStepKwh (octets de padding, non initialisés)
+        if ((saved.version != STATE_VERSION && saved.version != 1) || !(saved.totalKwh >= 0.0)) {
+            return false;
+        }
+        this->state_ = saved;
+        const double sinceStep = (saved.version == STATE_VERSION && saved.sinceStepKwh >= 0.0f &&
+            saved.sinceStepKwh <= COUNTER_STEP_KWH) ? saved.sinceStepKwh : 0.0;
+        this->state_.version = STATE_VERSION;
+        this->state_.sinceStepKwh = 0.0f;
+        this->residualKwh_ = saved.counterActive ? sinceStep : 0.0;
+        this->sinceCounterKwh_ = saved.counterActive ? 0.0 : sinceStep;
+        this->hasLastSample_ = false;
+        return true;
+    }
+
+    EnergyIntegratorState EnergyIntegrator::state() const {
+        EnergyIntegratorState saved = this->state_;
+        saved.sinceStepKwh = (float)(this->state_.counterActive ? this->residualKwh_ : this->sinceCounterKwh_);
+        return saved;
+    }
+
+    void EnergyIntegrator::update(float inputPowerW, uint16_t counterRaw, uint32_t nowMs) {
+        // 1. intégration de la puissance (trapèzes), sauf après un trou (lien coupé, reboot)
+        if (this->hasLastSample_) {
+            const uint32_t dtMs = nowMs - this->lastUpdateMs_;
+            if (dtMs <= MAX_INTEGRATION_GAP_MS) {
+                const double kwh = (double)(inputPowerW + this->lastPowerW_) / 2.0 * dtMs / 3600000000.0;
+                if (this->state_.counterActive) {
+                    this->residualKwh_ += kwh;
+                    if (this->residualKwh_ > COUNTER_STEP_KWH) this->residualKwh_ = COUNTER_STEP_KWH;
+                } else {
+                    this->state_.totalKwh += kwh;
+                    this->sinceCounterKwh_ += kwh;
+                }
+            }
+        }
+        this->lastPowerW_ = inputPowerW;
+        this->lastUpdateMs_ = nowMs;
+        this->hasLastSample_ = true;
+
+        // 2. rapprochement avec le compteur matériel
+        if (!this->state_.counterSeen) {
+            this->state_.lastCounter = counterRaw;
+            this->state_.counterSeen = true;
+            return;
+        }
+        if (counterRaw == this->state_.lastCounter) {
+            return;
+        }
+
+        uint16_t steps = (uint16_t)(counterRaw - this->state_.lastCounter);   // modulo 2^16: absorbe le débordement
+        if (steps > MAX_COUNTER_JUMP) {
+            ESP_LOGW(ENERGY_TAG, "kWh counter jumped from %u to %u (%u steps > %u): counter reset, %.1f kWh not credited, rebasing",
+                (unsigned)this->state_.lastCounter, (unsigned)counterRaw, (unsigned)steps, (unsigned)MAX_COUNTER_JUMP, steps * COUNTER_STEP_KWH);
+            this->resets_++;
+            steps = 0;
+        } else if (counterRaw < this->state_.lastCounter) {
+            ESP_LOGI(ENERGY_TAG, "kWh counter wrapped (%u -> %u)", (unsigned)this->state_.lastCounter, (unsigned)counterRaw);
+            this->wraps_++;
+        }
+        this->state_.lastCounter = counterRaw;
+        if (steps == 0) {
+            return;
+        }
+
+        const double counted = steps * COUNTER_STEP_KWH;
+        if (this->state_.counterActive) {
+            // le résidu (<= un pas) est remplacé par le pas réel: le total ne recule jamais
+            this->state_.totalKwh += counted;
+        } else {
+            // premier pas observé: l'intégration déjà versée couvre une partie de ce pas
+            const double missing = counted - this->sinceCounterKwh_;
+            if (missing > 0.0) this->state_.totalKwh += missing;
+            this->state_.counterActive = true;
+            ESP_LOGI(ENERGY_TAG, "kWh counter is moving, using it as the reference");
+        }
+        this->residualKwh_ = 0.0;
+        this->sinceCounterKwh_ = 0.0;
+    }
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+    /**
+     * @brief Partie persistée (flash) de l'EnergyIntegrator
+     */
+    struct EnergyIntegratorState {
+        uint32_t version;
+        double totalKwh;            // énergie cumulée, hors résidu intégré depuis le dernier pas du compteur
+        uint16_t lastCounter;       // dernière valeur brute du compteur 0x06 (dixièmes de kWh)
+        bool counterSeen;
+        bool counterActive;         // le compteur matériel a déjà avancé (sinon: intégration seule)
+        // intégré depuis le dernier pas du compteur (v2, loge dans le padding de la v1: même taille en flash).
+        // Compteur actif: hors totalKwh (résidu); intégration seule: déjà compris dans totalKwh.
+        float sinceStepKwh;
+    };
+
+    /**
+     * @class EnergyIntegrator
+     * @brief Compteur d'énergie monotone, indépendant du compteur 16 bits de la PAC.
+     *
+     * La puissance instantanée (0x06) est intégrée (trapèzes) entre deux trames. Quand la PAC expose un
+     * compteur kWh qui avance, il fait foi: chaque pas de 0.1 kWh est crédité, et l'intégration ne sert
+     * qu'à combler l'intervalle entre deux pas (plafonnée à un pas pour rester monotone). Les débordements
+     * 16 bits sont absorbés par l'arithmétique modulo; un saut trop grand (remise à zéro, échange de carte)
+     * recale simplement la référence. Le compteur persisté permet de créditer l'énergie consommée pendant
+     * un redémarrage de l'ESP.
+     */
+    class EnergyIntegrator {
+    public:
+        static constexpr uint32_t STATE_VERSION = 2;
+        static constexpr double COUNTER_STEP_KWH = 0.1;
+        static constexpr uint32_t MAX_INTEGRATION_GAP_MS = 5 * 60 * 1000;   // au-delà (lien coupé), pas d'intégration
+        static constexpr uint16_t MAX_COUNTER_JUMP = 1000;                  // 100 kWh entre deux trames: pas crédible
+
+        /**
+         * @brief Reprend l'état sauvegardé (ignoré si la version ne correspond pas)
+         * @return true si l'état a été repris
+         */
+        bool restore(const EnergyIntegratorState& saved);
+
+        /**
+         * @brief Nouvelle trame 0x06
+         * @param inputPowerW puissance instantanée (W)
+         * @param counterRaw compteur brut de la PAC (dixièmes de kWh, 16 bits)
+         */
+        void update(float inputPowerW, uint16_t counterRaw, uint32_t nowMs);
+
+        /// Énergie totale (kWh), monotone
+        double total() const { return this->state_.totalKwh + this->residualKwh_; }
+        /// État à persister, résidu compris (le total restauré ne recule pas sous le dernier total publié)
+        EnergyIntegratorState state() const;
+
+        uint32_t get_wraps() const { return this->wraps_; }
+        uint32_t get_resets() const { return this->resets_; }
+
+    private:
+        EnergyIntegratorState state_{ STATE_VERSION, 0.0, 0, false, false, 0.0f };
+        double residualKwh_ = 0.0;          // intégré depuis le dernier pas du compteur (compteur actif)
+        double sinceCounterKwh_ = 0.0;      // intégré depuis le dernier pas, déjà versé au total (compteur inactif)
+        float lastPowerW_ = 0.0f;
+        uint32_t lastUpdateMs_ = 0;
+        bool hasLastSample_ = false;
+        uint32_t wraps_ = 0;
+        uint32_t resets_ = 0;
+    };
+
+}
@@ -28,9 +28,7 @@ void CN105Climate::set_vertical_vane_select(
         ESP_LOGD("EVT", "vane.control() -> Demande un chgt de réglage de la vane: %s", setting);
 
         this->setVaneSetting(setting);
-        this->wantedSettings.hasChanged = true;
-        this->wantedSettings.hasBeenSent = false;
-        this->wantedSettings.lastChange = CUSTOM_MILLIS;
+        this->commitWantedSettings();
         });
 
 }
@@ -64,9 +62,7 @@ void CN105Climate::set_horizontal_vane_select(
         ESP_LOGD("EVT", "wideVane.control() -> Demande un chgt de réglage de la wideVane: %s", setting);
 
         this->setWideVaneSetting(setting);
-        this->wantedSettings.hasChanged = true;
-        this->wantedSettings.hasBeenSent = false;
-        this->wantedSettings.lastChange = CUSTOM_MILLIS;
+        this->commitWantedSettings();
         });
 
 }
@@ -87,6 +83,7 @@ void CN105Climate::set_airflow_control_select(
             this->wantedRunStates.hasChanged = true;
             this->wantedRunStates.hasBeenSent = false;
             this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+            this->wakeLoop();
         } else {
             this->airflow_control_select_->publish_state(this->currentRunStates.airflow_control);
         }
@@ -94,27 +91,82 @@ void CN105Climate::set_airflow_control_select(
 }
 
 void CN105Climate::set_compressor_frequency_sensor(
-    sensor::Sensor* compressor_frequency_sensor) {
+    ThrottledSensor* compressor_frequency_sensor) {
     this->compressor_frequency_sensor_ = compressor_frequency_sensor;
 }
 
 void CN105Climate::set_input_power_sensor(
-    sensor::Sensor* input_power_sensor) {
+    ThrottledSensor* input_power_sensor) {
     this->input_power_sensor_ = input_power_sensor;
 }
 
 void CN105Climate::set_kwh_sensor(
-    sensor::Sensor* kwh_sensor) {
+    ThrottledSensor* kwh_sensor) {
     this->kwh_sensor_ = kwh_sensor;
 }
 
+void CN105Climate::set_total_energy_sensor(
+    ThrottledSensor* total_energy_sensor) {
+    this->total_energy_sensor_ = total_energy_sensor;
+}
+
+void CN105Climate::setupEnergyIntegrator() {
+    if (this->total_energy_sensor_ == nullptr) {
+        return;
+    }
+    // une préférence par instance (plusieurs PAC sur un même ESP), en flash pour survivre aux coupures
+    this->energy_pref_ = global_preferences->make_preference<EnergyIntegratorState>(
+        this->get_object_id_hash() ^ ENERGY_PREF_HASH_SALT, true);
+    EnergyIntegratorState saved{};
+    if (this->energy_pref_.load(&saved) && this->energy_integrator_.restore(saved)) {
+        ESP_LOGI(TAG, "total energy restored: %.3f kWh (hardware counter %s, last raw %u)",
+            this->energy_integrator_.total(), saved.counterActive ? "active" : "not seen moving", saved.lastCounter);
+        this->total_energy_sensor_->publish_if_due((float)this->energy_integrator_.total(), CUSTOM_MILLIS);
+    } else {
+        ESP_LOGI(TAG, "total energy: no saved state, starting from 0 kWh");
+    }
+    this->energy_saved_kwh_ = this->energy_integrator_.total();
+    this->energy_saved_ms_ = CUSTOM_MILLIS;
+}
+
+void CN105Climate::updateEnergyIntegrator(float inputPowerW, uint16_t counterRaw) {
+    if (this->total_energy_sensor_ == nullptr) {
+        return;
+    }
+    this->energy_integrator_.update(inputPowerW, counterRaw, CUSTOM_MILLIS);
+    this->saveEnergyIntegrator(false);
+}
+
+void CN105Climate::saveEnergyIntegrator(bool force) {
+    if (this->total_energy_sensor_ == nullptr) {
+        return;
+    }
+    const uint32_t now = CUSTOM_MILLIS;
+    const uint32_t elapsed = now - this->energy_saved_ms_;
+    const double delta = this->energy_integrator_.total() - this->energy_saved_kwh_;
+    const bool due = (delta >= ENERGY_SAVE_MIN_DELTA_KWH && elapsed >= ENERGY_SAVE_MIN_INTERVAL_MS) ||
+        (delta > 0 && elapsed >= ENERGY_SAVE_MAX_INTERVAL_MS);
+    if (!force && !due) {
+        return;
+    }
+    // résidu intégré compris: après un reboot le total repart exactement de la dernière valeur sauvegardée
+    const EnergyIntegratorState state = this->energy_integrator_.state();
+    this->energy_pref_.save(&state);
+    if (force) {
+        global_preferences->sync();
+    }
+    this->energy_saved_kwh_ = this->energy_integrator_.total();
+    this->energy_saved_ms_ = now;
+    ESP_LOGD(TAG, "total energy saved: %.3f kWh", this->energy_saved_kwh_);
+}
+
 void CN105Climate::set_runtime_hours_sensor(
-    sensor::Sensor* runtime_hours_sensor) {
+    ThrottledSensor* runtime_hours_sensor) {
     this->runtime_hours_sensor_ = runtime_hours_sensor;
 }
 
 void CN105Climate::set_outside_air_temperature_sensor(
-    sensor::Sensor* outside_air_temperature_sensor) {
+    ThrottledSensor* outside_air_temperature_sensor) {
     this->outside_air_temperature_sensor_ = outside_air_temperature_sensor;
 }
 
@@ -156,10 +208,10 @@ void CN105Climate::set_functions_set_button(FunctionsButton* Button) {
         }
 
         ESP_LOGI(LOG_CYCLE_TAG, "Setting code %i to value %i", this->functions_code_, this->functions_value_);
-        functions.setValue(this->functions_code_, this->functions_value_);
-
-        // Now send the codes.
-        this->setFunctions(functions);
+        // écriture + relecture de vérification, sans attendre le debounce
+        if (this->stageFunction(this->functions_code_, this->functions_value_)) {
+            this->commitFunctions();
+        }
 
         });
 }
@@ -188,6 +240,7 @@ void CN105Climate::set_air_purifier_switch(HVACOptionSwitch* Switch) {
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->wakeLoop();
         });
 }
 
@@ -199,6 +252,7 @@ void CN105Climate::set_night_mode_switch(HVACOptionSwitch* Switch) {
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->wakeLoop();
         });
 }
 
@@ -210,6 +264,7 @@ void CN105Climate::set_circulator_switch(HVACOptionSwitch* Switch) { // only in
         this->wantedRunStates.hasChanged = true;
         this->wantedRunStates.hasBeenSent = false;
         this->wantedRunStates.lastChange = CUSTOM_MILLIS;
+        this->wakeLoop();
         });
 }
 
@@ -237,12 +292,8 @@ void CN105Climate::add_hardware_setting(HardwareSettingSelect* setting) {
     setting->setCallbackFunction([this, setting](const std::string& value, int int_value) {
         ESP_LOGI(LOG_FUNCTIONS_TAG, "Hardware setting change: Code %d -> %d (%s)", setting->get_code(), int_value, value.c_str());
 
-        // Optimistic update done in component
-
-        // Update internal structure
-        this->functions.setValue(setting->get_code(), int_value);
-
-        // Trigger write to device
-        this->setFunctions(this->functions);
+        // Staged: the changes made within FUNCTIONS_TX_DEBOUNCE_MS are written together, then read back.
+        // The select follows the value read back, so a rejected change reverts in HA.
+        this->stageFunction(setting->get_code(), int_value);
         });
 }
@@ -4,11 +4,8 @@
 
 namespace esphome {
 
-    HardwareSettingSelect::HardwareSettingSelect(int code, const std::map<int, std::string>& options)
-        : code_(code), mapping_(options) {
-        for (auto const& [val, label] : options) {
-            reverse_mapping_[label] = val;
-        }
+    HardwareSettingSelect::HardwareSettingSelect(int code, const char* label1, const char* label2, const char* label3)
+        : code_(code), labels_{ nullptr, label1, label2, label3 } {
     }
 
     void HardwareSettingSelect::setCallbackFunction(CallbackFunction&& callback) {
@@ -20,13 +17,12 @@ namespace esphome {
     void HardwareSettingSelect::update_state_from_value(int value) {
         ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d update request with value: %d", this->code_, value);
 
-        auto it = this->mapping_.find(value);
-        if (it == this->mapping_.end()) {
-        ESP_LOGW(LOG_HARDWARE_SELECT_TAG, "Code %d received unknown value: %d", this->code_, value);
+        if (value < 1 || value > MAX_VALUE || this->labels_[value] == nullptr) {
+            ESP_LOGW(LOG_HARDWARE_SELECT_TAG, "Code %d received unknown value: %d", this->code_, value);
             return;
         }
 
-        const std::string &new_state = it->second;
+        const char* new_state = this->labels_[value];
 
         bool changed = false;
         const char *cur_opt = nullptr;
@@ -35,12 +31,12 @@ namespace esphome {
             // 2026.1+ : current_option() -> StringRef
             auto cur = this->current_option();
             cur_opt = cur.c_str();
-            changed = cur_opt == nullptr || std::strcmp(cur_opt, new_state.c_str()) != 0;
+            changed = cur_opt == nullptr || std::strcmp(cur_opt, new_state) != 0;
         
         #elif ESPHOME_VERSION_CODE >= VERSION_CODE(2025, 11, 0)
             // 2025.11 .. 2025.12 : current_option() -> const char*
             cur_opt = this->current_option();
-            changed = cur_opt == nullptr || std::strcmp(cur_opt, new_state.c_str()) != 0;
+            changed = cur_opt == nullptr || std::strcmp(cur_opt, new_state) != 0;
         
         #else
             // < 2025.11 : no current_option(), use state
@@ -49,10 +45,10 @@ namespace esphome {
         #endif
         
         if (changed) {
-            ESP_LOGI(LOG_HARDWARE_SELECT_TAG, "Code %d state changed: %s -> %s (val: %d)", this->code_, (cur_opt ? cur_opt : "<none>"), new_state.c_str(), value);
+            ESP_LOGI(LOG_HARDWARE_SELECT_TAG, "Code %d state changed: %s -> %s (val: %d)", this->code_, (cur_opt ? cur_opt : "<none>"), new_state, value);
             this->publish_state(new_state);
         } else {
-            ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d state unchanged: %s (val: %d)", this->code_, new_state.c_str(), value);
+            ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d state unchanged: %s (val: %d)", this->code_, new_state, value);
         }
     }
 
@@ -64,8 +60,14 @@ namespace esphome {
         }
 
         ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d control request: %s", this->code_, value.c_str());
-        if (this->reverse_mapping_.count(value)) {
-            int int_value = this->reverse_mapping_[value];
+        int int_value = 0;
+        for (int v = 1; v <= MAX_VALUE; v++) {
+            if (this->labels_[v] != nullptr && value == this->labels_[v]) {
+                int_value = v;
+                break;
+            }
+        }
+        if (int_value != 0) {
             if (callback_) {
                 ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d calling callback with val: %d", this->code_, int_value);
                 callback_(value, int_value);
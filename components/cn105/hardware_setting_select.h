@@ -2,7 +2,6 @@
 
 #include "esphome/components/select/select.h"
 #include "esphome/core/component.h"
-#include <map>
 #include <vector>
 #include <functional>
 #include <string>
@@ -13,7 +12,10 @@ namespace esphome {
     public:
         using CallbackFunction = std::function<void(const std::string& value, int int_value)>;
 
-        HardwareSettingSelect(int code, const std::map<int, std::string>& options);
+        static constexpr int MAX_VALUE = 3;     // valeurs de fonction 1..3
+
+        // labels des valeurs 1, 2, 3 (nullptr si la valeur n'est pas proposée), littéraux générés par climate.py
+        HardwareSettingSelect(int code, const char* label1, const char* label2, const char* label3);
 
         void setCallbackFunction(CallbackFunction&& callback);
 
@@ -29,8 +31,7 @@ namespace esphome {
         void control(const std::string& value) override;
 
         int code_;
-        std::map<int, std::string> mapping_;
-        std::map<std::string, int> reverse_mapping_;
+        const char* labels_[MAX_VALUE + 1];     // indexé par la valeur, labels_[0] inutilisé
         CallbackFunction callback_;
         bool enabled_{ true };
     };
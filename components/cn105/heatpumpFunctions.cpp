@@ -37,6 +37,16 @@ void CN105Climate::functionsArrived() {
 
     // Called after 2nd packet has arrived.
 
+    // le bloc relu toutes les 24h est presque toujours identique: rien à republier
+    const uint32_t hash = this->functions.hash();
+    if (this->functions_published_valid_ && hash == this->functions_published_.hash()) {
+        ESP_LOGD(LOG_FUNCTIONS_TAG, "Functions unchanged (hash %08x)", (unsigned)hash);
+        return;
+    }
+    const uint32_t changed = this->functions_published_valid_ ? this->functions.changedCodes(this->functions_published_) : UINT32_MAX;
+    this->functions_published_ = this->functions;
+    this->functions_published_valid_ = true;
+
     char states[256];
     states[0] = '\0';  // Initialize as empty string
     size_t remaining = sizeof(states);
@@ -64,8 +74,11 @@ void CN105Climate::functionsArrived() {
         this->Functions_sensor_->publish_state(states);
     }
 
-    // Update Hardware Settings Selects
+    // Update Hardware Settings Selects (only the codes whose value changed)
     for (auto* setting : this->hardware_settings_) {
+        if (!(changed & (1u << (setting->get_code() - MIN_FUNCTION_CODE)))) {
+            continue;
+        }
         int val = functions.getValue(setting->get_code());
         if (val > 0) {
             setting->update_state_from_value(val);
@@ -73,59 +86,230 @@ void CN105Climate::functionsArrived() {
             ESP_LOGD(LOG_HARDWARE_SELECT_TAG, "Code %d received unknown value: %d", setting->get_code(), val);
         }
     }
+
+    this->saveFunctionsCache();
 }
 
-bool CN105Climate::setFunctions(heatpumpFunctions const& functions) {
-    if (!functions.isValid()) {
-        return false;
+void CN105Climate::setupFunctionsCache() {
+    if (this->hardware_settings_.empty() && this->Functions_sensor_ == nullptr) {
+        return;
     }
+    this->functions_pref_ = global_preferences->make_preference<functionsCache>(
+        this->get_object_id_hash() ^ FUNCTIONS_PREF_HASH_SALT, true);
 
-    uint8_t packet1[PACKET_LEN] = {};
-    uint8_t packet2[PACKET_LEN] = {};
+    functionsCache saved{};
+    if (!this->functions_pref_.load(&saved) || saved.version != FUNCTIONS_CACHE_VERSION) {
+        return;
+    }
+    heatpumpFunctions cached;
+    cached.setData1(saved.data1);
+    cached.setData2(saved.data2);
+    if (cached.hash() != saved.hash) {
+        ESP_LOGW(LOG_FUNCTIONS_TAG, "Functions cache is stale, reading 0x20/0x22 from the unit");
+        return;
+    }
 
-    prepareSetPacket(packet1, PACKET_LEN);
-    packet1[5] = FUNCTIONS_SET_PART1;
+    ESP_LOGI(LOG_FUNCTIONS_TAG, "Functions restored from cache (hash %08x), next 0x20/0x22 read in %u ms",
+        (unsigned)saved.hash, (unsigned)this->hardware_settings_interval_ms_);
+    this->functions_saved_hash_ = saved.hash;
+    this->functions = cached;
+    this->functionsArrived();
+    // pas d'aller-retour 0x20/0x22 au boot: relecture à l'intervalle normal
+    this->scheduler_.mark_requested(0x20);
+    this->scheduler_.mark_requested(0x22);
+}
 
-    prepareSetPacket(packet2, PACKET_LEN);
-    packet2[5] = FUNCTIONS_SET_PART2;
+void CN105Climate::saveFunctionsCache() {
+    if (!this->functions.isValid()) {
+        return;
+    }
+    const uint32_t hash = this->functions.hash();
+    if (hash == this->functions_saved_hash_ || (this->hardware_settings_.empty() && this->Functions_sensor_ == nullptr)) {
+        return;
+    }
+    functionsCache cache{};
+    cache.version = FUNCTIONS_CACHE_VERSION;
+    cache.hash = hash;
+    this->functions.getData1(cache.data1);
+    this->functions.getData2(cache.data2);
+    if (this->functions_pref_.save(&cache)) {
+        this->functions_saved_hash_ = hash;
+        ESP_LOGD(LOG_FUNCTIONS_TAG, "Functions cache saved (hash %08x)", (unsigned)hash);
+    }
+}
 
-    functions.getData1(&packet1[6]);
-    functions.getData2(&packet2[6]);
+void CN105Climate::sendFunctionsPart(const heatpumpFunctions& block, uint8_t setCode) {
+    uint8_t packet[PACKET_LEN] = {};
+    prepareSetPacket(packet, PACKET_LEN);
+    packet[5] = setCode;
+    if (setCode == FUNCTIONS_SET_PART1) {
+        block.getData1(&packet[6]);
+    } else {
+        block.getData2(&packet[6]);
+    }
+    packet[21] = checkSum(packet, 21);
+    writePacket(packet, PACKET_LEN);
+}
+
+bool CN105Climate::stageFunction(int code, int value) {
+    if (code < MIN_FUNCTION_CODE || code > MAX_FUNCTION_CODE || value < 1 || value > 3) {
+        ESP_LOGW(LOG_FUNCTIONS_TAG, "Function %d = %d out of range, not staged", code, value);
+        return false;
+    }
+    auto& tx = this->functions_tx_;
+    const int i = code - MIN_FUNCTION_CODE;
+    tx.values[i] = (uint8_t)value;
+    tx.stagedMask |= 1u << i;
+    tx.stagedMs = CUSTOM_MILLIS;
+    if (tx.state == FunctionsTxState::IDLE) {
+        tx.state = FunctionsTxState::STAGED;
+    }
+    ESP_LOGD(LOG_FUNCTIONS_TAG, "Staged function %d = %d", code, value);
+    this->wakeLoop();
+    return true;
+}
 
-    // sanity check, we expect data byte 15 (index 20) to be 0
-    // REMOVED for Bug #485 - newer units use these bytes
-    // if (packet1[20] != 0 || packet2[20] != 0)
-    //    return false;
+void CN105Climate::commitFunctions() {
+    if (this->functions_tx_.state == FunctionsTxState::STAGED) {
+        this->functions_tx_.stagedMs = CUSTOM_MILLIS - FUNCTIONS_TX_DEBOUNCE_MS;
+        this->wakeLoop();
+    }
+}
 
-    // make sure all the other data bytes are set
-    // REMOVED for Bug #485
-    /* for (int i = 6; i < 20; ++i) {
-        if (packet1[i] == 0 || packet2[i] == 0)
-            return false;
-    } */
+void CN105Climate::startFunctionsTransaction() {
+    auto& tx = this->functions_tx_;
+    tx.startedMs = CUSTOM_MILLIS;
+    if (!this->functions.isValid()) {
+        if (this->scheduler_.is_disabled(FUNCTIONS_GET_PART1) || this->scheduler_.is_disabled(FUNCTIONS_GET_PART2)) {
+            tx.writingMask = tx.stagedMask;
+            memcpy(tx.writing, tx.values, sizeof(tx.writing));
+            tx.stagedMask = 0;
+            this->finishFunctionsTransaction("functions not supported by the unit");
+        } else {
+            // rien sur quoi appliquer les changements avant la première lecture 0x20/0x22
+            ESP_LOGD(LOG_FUNCTIONS_TAG, "Functions not read yet, staged changes wait");
+            tx.stagedMs = CUSTOM_MILLIS;
+        }
+        return;
+    }
 
-    packet1[21] = checkSum(packet1, 21);
-    packet2[21] = checkSum(packet2, 21);
-    /*
-        while (!canSend(false)) {
-            //esphome::CUSTOM_DELAY(10);
-            CUSTOM_DELAY(10);
-        }*/
-    ESP_LOGD(TAG, "sending a setFunctions packet part 1");
-    writePacket(packet1, PACKET_LEN);
-    //readPacket();
+    // un seul read-modify-write pour tous les changements, sur la dernière copie connue du bloc
+    tx.block = this->functions;
+    tx.writingMask = 0;
+    tx.rejectedMask = 0;
+    for (int i = 0; i <= MAX_FUNCTION_CODE - MIN_FUNCTION_CODE; i++) {
+        const uint32_t bit = 1u << i;
+        if (!(tx.stagedMask & bit)) {
+            continue;
+        }
+        tx.writing[i] = tx.values[i];
+        tx.writingMask |= bit;
+        if (!tx.block.setValue(i + MIN_FUNCTION_CODE, tx.values[i])) {
+            tx.rejectedMask |= bit;     // code absent du bloc de cette unité
+        }
+    }
+    tx.stagedMask = 0;
+    if (tx.rejectedMask == tx.writingMask) {
+        this->finishFunctionsTransaction(nullptr);
+        return;
+    }
 
-    /*while (!canSend(false)) {
-        //esphome::CUSTOM_DELAY(10);
-        CUSTOM_DELAY(10);
-    }*/
-    ESP_LOGD(TAG, "sending a setFunctions packet part 2");
-    writePacket(packet2, PACKET_LEN);
-    //readPacket();
+    ESP_LOGI(LOG_FUNCTIONS_TAG, "Writing functions transaction (mask %08x)", (unsigned)(tx.writingMask & ~tx.rejectedMask));
+    tx.state = FunctionsTxState::WRITE_PART1;
+    this->sendFunctionsPart(tx.block, FUNCTIONS_SET_PART1);
+    this->set_timeout("functionsTx", FUNCTIONS_TX_STEP_TIMEOUT_MS, [this]() { this->finishFunctionsTransaction("no reply from the unit"); });
+}
 
-    return true;
+void CN105Climate::functionsTransactionAck() {
+    auto& tx = this->functions_tx_;
+    const uint8_t expected = (tx.state == FunctionsTxState::WRITE_PART1) ? FUNCTIONS_SET_PART1 :
+        (tx.state == FunctionsTxState::WRITE_PART2) ? FUNCTIONS_SET_PART2 : 0;
+    if (expected != 0 && (this->last_write_command_ != 0x41 || this->last_write_code_ != expected)) {
+        // ACK d'une autre écriture (température distante, proxy...): la moitié en cours n'est pas acquittée
+        ESP_LOGD(LOG_FUNCTIONS_TAG, "0x61 for 0x%02X/0x%02X ignored, waiting for the 0x%02X ack",
+            this->last_write_command_, this->last_write_code_, expected);
+        return;
+    }
+    if (tx.state == FunctionsTxState::WRITE_PART1) {
+        tx.state = FunctionsTxState::WRITE_PART2;
+        this->sendFunctionsPart(tx.block, FUNCTIONS_SET_PART2);
+    } else if (tx.state == FunctionsTxState::WRITE_PART2) {
+        // les deux moitiés acquittées: relecture pour vérifier ce que l'unité a vraiment retenu
+        tx.state = FunctionsTxState::READ_PART1;
+        this->buildAndSendInfoPacket(FUNCTIONS_GET_PART1);
+    } else {
+        return;
+    }
+    this->set_timeout("functionsTx", FUNCTIONS_TX_STEP_TIMEOUT_MS, [this]() { this->finishFunctionsTransaction("no reply from the unit"); });
+}
+
+bool CN105Climate::functionsTransactionResponse(uint8_t code) {
+    auto& tx = this->functions_tx_;
+    if (this->dataLength != 0x10) {
+        return false;
+    }
+    if (tx.state == FunctionsTxState::READ_PART1 && code == FUNCTIONS_GET_PART1) {
+        tx.block.setData1(&this->data[1]);
+        tx.state = FunctionsTxState::READ_PART2;
+        this->buildAndSendInfoPacket(FUNCTIONS_GET_PART2);
+        this->set_timeout("functionsTx", FUNCTIONS_TX_STEP_TIMEOUT_MS, [this]() { this->finishFunctionsTransaction("no reply from the unit"); });
+        return true;
+    }
+    if (tx.state == FunctionsTxState::READ_PART2 && code == FUNCTIONS_GET_PART2) {
+        tx.block.setData2(&this->data[1]);
+        for (int i = 0; i <= MAX_FUNCTION_CODE - MIN_FUNCTION_CODE; i++) {
+            if ((tx.writingMask & (1u << i)) && tx.block.getValue(i + MIN_FUNCTION_CODE) != tx.writing[i]) {
+                tx.rejectedMask |= 1u << i;
+            }
+        }
+        // le bloc relu devient la référence: selects, text sensor et cache suivent ce que l'unité a retenu
+        this->functions = tx.block;
+        this->functionsArrived();
+        this->finishFunctionsTransaction(nullptr);
+        return true;
+    }
+    return false;
 }
 
+void CN105Climate::finishFunctionsTransaction(const char* failure) {
+    auto& tx = this->functions_tx_;
+    this->cancel_timeout("functionsTx");
+
+    char accepted[128] = "";
+    char rejected[128] = "";
+    size_t acceptedLen = 0, rejectedLen = 0;
+    for (int i = 0; i <= MAX_FUNCTION_CODE - MIN_FUNCTION_CODE; i++) {
+        if (!(tx.writingMask & (1u << i))) {
+            continue;
+        }
+        const bool ok = failure == nullptr && !(tx.rejectedMask & (1u << i));
+        char* out = ok ? accepted : rejected;
+        size_t& len = ok ? acceptedLen : rejectedLen;
+        int written = snprintf(out + len, sizeof(accepted) - len, "%s%d=%d", len ? " " : "", i + MIN_FUNCTION_CODE, tx.writing[i]);
+        if (written > 0 && len + written < sizeof(accepted)) {
+            len += written;
+        }
+    }
+
+    char result[300];
+    if (failure != nullptr) {
+        snprintf(result, sizeof(result), "Failed (%s): %s", failure, rejected);
+        ESP_LOGE(LOG_FUNCTIONS_TAG, "Functions transaction %s", result);
+    } else if (rejectedLen > 0) {
+        snprintf(result, sizeof(result), "Rejected: %s%s%s", rejected, acceptedLen ? "; Accepted: " : "", accepted);
+        ESP_LOGW(LOG_FUNCTIONS_TAG, "Functions transaction in %u ms. %s", (unsigned)(CUSTOM_MILLIS - tx.startedMs), result);
+    } else {
+        snprintf(result, sizeof(result), "Accepted: %s", accepted);
+        ESP_LOGI(LOG_FUNCTIONS_TAG, "Functions transaction in %u ms. %s", (unsigned)(CUSTOM_MILLIS - tx.startedMs), result);
+    }
+    if (this->hardware_settings_result_sensor_ != nullptr) {
+        this->hardware_settings_result_sensor_->publish_state(result);
+    }
+
+    tx.writingMask = 0;
+    tx.rejectedMask = 0;
+    tx.state = (tx.stagedMask != 0) ? FunctionsTxState::STAGED : FunctionsTxState::IDLE;
+}
 
 heatpumpFunctions::heatpumpFunctions() {
     clear();
@@ -138,11 +322,13 @@ bool heatpumpFunctions::isValid() const {
 void heatpumpFunctions::setData1(uint8_t* data) {
     memcpy(raw, data, 15);
     _isValid1 = true;
+    reindex();
 }
 
 void heatpumpFunctions::setData2(uint8_t* data) {
     memcpy(raw + 15, data, 15);
     _isValid2 = true;
+    reindex();
 }
 
 void heatpumpFunctions::getData1(uint8_t* data) const {
@@ -157,6 +343,18 @@ void heatpumpFunctions::clear() {
     memset(raw, 0, sizeof(raw));
     _isValid1 = false;
     _isValid2 = false;
+    reindex();
+}
+
+void heatpumpFunctions::reindex() {
+    memset(index, 0xFF, sizeof(index));
+    for (int i = 0; i < MAX_FUNCTION_CODE_COUNT; ++i) {
+        int code = getCode(raw[i]);
+        // first occurrence wins, as the former linear scan did
+        if (code >= MIN_FUNCTION_CODE && code <= MAX_FUNCTION_CODE && index[code - MIN_FUNCTION_CODE] == 0xFF) {
+            index[code - MIN_FUNCTION_CODE] = i;
+        }
+    }
 }
 
 int heatpumpFunctions::getCode(uint8_t b) {
@@ -167,33 +365,45 @@ int heatpumpFunctions::getValue(uint8_t b) {
     return b & 3;
 }
 
-int heatpumpFunctions::getValue(int code) {
-    if (code > 128 || code < 101)
+int heatpumpFunctions::getValue(int code) const {
+    if (code > MAX_FUNCTION_CODE || code < MIN_FUNCTION_CODE)
         return 0;
 
-    for (int i = 0; i < MAX_FUNCTION_CODE_COUNT; ++i) {
-        if (getCode(raw[i]) == code)
-            return getValue(raw[i]);
-    }
-
-    return 0;
+    uint8_t i = index[code - MIN_FUNCTION_CODE];
+    return (i == 0xFF) ? 0 : getValue(raw[i]);
 }
 
 bool heatpumpFunctions::setValue(int code, int value) {
-    if (code > 128 || code < 101)
+    if (code > MAX_FUNCTION_CODE || code < MIN_FUNCTION_CODE)
         return false;
 
     if (value < 1 || value > 3)
         return false;
 
+    uint8_t i = index[code - MIN_FUNCTION_CODE];
+    if (i == 0xFF)
+        return false;
+
+    raw[i] = ((code - 100) << 2) + value;
+    return true;
+}
+
+uint32_t heatpumpFunctions::hash() const {
+    uint32_t h = 2166136261u;
     for (int i = 0; i < MAX_FUNCTION_CODE_COUNT; ++i) {
-        if (getCode(raw[i]) == code) {
-            raw[i] = ((code - 100) << 2) + value;
-            return true;
-        }
+        h = (h ^ raw[i]) * 16777619u;
     }
+    return h;
+}
 
-    return false;
+uint32_t heatpumpFunctions::changedCodes(const heatpumpFunctions& other) const {
+    uint32_t changed = 0;
+    for (int code = MIN_FUNCTION_CODE; code <= MAX_FUNCTION_CODE; ++code) {
+        if (getValue(code) != other.getValue(code)) {
+            changed |= 1u << (code - MIN_FUNCTION_CODE);
+        }
+    }
+    return changed;
 }
 
 heatpumpFunctionCodes heatpumpFunctions::getAllCodes() {
@@ -208,7 +418,7 @@ heatpumpFunctionCodes heatpumpFunctions::getAllCodes() {
 }
 
 bool heatpumpFunctions::operator==(const heatpumpFunctions& rhs) {
-    return this->isValid() == rhs.isValid() && memcmp(this->raw, rhs.raw, MAX_FUNCTION_CODE_COUNT * sizeof(int)) == 0;
+    return this->isValid() == rhs.isValid() && memcmp(this->raw, rhs.raw, sizeof(this->raw)) == 0;
 }
 
 bool heatpumpFunctions::operator!=(const heatpumpFunctions& rhs) {
@@ -4,6 +4,8 @@
 
 
 #define MAX_FUNCTION_CODE_COUNT 30
+#define MIN_FUNCTION_CODE 101
+#define MAX_FUNCTION_CODE 128
 
 struct heatpumpFunctionCodes {
     bool valid[MAX_FUNCTION_CODE_COUNT];
@@ -16,11 +18,14 @@ struct heatpumpFunctionCodes {
 class heatpumpFunctions {
 private:
     uint8_t raw[MAX_FUNCTION_CODE_COUNT];
+    // position in raw[] for each code (code - MIN_FUNCTION_CODE), 0xFF when absent
+    uint8_t index[MAX_FUNCTION_CODE - MIN_FUNCTION_CODE + 1];
     bool _isValid1;
     bool _isValid2;
 
-    int getCode(uint8_t b);
-    int getValue(uint8_t b);
+    static int getCode(uint8_t b);
+    static int getValue(uint8_t b);
+    void reindex();
 
 public:
     heatpumpFunctions();
@@ -35,11 +40,34 @@ public:
 
     void clear();
 
-    int getValue(int code);
+    int getValue(int code) const;
     bool setValue(int code, int value);
 
+    // FNV-1a of the 30 raw bytes: identifies a functions block (cache, change detection)
+    uint32_t hash() const;
+    // bit (code - MIN_FUNCTION_CODE) set for each code whose value differs from other
+    uint32_t changedCodes(const heatpumpFunctions& other) const;
+
     heatpumpFunctionCodes getAllCodes();
 
     bool operator==(const heatpumpFunctions& rhs);
     bool operator!=(const heatpumpFunctions& rhs);
 };
+
+enum class FunctionsTxState : uint8_t { IDLE, STAGED, WRITE_PART1, WRITE_PART2, READ_PART1, READ_PART2 };
+
+// Batched functions write: staged code/value changes, written once (0x1F + 0x21), verified by reading back 0x20/0x22
+struct heatpumpFunctionsTransaction {
+    FunctionsTxState state = FunctionsTxState::IDLE;
+    uint32_t stagedMask = 0;                    // bit (code - MIN_FUNCTION_CODE)
+    uint8_t values[MAX_FUNCTION_CODE - MIN_FUNCTION_CODE + 1] = {};
+    uint32_t stagedMs = 0;                      // last staged change (debounce)
+    // changes being written: staging goes on for the next transaction meanwhile
+    uint32_t writingMask = 0;
+    uint8_t writing[MAX_FUNCTION_CODE - MIN_FUNCTION_CODE + 1] = {};
+    uint32_t rejectedMask = 0;
+    uint32_t startedMs = 0;
+    heatpumpFunctions block;                    // block written, then block read back
+
+    bool inFlight() const { return state != FunctionsTxState::IDLE && state != FunctionsTxState::STAGED; }
+};
@@ -1,5 +1,8 @@
 #include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
+#include <math.h>
+#include <unistd.h>
 #include "hp_emulator_idf.h"
 #include "esphome/components/uart/uart_component_esp_idf.h"
 #include "cn105.h"
@@ -8,17 +11,18 @@
 #include "esp_timer.h"
 #include "esp_netif.h"
 #include "esp_http_server.h"
+#ifdef WEBPORT
+#include "emulator_web_assets.h"
+#endif
 
 
-// Global pointer to CN105Climate instance
-esphome::CN105Climate* g_cn105 = nullptr;
-// Global pointer to RE_UART - set from main.cpp after RE_UART is configured
-esphome::uart::IDFUARTComponent* g_re_uart = nullptr;
-
 namespace HVAC {
 
 static const char *TAG = "HPE_Core";
 
+// proxy mode: how long a forwarded setting is served from the cache while waiting for the heatpump to report it
+static const uint64_t PROXY_HOLD_MS = 10000;
+
 // Helper function to check if all core char* fields in wantedHeatpumpSettings are non-null
 // Returns true if power, mode, fan, vane, and wideVane are all set
 static bool areWantedSettingsIntialized(const wantedHeatpumpSettings& settings) {
@@ -92,57 +96,57 @@ void HPEmulator::getEsphomeStatefromEngine() {
     int index;
     HeatpumpState tempState;
     
-    if (g_cn105 == nullptr) {
-        ESP_LOGE(TAG, "g_cn105 is null, cannot get ESPHome state");
+    if (cn105 == nullptr) {
+        ESP_LOGE(TAG, "no climate bound, cannot get ESPHome state");
         return;
         }
 
-    if (!areCurrentSettingsIntialized(g_cn105->currentSettings)) {
+    if (!areCurrentSettingsIntialized(cn105->currentSettings)) {
         ESP_LOGD(TAG, "Current settings are not initialized");
         return;
         }
     // Print currentSettings from CN105Climate (now public - KIRBY)
     // ESP_LOGD(TAG, "ESPHome currentSettings:");
-    // ESP_LOGD(TAG, "  power: %s", g_cn105->currentSettings.power ? g_cn105->currentSettings.power : "null");
-    // ESP_LOGD(TAG, "  mode: %s", g_cn105->currentSettings.mode ? g_cn105->currentSettings.mode : "null");
-    // ESP_LOGD(TAG, "  temperature: %.1f", g_cn105->currentSettings.temperature);
-    // ESP_LOGD(TAG, "  fan: %s", g_cn105->currentSettings.fan ? g_cn105->currentSettings.fan : "null");
-    // ESP_LOGD(TAG, "  vane: %s", g_cn105->currentSettings.vane ? g_cn105->currentSettings.vane : "null");
-    // ESP_LOGD(TAG, "  wideVane: %s", g_cn105->currentSettings.wideVane ? g_cn105->currentSettings.wideVane : "null");
+    // ESP_LOGD(TAG, "  power: %s", cn105->currentSettings.power ? cn105->currentSettings.power : "null");
+    // ESP_LOGD(TAG, "  mode: %s", cn105->currentSettings.mode ? cn105->currentSettings.mode : "null");
+    // ESP_LOGD(TAG, "  temperature: %.1f", cn105->currentSettings.temperature);
+    // ESP_LOGD(TAG, "  fan: %s", cn105->currentSettings.fan ? cn105->currentSettings.fan : "null");
+    // ESP_LOGD(TAG, "  vane: %s", cn105->currentSettings.vane ? cn105->currentSettings.vane : "null");
+    // ESP_LOGD(TAG, "  wideVane: %s", cn105->currentSettings.wideVane ? cn105->currentSettings.wideVane : "null");
 
     // Temperatures
-    tempState.setTemp = (uint8_t)g_cn105->currentSettings.temperature;
-    tempState.actualTemp = (uint8_t)g_cn105->current_temperature;
+    tempState.setTemp = (uint8_t)cn105->currentSettings.temperature;
+    tempState.actualTemp = (uint8_t)cn105->current_temperature;
     
     // For the others: lookup byte value from string
-    if (g_cn105->currentSettings.power) {
-        index = lookupByteMapIndex(POWER_MAP, 2, g_cn105->currentSettings.power);
+    if (cn105->currentSettings.power) {
+        index = lookupByteMapIndex(POWER_MAP, 2, cn105->currentSettings.power);
         if (index <0) tempState.power = 0;
         else tempState.power = POWER[index];
         }
 
-    if (g_cn105->currentSettings.mode) {
-        index = lookupByteMapIndex(MODE_MAP, 5, g_cn105->currentSettings.mode);
+    if (cn105->currentSettings.mode) {
+        index = lookupByteMapIndex(MODE_MAP, 5, cn105->currentSettings.mode);
         if (index <0) tempState.mode = 0;
         else {
             tempState.mode = MODE[index];
             }
         }
 
-    if (g_cn105->currentSettings.fan) {
-        index = lookupByteMapIndex(FAN_MAP, 6, g_cn105->currentSettings.fan);
+    if (cn105->currentSettings.fan) {
+        index = lookupByteMapIndex(FAN_MAP, 6, cn105->currentSettings.fan);
         if (index <0) tempState.fan = 0;
         else tempState.fan = FAN[index];
         }
 
-    if (g_cn105->currentSettings.vane) {
-        index = lookupByteMapIndex(VANE_MAP, 7, g_cn105->currentSettings.vane);
+    if (cn105->currentSettings.vane) {
+        index = lookupByteMapIndex(VANE_MAP, 7, cn105->currentSettings.vane);
         if (index <0) tempState.vertVane = 0;
         else tempState.vertVane = VANE[index];
         }
 
-    if (g_cn105->currentSettings.wideVane) {
-        index = lookupByteMapIndex(WIDEVANE_MAP, 7, g_cn105->currentSettings.wideVane);
+    if (cn105->currentSettings.wideVane) {
+        index = lookupByteMapIndex(WIDEVANE_MAP, 7, cn105->currentSettings.wideVane);
         if (index <0) tempState.horiVane = 0;
         else tempState.horiVane = WIDEVANE[index];
         }
@@ -163,34 +167,35 @@ void HPEmulator::getEsphomeStatefromEngine() {
     }
 
 void HPEmulator::sendEmulatorStateToEngine() {
-    if (g_cn105 == nullptr) {
-        ESP_LOGE(TAG, "g_cn105 is null, cannot create wanted record");
+    if (cn105 == nullptr) {
+        ESP_LOGE(TAG, "no climate bound, cannot create wanted record");
         return;
         }
 
-    if (!areCurrentSettingsIntialized(g_cn105->currentSettings)) {
+    if (!areCurrentSettingsIntialized(cn105->currentSettings)) {
         ESP_LOGD(TAG, "Emulator Engine is not up, will try again");
         return;
         }
 
-    if (g_cn105->wantedSettings.hasChanged) {
+    if (cn105->getCommittedWantedSettings().hasChanged) {
         ESP_LOGD(TAG, "Another Engine change is in progress, waiting for opportunity");
         return;
         }
 
-    //g_cn105->debugSettings("Wanted Settings at prior to update)", g_cn105->wantedSettings);
+    //cn105->debugSettings("Wanted Settings at prior to update)", cn105->wantedSettings);
 
-    // Now we know the settings match
-    g_cn105->wantedSettings.power = lookupByteMapValue(POWER_MAP, POWER, 2, emulatorState.power);
-    g_cn105->wantedSettings.mode = lookupByteMapValue(MODE_MAP, MODE, 5, emulatorState.mode);
-    g_cn105->wantedSettings.fan = lookupByteMapValue(FAN_MAP, FAN, 6, emulatorState.fan);
-    g_cn105->wantedSettings.temperature = float(emulatorState.setTemp);
-    g_cn105->wantedSettings.vane = lookupByteMapValue(VANE_MAP, VANE, 7,  emulatorState.vertVane);
-    g_cn105->wantedSettings.wideVane = lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 7, emulatorState.horiVane);
+    // Now we know the settings match: build a complete snapshot and publish it in one go
+    wantedHeatpumpSettings snapshot = cn105->wantedSettings;
+    snapshot.power = lookupByteMapValue(POWER_MAP, POWER, 2, emulatorState.power);
+    snapshot.mode = lookupByteMapValue(MODE_MAP, MODE, 5, emulatorState.mode);
+    snapshot.fan = lookupByteMapValue(FAN_MAP, FAN, 6, emulatorState.fan);
+    snapshot.temperature = float(emulatorState.setTemp);
+    snapshot.vane = lookupByteMapValue(VANE_MAP, VANE, 7,  emulatorState.vertVane);
+    snapshot.wideVane = lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 7, emulatorState.horiVane);
   
     //sending state
-    g_cn105->wantedSettings.hasChanged = true;
-    g_cn105->debugSettings("Settings Sent to Engine based on Emulator State", g_cn105->wantedSettings);
+    cn105->publishWantedSettings(snapshot);
+    cn105->debugSettings("Settings Sent to Engine based on Emulator State", cn105->wantedSettings);
     }
 
 void HPEmulator::simpleOperation() {
@@ -204,6 +209,20 @@ void HPEmulator::simpleOperation() {
         }
     }
 
+void HPEmulator::onEngineStateChange(const heatpumpStateDelta& delta) {
+    // pushed by CN105Climate as soon as a decoded packet changed something: no polling needed
+    if (delta.has(STATE_CHANGED_SETTINGS | STATE_CHANGED_ROOM_TEMP)) {
+        updateEmulatorStateFromEngine();
+        }
+    if (delta.has(STATE_CHANGED_STATUS | STATE_CHANGED_RUN_STATES)) {
+        infoCacheValid = false;
+        }
+    }
+
+bool HPEmulator::proxyMode() const {
+    return cn105 != nullptr && cn105->is_emulator_proxy_mode();
+    }
+
 void HPEmulator::updateEmulatorStateFromEngine() {
     // Compare emulatorState to esphomeState
     // If different, update emulatorState from esphomeState
@@ -212,6 +231,16 @@ void HPEmulator::updateEmulatorStateFromEngine() {
     // const uint64_t comparisonInterval = 2000; // 2 seconds in milliseconds
     // uint64_t currentTime = esp_timer_get_time() / 1000; // Convert microseconds to millisecond
     getEsphomeStatefromEngine();
+    if (proxyHoldUntil != 0) {
+        // proxy mode: the remote must not see its own change roll back before the heatpump confirms it
+        if (emulatorState == esphomeState || (esp_timer_get_time() / 1000) >= proxyHoldUntil) {
+            proxyHoldUntil = 0;
+            }
+        else {
+            emulatorState.actualTemp = esphomeState.actualTemp;
+            return;
+            }
+        }
     if (emulatorState != esphomeState) {
         emulatorState = esphomeState;
         debugHPState("Emulator State updated from Esphome State", emulatorState);
@@ -234,7 +263,6 @@ void HPEmulator::checkForRemoteStateChange() {
     // If different, update, esphomeState and esphome engine
     // Set timer so that remoteinControl will stay for 30 seconds
        
-    static HeatpumpState lastRemoteState;
     uint64_t currentTime = esp_timer_get_time() / 1000; // Convert microseconds to milliseconds 
 
     if (remoteState != lastRemoteState && !remoteInControl && systemUP) {
@@ -251,13 +279,11 @@ void HPEmulator::checkForRemoteStateChange() {
         }
     
     const uint64_t comparisonInterval = 30000; // 30 seconds in milliseconds
-    static uint64_t lastComparisonTime = 0;
     if ((currentTime - remoteLastUpdateTime) >= comparisonInterval) {
         if (remoteInControl) {
             remoteInControl = false;
             ESP_LOGD(TAG, "Cleared remoteInControl.");
             }   
-        lastComparisonTime = currentTime;
         }
     }
 
@@ -349,27 +375,51 @@ void HPEmulator::send_config_response_to_remote(struct DataBuffer* dbuf, uart_po
     uart_write_bytes(uart_num, (const char*)Stim_buffer.buffer, Stim_buffer.buf_pointer);
 }
 
-void HPEmulator::send_remote_state_to_heatpump(struct DataBuffer* dbuf, uart_port_t uart_num) {
-    //received a 0x41
-           
+void HPEmulator::forward_remote_set_to_heatpump(struct DataBuffer* dbuf) {
+    // proxy mode: the frame already has the CN105 SET layout, it goes to the heatpump untouched
+    cn105->proxySetPacket(dbuf->buffer, dbuf->length);
+
+    if (dbuf->buffer[5] != 0x01) return; // not a settings frame (remote temperature, ...)
+
+    // update the cache right away so that the next 0x42 already shows the new settings
     uint8_t mask1 = dbuf->buffer[6];
     uint8_t mask2 = dbuf->buffer[7];
-        
-    debugHPState("Emulator State before 0x41", emulatorState);
-
-    if (mask1 & 0x01) setPower(&remoteState, dbuf->buffer[8]);
-    if (mask1 & 0x02) setMode(&remoteState, dbuf->buffer[9]);
-    if (mask1 & 0x04) {
-        uint8_t temp = (dbuf->buffer[19] & 0x7f) >> 1;
-        setTargetTemp(&remoteState, temp);
-        setActualTemp(&remoteState, temp - 2); // For simplicity, set actual temp to target temp minus 2 degrees
-        }
-    if (mask1 & 0x08) setFanSpeed(&remoteState, dbuf->buffer[11]);
-    if (mask1 & 0x10) setVaneVertical(&remoteState, dbuf->buffer[12]);
-    if (mask2 & 0x01) setVaneHorizontal(&remoteState, dbuf->buffer[18]);
-
-    //now create the data to send to esphome if a change happened
-    debugHPState("Remote State after 0x41", remoteState);
+    if (mask1 & 0x01) setPower(&emulatorState, dbuf->buffer[8]);
+    if (mask1 & 0x02) setMode(&emulatorState, dbuf->buffer[9]);
+    if (mask1 & 0x04) setTargetTemp(&emulatorState, (dbuf->buffer[19] & 0x7f) >> 1);
+    if (mask1 & 0x08) setFanSpeed(&emulatorState, dbuf->buffer[11]);
+    if (mask1 & 0x10) setVaneVertical(&emulatorState, dbuf->buffer[12]);
+    if (mask2 & 0x01) setVaneHorizontal(&emulatorState, dbuf->buffer[18]);
+    remoteState = emulatorState;
+    proxyHoldUntil = esp_timer_get_time() / 1000 + PROXY_HOLD_MS;
+    debugHPState("Emulator State after proxied 0x41", emulatorState);
+}
+
+void HPEmulator::send_remote_state_to_heatpump(struct DataBuffer* dbuf, uart_port_t uart_num) {
+    //received a 0x41
+    if (proxyMode()) {
+        forward_remote_set_to_heatpump(dbuf);
+    }
+    else {
+        uint8_t mask1 = dbuf->buffer[6];
+        uint8_t mask2 = dbuf->buffer[7];
+
+        debugHPState("Emulator State before 0x41", emulatorState);
+
+        if (mask1 & 0x01) setPower(&remoteState, dbuf->buffer[8]);
+        if (mask1 & 0x02) setMode(&remoteState, dbuf->buffer[9]);
+        if (mask1 & 0x04) {
+            uint8_t temp = (dbuf->buffer[19] & 0x7f) >> 1;
+            setTargetTemp(&remoteState, temp);
+            setActualTemp(&remoteState, temp - 2); // For simplicity, set actual temp to target temp minus 2 degrees
+            }
+        if (mask1 & 0x08) setFanSpeed(&remoteState, dbuf->buffer[11]);
+        if (mask1 & 0x10) setVaneVertical(&remoteState, dbuf->buffer[12]);
+        if (mask2 & 0x01) setVaneHorizontal(&remoteState, dbuf->buffer[18]);
+
+        //now create the data to send to esphome if a change happened
+        debugHPState("Remote State after 0x41", remoteState);
+    }
                
     // send the response packet
     Stim_buffer.buf_pointer = sizeof(CONTROL_RESPONSE);
@@ -380,33 +430,50 @@ void HPEmulator::send_remote_state_to_heatpump(struct DataBuffer* dbuf, uart_por
     uart_write_bytes(uart_num, (const char*)Stim_buffer.buffer, Stim_buffer.buf_pointer);
 }
 
-void HPEmulator::send_heatpump_state_to_remote(struct DataBuffer* dbuf, uart_port_t uart_num) {
-    //received a 0x62
-    Stim_buffer.buf_pointer = sizeof(INFO_RESPONSE);
-    Stim_buffer.length = Stim_buffer.buf_pointer;
-    memcpy(Stim_buffer.buffer, INFO_RESPONSE, sizeof(INFO_RESPONSE));
-    uint8_t info_mode = dbuf->buffer[5];
-    Stim_buffer.buffer[5] = info_mode;
+static bool isSameState(const HeatpumpState& a, const HeatpumpState& b) {
+    // HeatpumpState::operator== ignores actualTemp and horiVane, the cache needs them all
+    return a == b && a.actualTemp == b.actualTemp && a.horiVane == b.horiVane;
+}
+
+static uint8_t encodeHalfDegree(float temperature) {
+    // inverse of the decoder: (byte - 128) / 2
+    return (uint8_t)(lroundf(temperature * 2.0f) + 128);
+}
+
+void HPEmulator::build_info_response(uint8_t info_mode, uint8_t* frame) {
+    memcpy(frame, INFO_RESPONSE, INFO_FRAME_LEN);
+    frame[5] = info_mode;
     switch(info_mode) {
         case 0x02: {
             //settings request
-            Stim_buffer.buffer[8] = emulatorState.power;
-            Stim_buffer.buffer[9] = emulatorState.mode;
-            Stim_buffer.buffer[10] = emulatorState.setTemp;
-            Stim_buffer.buffer[11] = emulatorState.fan;
-            Stim_buffer.buffer[12] = emulatorState.vertVane;
-            Stim_buffer.buffer[14] = emulatorState.horiVane;
-            Stim_buffer.buffer[16] = (emulatorState.setTemp << 1) | 0x80; //target temp in bits 1-7
+            frame[8] = emulatorState.power;
+            frame[9] = emulatorState.mode;
+            frame[10] = emulatorState.setTemp;
+            frame[11] = emulatorState.fan;
+            frame[12] = emulatorState.vertVane;
+            frame[14] = emulatorState.horiVane;
+            frame[16] = (emulatorState.setTemp << 1) | 0x80; //target temp in bits 1-7
             break;
         }
         case 0x03: {
-            // room temp request
-            Stim_buffer.buffer[11] = (emulatorState.actualTemp << 1) | 0x80; //target temp in bits 1-7
+            // room temp request: half degree room temperature and OAT from the heatpump when we have them
+            float room = infoCacheStatus.roomTemperature;
+            if (std::isnan(room) || room == 0) room = emulatorState.actualTemp;
+            int legacy = (int)room - 10;
+            frame[8] = (uint8_t)(legacy < 0 ? 0 : (legacy > 31 ? 31 : legacy)); // old format, see ROOM_TEMP_MAP
+            if (!std::isnan(infoCacheStatus.outsideAirTemperature)) {
+                frame[10] = encodeHalfDegree(infoCacheStatus.outsideAirTemperature);
+                }
+            frame[11] = encodeHalfDegree(room);
+            uint32_t minutes = (uint32_t)(infoCacheStatus.runtimeHours * 60);
+            frame[16] = (minutes >> 16) & 0xff;
+            frame[17] = (minutes >> 8) & 0xff;
+            frame[18] = minutes & 0xff;
             break;
         }
         case 0x04: {
             //unknown request
-            Stim_buffer.buffer[9] = 0x80;
+            frame[9] = 0x80;
             break;
         }
         case 0x05: {
@@ -414,29 +481,96 @@ void HPEmulator::send_heatpump_state_to_remote(struct DataBuffer* dbuf, uart_por
             break;
         }
         case 0x06: {
-            //status request
+            //status request: compressor frequency, operating, input power (W), energy (0.1 kWh)
+            uint16_t power = (uint16_t)infoCacheStatus.inputPower;
+            uint16_t energy = (uint16_t)lroundf(infoCacheStatus.kWh * 10);
+            frame[8] = (uint8_t)infoCacheStatus.compressorFrequency;
+            frame[9] = infoCacheStatus.operating ? 0x01 : 0x00;
+            frame[10] = power >> 8;
+            frame[11] = power & 0xff;
+            frame[12] = energy >> 8;
+            frame[13] = energy & 0xff;
             break;
         }
         case 0x09: {
             //standby mode request
-            Stim_buffer.buffer[9] = 0x01;
+            frame[9] = 0x01;
+            break;
+        }
+        case 0x42: {
+            //hvac options request: air purifier, night mode, circulator
+            frame[6] = infoCacheOptions[0];
+            frame[7] = infoCacheOptions[1];
+            frame[8] = infoCacheOptions[2];
             break;
         }
     }
-    
-    debugHPState("Emulator State sent in 0x62", emulatorState);
-    add_checksum_to_packet(&Stim_buffer);
-    print_packet(&Stim_buffer, "Packet to", "RE");
-    uart_write_bytes(uart_num, (const char*)Stim_buffer.buffer, Stim_buffer.buf_pointer);
 
+    uint8_t processedCS = 0;
+    for (int i = 0; i < INFO_FRAME_LEN - 1; i++) {
+        processedCS += frame[i];
+    }
+    frame[INFO_FRAME_LEN - 1] = (0xfc - processedCS) & 0xff;
+}
+
+void HPEmulator::refresh_info_cache() {
+    // the frames only change with the state they are built from: rebuild them on change, not on every poll
+    // (status and run state changes invalidate the cache from onEngineStateChange())
+    if (infoCacheValid && isSameState(emulatorState, infoCacheState)) {
+        return;
+        }
+
+    infoCacheState = emulatorState;
+    if (cn105 != nullptr) {
+        infoCacheStatus = cn105->getCurrentStatus();
+        const heatpumpRunStates& runStates = cn105->getCurrentRunStates();
+        infoCacheOptions[0] = runStates.air_purifier > 0 ? 0x01 : 0x00;
+        infoCacheOptions[1] = runStates.night_mode > 0 ? 0x01 : 0x00;
+        infoCacheOptions[2] = runStates.circulator > 0 ? 0x01 : 0x00;
+        }
+    for (int i = 0; i < INFO_CACHE_SIZE; i++) {
+        build_info_response(INFO_CODES[i], infoCache[i]);
+        }
+    infoCacheValid = true;
+    debugHPState("Info reply cache rebuilt from Emulator State", emulatorState);
+    }
+
+void HPEmulator::send_heatpump_state_to_remote(struct DataBuffer* dbuf, uart_port_t uart_num) {
+    //received a 0x62
+    // proxy mode: a forwarded setting the heatpump never confirmed must expire
+    if (proxyHoldUntil != 0) updateEmulatorStateFromEngine();
+    refresh_info_cache();
+
+    uint8_t info_mode = dbuf->buffer[5];
+    const uint8_t* frame = nullptr;
+    for (int i = 0; i < INFO_CACHE_SIZE; i++) {
+        if (INFO_CODES[i] == info_mode) {
+            frame = infoCache[i];
+            break;
+            }
+        }
+    if (frame == nullptr) {
+        // code not cached: zero filled reply built on the spot
+        build_info_response(info_mode, Stim_buffer.buffer);
+        frame = Stim_buffer.buffer;
+        }
+    uart_write_bytes(uart_num, (const char*)frame, INFO_FRAME_LEN);
+    }
+
+void HPEmulator::updateUptime() {
+    if (systemUP) return;
+    if (engineUpTime == 0) {
+        // no notification may come if the settings stopped changing before they were complete
+        if (!areCurrentSettingsIntialized(cn105->currentSettings)) return;
+        updateEmulatorStateFromEngine();    // sets engineUpTime
+        if (engineUpTime == 0) return;
+        }
     // address the System UP.   Assume that it is 15 seconds after engineUP
     const uint64_t comparisonInterval = 15000; // 15 seconds in milliseconds
     uint64_t currentTime = esp_timer_get_time() / 1000; // Convert microseconds to milliseconds
     if ((currentTime - engineUpTime) >= comparisonInterval) {
-        if (!systemUP) {
-            systemUP = true;
-            ESP_LOGD(TAG, "System is UP.");
-            }
+        systemUP = true;
+        ESP_LOGD(TAG, "System is UP.");
         }
     }
 
@@ -478,6 +612,12 @@ void HPEmulator::process_port_emulator(struct DataBuffer* dbuf, uart_port_t uart
             }
         }
         else { //building a packet
+            if (dbuf->buf_pointer >= sizeof(dbuf->buffer)) { //longer than any CN105 frame (compact_buffers)
+                print_packet(dbuf, "Oversized packet to", "HP");
+                dbuf->foundStart = false;
+                dbuf->buf_pointer = 0;
+                continue;
+            }
             dbuf->buffer[dbuf->buf_pointer++] = S1byte;
             check_header(dbuf); //assign length and command if we have enough data
             if (dbuf->buf_pointer >= dbuf->length) {
@@ -495,11 +635,11 @@ void HPEmulator::process_port_emulator(struct DataBuffer* dbuf, uart_port_t uart
 
 
 bool HPEmulator::uartInit() {
-    if (g_re_uart == nullptr) {
-        ESP_LOGE(TAG, "uartInit: g_re_uart not set");
+    if (reUart == nullptr) {
+        ESP_LOGE(TAG, "uartInit: remote uart not set");
         return false;
     }
-    uart_port_t port = (uart_port_t)g_re_uart->get_hw_serial_number();
+    uart_port_t port = (uart_port_t)reUart->get_hw_serial_number();
     ESP_LOGD(TAG, "UART initialized by ESPHome (port %d)", (int)port);
     return true;
 }
@@ -522,286 +662,203 @@ static bool is_network_connected() {
 #ifdef WEBPORT
 // --- Web Server Implementation ---
 
-// Static web server handle
-static httpd_handle_t web_server = NULL;
+// Web servers are numbered in setup() order
+static uint8_t web_instance_count = 0;
+
+static bool isSameWebStatus(const WebStatus& a, const WebStatus& b) {
+    return isSameState(a.emulator, b.emulator) && isSameState(a.esphome, b.esphome) &&
+           a.remoteInControl == b.remoteInControl && a.systemUP == b.systemUP && a.proxy == b.proxy;
+}
+
+// snprintf at buf + offset, but the returned offset never goes past size: once truncated it stays at size
+static int appendf(char* buf, size_t size, int offset, const char* fmt, ...) {
+    if (offset < 0 || offset >= (int)size) return (int)size;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + offset, size - offset, fmt, args);
+    va_end(args);
+    return (n < 0 || n >= (int)size - offset) ? (int)size : offset + n;
+}
+
+// Appends one side ("emulator" / "esphome") of the JSON status, only the fields differing from previous if given
+static int appendSideJson(HPEmulator* hp, char* buf, size_t size, int offset, const char* name,
+                          const HeatpumpState& st, const HeatpumpState* previous) {
+    int start = offset;
+    offset = appendf(buf, size, offset, ",\"%s\":{", name);
+    int fields = offset;
+    auto sep = [&]() { return (offset > fields) ? "," : ""; };
+    if (!previous || st.power != previous->power)
+        offset = appendf(buf, size, offset, "%s\"power\":\"%s\"", sep(), hp->lookupByteMapValue(hp->POWER_MAP, hp->POWER, 2, st.power));
+    if (!previous || st.mode != previous->mode)
+        offset = appendf(buf, size, offset, "%s\"mode\":\"%s\"", sep(), hp->lookupByteMapValue(hp->MODE_MAP, hp->MODE, 5, st.mode));
+    if (!previous || st.fan != previous->fan)
+        offset = appendf(buf, size, offset, "%s\"fan\":\"%s\"", sep(), hp->lookupByteMapValue(hp->FAN_MAP, hp->FAN, 6, st.fan));
+    if (!previous || st.setTemp != previous->setTemp)
+        offset = appendf(buf, size, offset, "%s\"setTemp\":%d", sep(), st.setTemp);
+    if (!previous || st.actualTemp != previous->actualTemp)
+        offset = appendf(buf, size, offset, "%s\"actualTemp\":%d", sep(), st.actualTemp);
+    if (!previous || st.vertVane != previous->vertVane)
+        offset = appendf(buf, size, offset, "%s\"vane\":\"%s\"", sep(), hp->lookupByteMapValue(hp->VANE_MAP, hp->VANE, 7, st.vertVane));
+    if (!previous || st.horiVane != previous->horiVane)
+        offset = appendf(buf, size, offset, "%s\"wideVane\":\"%s\"", sep(), hp->lookupByteMapValue(hp->WIDEVANE_MAP, hp->WIDEVANE, 7, st.horiVane));
+    if (offset == fields) return start; // nothing changed on this side
+    offset = appendf(buf, size, offset, "}");
+    return offset;
+}
+
+int HPEmulator::formatStatusJson(const WebStatus& st, uint32_t version, const WebStatus* previous, char* buf, size_t size) {
+    int offset = appendf(buf, size, 0, "{\"v\":%u", (unsigned)version);
+    if (!previous || st.proxy != previous->proxy)
+        offset = appendf(buf, size, offset, ",\"proxy\":%s", st.proxy ? "true" : "false");
+    if (!previous || st.remoteInControl != previous->remoteInControl)
+        offset = appendf(buf, size, offset, ",\"remoteInControl\":%s", st.remoteInControl ? "true" : "false");
+    if (!previous || st.systemUP != previous->systemUP)
+        offset = appendf(buf, size, offset, ",\"systemUp\":%s", st.systemUP ? "true" : "false");
+    offset = appendSideJson(this, buf, size, offset, "emulator", st.emulator, previous ? &previous->emulator : nullptr);
+    offset = appendSideJson(this, buf, size, offset, "esphome", st.esphome, previous ? &previous->esphome : nullptr);
+    offset = appendf(buf, size, offset, "}");
+    return (offset >= (int)size) ? -1 : offset;
+}
+
+static bool etagMatches(httpd_req_t *req, const char* etag) {
+    char inm[40];
+    return httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK && strcmp(inm, etag) == 0;
+}
 
+static esp_err_t send_not_modified(httpd_req_t *req, const char* etag) {
+    httpd_resp_set_status(req, "304 Not Modified");
+    httpd_resp_set_hdr(req, "ETag", etag);
+    return httpd_resp_send(req, NULL, 0);
+}
 
-// HTTP server handler for heatpump status
-esp_err_t heatpump_status_handler(httpd_req_t *req) {
-    // Get HPEmulator instance from user context
+// GET / : the page, gzip compressed in flash; it only talks to /status.json and /events
+esp_err_t heatpump_index_handler(httpd_req_t *req) {
+    if (etagMatches(req, EMULATOR_INDEX_ETAG)) return send_not_modified(req, EMULATOR_INDEX_ETAG);
+
+    httpd_resp_set_type(req, "text/html");
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Cache-Control", "public, max-age=86400");
+    httpd_resp_set_hdr(req, "ETag", EMULATOR_INDEX_ETAG);
+    return httpd_resp_send(req, (const char*)EMULATOR_INDEX_GZ, EMULATOR_INDEX_GZ_LEN);
+}
+
+// GET /status.json : full state, ETag is the boot id + the state version (304 while nothing changed)
+esp_err_t heatpump_json_handler(httpd_req_t *req) {
     HPEmulator* hp = (HPEmulator*)req->user_ctx;
+    WebStatus st;
+    uint32_t version = hp->webStatus.read(st);
 
-    // Use static buffer to avoid stack overflow
-    static char html[8192];
-
-    // Build HTML response
-    int len = snprintf(html, sizeof(html), R"(
-<!DOCTYPE html>
-<html lang="en">
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <meta http-equiv="refresh" content="10">
-    <title>HP Emulator</title>
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            margin: 10px;
-            background-color: #f5f5f5;
-            font-size: 13px;
-        }
-        .container {
-            background-color: white;
-            padding: 15px;
-            border-radius: 6px;
-            box-shadow: 0 2px 4px rgba(0,0,0,0.1);
-            max-width: 900px;
-            margin: 0 auto;
-        }
-        h1 {
-            color: #333;
-            text-align: center;
-            margin: 0 0 15px 0;
-            font-size: 20px;
-        }
-        .grid {
-            display: grid;
-            grid-template-columns: 1fr 1fr;
-            gap: 10px;
-        }
-        .status-item {
-            background-color: #f9f9f9;
-            padding: 10px;
-            border-left: 3px solid #4CAF50;
-            border-radius: 3px;
-        }
-        .status-item.mismatch {
-            border-left-color: #ff9800;
-            background-color: #fff3e0;
-        }
-        .status-label {
-            font-weight: bold;
-            color: #555;
-            font-size: 11px;
-            text-transform: uppercase;
-            margin-bottom: 6px;
-        }
-        .values-container {
-            display: grid;
-            grid-template-columns: 1fr 1fr;
-            gap: 8px;
-        }
-        .value-box {
-            text-align: center;
-        }
-        .value-type {
-            font-size: 9px;
-            color: #888;
-            margin-bottom: 3px;
-        }
-        .status-value {
-            font-size: 16px;
-            color: #4CAF50;
-            font-weight: bold;
-        }
-        .footer {
-            text-align: center;
-            margin-top: 10px;
-            font-size: 10px;
-            color: #999;
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>Heatpump Emulator</h1>
-        <div class="grid">
-            <div class="status-item%s">
-                <div class="status-label">Power</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Mode</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Fan Speed</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                </div>
-            </div>
-
-            <div style="visibility: hidden;"></div>
-
-            <div class="status-item%s">
-                <div class="status-label">Target Temp (°C)</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Target Temp (°F)</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Actual Temp (°C)</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Actual Temp (°F)</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%d</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Vane Vertical</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                </div>
-            </div>
-
-            <div class="status-item%s">
-                <div class="status-label">Vane Horizontal</div>
-                <div class="values-container">
-                    <div class="value-box">
-                        <div class="value-type">Emulator</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                    <div class="value-box">
-                        <div class="value-type">Esphome</div>
-                        <div class="status-value">%s</div>
-                    </div>
-                </div>
-            </div>
-        </div>
-        <div class="footer">
-            Auto-refresh: 10s | Heatpump Emulator
-        </div>
-    </div>
-</body>
-</html>
-)",
-        "",
-        hp->lookupByteMapValue(hp->POWER_MAP, hp->POWER, 2, hp->emulatorState.power),
-        hp->lookupByteMapValue(hp->POWER_MAP, hp->POWER, 2, hp->esphomeState.power),
-
-        "",
-        hp->lookupByteMapValue(hp->MODE_MAP, hp->MODE, 5, hp->emulatorState.mode),
-        hp->lookupByteMapValue(hp->MODE_MAP, hp->MODE, 5, hp->esphomeState.mode),
-
-        "",
-        hp->lookupByteMapValue(hp->FAN_MAP, hp->FAN, 6, hp->emulatorState.fan),
-        hp->lookupByteMapValue(hp->FAN_MAP, hp->FAN, 6, hp->esphomeState.fan),
-
-        "",
-        hp->emulatorState.setTemp,
-        hp->esphomeState.setTemp,
-
-        "",
-        (hp->emulatorState.setTemp * 9 / 5) + 32,
-        (hp->esphomeState.setTemp * 9 / 5) + 32,
-
-        "",
-        hp->emulatorState.actualTemp,
-        hp->esphomeState.actualTemp,
-
-        "",
-        (hp->emulatorState.actualTemp * 9 / 5) + 32,
-        (hp->esphomeState.actualTemp * 9 / 5) + 32,
-
-        "",
-        hp->lookupByteMapValue(hp->VANE_MAP, hp->VANE, 7, hp->emulatorState.vertVane),
-        hp->lookupByteMapValue(hp->VANE_MAP, hp->VANE, 7, hp->esphomeState.vertVane),
-
-        "",
-        hp->lookupByteMapValue(hp->WIDEVANE_MAP, hp->WIDEVANE, 7, hp->emulatorState.horiVane),
-        hp->lookupByteMapValue(hp->WIDEVANE_MAP, hp->WIDEVANE, 7, hp->esphomeState.horiVane)
-    );
-
-    if (len < 0 || len >= sizeof(html)) {
-        ESP_LOGE(TAG, "HTML buffer overflow!");
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%08x-%u\"", (unsigned)hp->webBootId, (unsigned)version);
+    if (etagMatches(req, etag)) return send_not_modified(req, etag);
+
+    char json[HPEmulator::WEB_JSON_SIZE];
+    int len = hp->formatStatusJson(st, version, nullptr, json, sizeof(json));
+    if (len < 0) {
+        ESP_LOGE(TAG, "JSON buffer overflow!");
         httpd_resp_send_500(req);
         return ESP_FAIL;
     }
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "ETag", etag);
+    return httpd_resp_send(req, json, len);
+}
 
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_set_hdr(req, "Cache-Control", "no-cache, no-store, must-revalidate");
-    httpd_resp_set_hdr(req, "Pragma", "no-cache");
-    httpd_resp_set_hdr(req, "Expires", "0");
-    httpd_resp_send(req, html, len);
+// GET /events : Server-Sent Events, a full "state" event then one "delta" event per change.
+// The response is left open; publishWebStatus() writes the next chunks from the httpd task.
+esp_err_t heatpump_events_handler(httpd_req_t *req) {
+    HPEmulator* hp = (HPEmulator*)req->user_ctx;
+    int slot = -1;
+    for (int i = 0; i < HPEmulator::SSE_MAX_CLIENTS; i++) {
+        if (hp->sseFds[i] < 0) { slot = i; break; }
+    }
+    if (slot < 0) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    WebStatus st;
+    uint32_t version = hp->webStatus.read(st);
+    char json[HPEmulator::WEB_JSON_SIZE];
+    int len = hp->formatStatusJson(st, version, nullptr, json, sizeof(json));
+    if (len < 0) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    char event[HPEmulator::WEB_JSON_SIZE + 48];
+    int eventLen = snprintf(event, sizeof(event), "retry: 3000\nevent: state\ndata: %s\n\n", json);
+
+    httpd_resp_set_type(req, "text/event-stream");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (httpd_resp_send_chunk(req, event, eventLen) != ESP_OK) return ESP_FAIL;
+    hp->sseFds[slot] = httpd_req_to_sockfd(req);
+    ESP_LOGD(TAG, "SSE client %d connected", hp->sseFds[slot]);
     return ESP_OK;
 }
 
+// Queued from the loop, runs on the httpd task (the only one touching sseFds after start)
+struct SseWork {
+    HPEmulator* hp;
+    int len;
+    char data[];
+};
+
+void sse_broadcast_work(void* arg) {
+    SseWork* work = (SseWork*)arg;
+    HPEmulator* hp = work->hp;
+    for (int i = 0; i < HPEmulator::SSE_MAX_CLIENTS; i++) {
+        if (hp->sseFds[i] < 0) continue;
+        if (httpd_socket_send(hp->web_server, hp->sseFds[i], work->data, work->len, 0) < 0) {
+            hp->sseFds[i] = -1;
+        }
+    }
+    free(work);
+}
+
+// Closing a session frees its fd for reuse: forget it before another client gets it
+void sse_close_fn(httpd_handle_t hd, int sockfd) {
+    HPEmulator* hp = (HPEmulator*)httpd_get_global_user_ctx(hd);
+    if (hp != nullptr) {
+        for (int i = 0; i < HPEmulator::SSE_MAX_CLIENTS; i++) {
+            if (hp->sseFds[i] == sockfd) hp->sseFds[i] = -1;
+        }
+    }
+    close(sockfd);
+}
+
+static void no_free_fn(void* ctx) {}
+
+// Called from the loop: changes are rare (a few per minute), one queued work per change is cheap
+void HPEmulator::publishWebStatus() {
+    WebStatus st;
+    st.emulator = emulatorState;
+    st.esphome = esphomeState;
+    st.remoteInControl = remoteInControl;
+    st.systemUP = systemUP;
+    st.proxy = proxyMode();
+    if (webPublishedValid && isSameWebStatus(st, webPublished)) return;
+
+    webStatus.publish(st);
+    const bool hadPrevious = webPublishedValid;
+    const WebStatus previous = webPublished;
+    webPublished = st;
+    webPublishedValid = true;
+    if (web_server == NULL || !hadPrevious) return;
+
+    // delta event, already framed as an HTTP chunk; the httpd task knows who is listening
+    char json[HPEmulator::WEB_JSON_SIZE];
+    int len = formatStatusJson(st, webStatus.version(), &previous, json, sizeof(json));
+    if (len < 0) return;
+    char event[HPEmulator::WEB_JSON_SIZE + 32];
+    int eventLen = snprintf(event, sizeof(event), "event: delta\ndata: %s\n\n", json);
+    SseWork* work = (SseWork*)malloc(sizeof(SseWork) + eventLen + 16);
+    if (work == nullptr) return;
+    work->hp = this;
+    work->len = snprintf(work->data, eventLen + 16, "%x\r\n%s\r\n", eventLen, event);
+    if (httpd_queue_work(web_server, sse_broadcast_work, work) != ESP_OK) free(work);
+}
+
 static esp_err_t not_found_handler(httpd_req_t *req, httpd_err_code_t err) {
     httpd_resp_send_404(req);
     return ESP_OK;
@@ -810,22 +867,42 @@ static esp_err_t not_found_handler(httpd_req_t *req, httpd_err_code_t err) {
 // Start web server
 void* HPEmulator::start_webserver() {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.lru_purge_enable = true;
-    config.stack_size = 8192;  // Increase stack size for HTTP handler
-    config.server_port = WEBPORT;
-    config.ctrl_port = 32769; // Avoid conflict with main ESPHome server
+    // SSE sockets stay open between requests: LRU purge would close them under a listening dashboard
+    config.lru_purge_enable = false;
+    config.stack_size = WEB_STACK_SIZE;
+    config.server_port = WEBPORT + instanceIndex;
+    config.ctrl_port = 32769 + instanceIndex; // Avoid conflict with main ESPHome server
+    config.global_user_ctx = this;
+    config.global_user_ctx_free_fn = no_free_fn;
+    config.close_fn = sse_close_fn;
 
     ESP_LOGD(TAG, "Starting web server on port %d", config.server_port);
 
     if (httpd_start(&web_server, &config) == ESP_OK) {
         // Register URI handlers - pass 'this' as user context
-        httpd_uri_t uri_status = {
+        httpd_uri_t uri_index = {
             .uri = "/",
             .method = HTTP_GET,
-            .handler = heatpump_status_handler,
+            .handler = heatpump_index_handler,
+            .user_ctx = this
+        };
+        httpd_register_uri_handler(web_server, &uri_index);
+
+        httpd_uri_t uri_json = {
+            .uri = "/status.json",
+            .method = HTTP_GET,
+            .handler = heatpump_json_handler,
             .user_ctx = this
         };
-        httpd_register_uri_handler(web_server, &uri_status);
+        httpd_register_uri_handler(web_server, &uri_json);
+
+        httpd_uri_t uri_events = {
+            .uri = "/events",
+            .method = HTTP_GET,
+            .handler = heatpump_events_handler,
+            .user_ctx = this
+        };
+        httpd_register_uri_handler(web_server, &uri_events);
 
         // Register 404 handler
         httpd_register_err_handler(web_server, HTTPD_404_NOT_FOUND, not_found_handler);
@@ -846,20 +923,42 @@ void HPEmulator::setup() {
     _webserver_started=false;
     systemUP=false;
     engineUpTime=0;
+#ifdef WEBPORT
+    instanceIndex = web_instance_count++;
+    webBootId = esphome::random_uint32();  // ETags of a previous boot never match
+#endif
+
+    if (cn105 != nullptr) {
+        cn105->add_on_state_change_callback([this](const heatpumpStateDelta& delta) { this->onEngineStateChange(delta); });
+        }
     
     ESP_LOGD(TAG, "HPEmulator setup complete (webserver will start when network is ready)");
 }
 
+void HPEmulator::dump_config() {
+    ESP_LOGCONFIG(TAG, "HP Emulator:");
+    ESP_LOGCONFIG(TAG, "  Remote UART port: %d", reUart != nullptr ? (int)reUart->get_hw_serial_number() : -1);
+    ESP_LOGCONFIG(TAG, "  Proxy mode: %s", proxyMode() ? "YES" : "NO");
+    ESP_LOGCONFIG(TAG, "  RAM: %u B per instance (2 packet buffers of %u B, info cache %u B)",
+        (unsigned)sizeof(HPEmulator), (unsigned)sizeof(DataBuffer), (unsigned)sizeof(infoCache));
+#ifdef WEBPORT
+    ESP_LOGCONFIG(TAG, "  Web port: %d", WEBPORT + instanceIndex);
+    ESP_LOGCONFIG(TAG, "  Web server task stack: %d B (JSON buffers %d B)", WEB_STACK_SIZE, WEB_JSON_SIZE);
+#endif
+}
+
 void HPEmulator::run() {
     //read the serial port and update the emulator state
-    if (g_re_uart == nullptr) return;
-    process_port_emulator(&Remote_buffer, (uart_port_t)g_re_uart->get_hw_serial_number());
+    if (reUart == nullptr || cn105 == nullptr) return;
+    process_port_emulator(&Remote_buffer, (uart_port_t)reUart->get_hw_serial_number());
+    // engine/system up timing, independent of the state notifications
+    updateUptime();
 
 #ifdef WEBPORT
     // Start webserver once network is available
     if (!_webserver_started && is_network_connected()) {
         if (start_webserver()) {
-            ESP_LOGD(TAG, "Web server started on port %d", WEBPORT);
+            ESP_LOGD(TAG, "Web server started on port %d", WEBPORT + instanceIndex);
             _webserver_started = true;
         } else {
             ESP_LOGE(TAG, "Failed to start web server");
@@ -868,17 +967,16 @@ void HPEmulator::run() {
 #endif
     
     //look for any change frome the remote interface without delay
-    checkForRemoteStateChange();
+    //(in proxy mode the 0x41 frames were already forwarded as they arrived)
+    if (!proxyMode()) checkForRemoteStateChange();
 
-    // Get ESPHome state every second
-    static uint64_t lastComparisonTime = 0;
-    const uint64_t comparisonInterval = 1000; // 1 second in milliseconds
-    uint64_t currentTime = esp_timer_get_time() / 1000; // Convert microseconds to milliseconds
-    if ((currentTime - lastComparisonTime) >= comparisonInterval) {
-        updateEmulatorStateFromEngine();
-        //simpleOperation(); //used for testing only
-        lastComparisonTime = currentTime;
-        }
+#ifdef WEBPORT
+    // snapshot for the web handlers (httpd task), deltas pushed to the /events clients
+    publishWebStatus();
+#endif
+
+    // ESPHome state changes are pushed by onEngineStateChange()
+    //simpleOperation(); //used for testing only
 }
 
 } // namespace HVAC
\ No newline at end of file
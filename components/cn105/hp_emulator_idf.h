@@ -7,7 +7,9 @@
 #include "driver/uart.h"
 #include "esp_timer.h"
 #include "esp_http_server.h"
+#include "esphome/core/component.h"
 #include "cn105_types.h"
+#include "seqlock_slot.h"
 
 // Compare char* fields between heatpumpSettings and wantedHeatpumpSettings
 // Returns true if all char* fields match (power, mode, fan, vane, wideVane)
@@ -27,8 +29,6 @@ inline bool compareCurrentHpsettingstoWantedHpSettings(const heatpumpSettings& c
            current.temperature == wanted.temperature;
 }
 
-#define HP_UART_NUM UART_NUM_1
-
 // Forward declarations
 namespace esphome {
     class CN105Climate;
@@ -37,16 +37,18 @@ namespace esphome {
     }
 }
 
-// Global pointer to CN105Climate - set from CN105Climate::setup()
-extern esphome::CN105Climate* g_cn105;
-// Global pointer to RE_UART - set from main.cpp after RE_UART is configured
-extern esphome::uart::IDFUARTComponent* g_re_uart;
-
 namespace HVAC {
 
 // --- Structs ---
+// 256: buf_pointer (uint8_t) cannot overflow the buffer. compact_buffers: the largest CN105 frame (5+16+1)
+#ifdef CN105_COMPACT_BUFFERS
+#define DATA_BUFFER_SIZE 22
+#else
+#define DATA_BUFFER_SIZE 256
+#endif
+
 struct DataBuffer {
-    uint8_t buffer[256]; //the packet data
+    uint8_t buffer[DATA_BUFFER_SIZE]; //the packet data
     uint8_t buf_pointer; //pointer to the next position in the buffer
     bool foundStart; //determines that we found a packet start character and are now building a packet
     uint8_t command; //This is the packet command
@@ -87,13 +89,30 @@ struct HeatpumpState {
     }
 };
 
-class HPEmulator {
+// What the web pages show, published from the loop and read by the httpd task
+struct WebStatus {
+    HeatpumpState emulator;
+    HeatpumpState esphome;
+    bool remoteInControl=false;
+    bool systemUP=false;
+    bool proxy=false;
+};
+
+// One instance per wall remote, bound from YAML (climate: remote_emulator:) to its CN105Climate and UART
+class HPEmulator : public esphome::Component {
 #ifdef WEBPORT
-    friend esp_err_t heatpump_status_handler(httpd_req_t *req);
+    friend esp_err_t heatpump_json_handler(httpd_req_t *req);
+    friend esp_err_t heatpump_events_handler(httpd_req_t *req);
+    friend void sse_broadcast_work(void* arg);
+    friend void sse_close_fn(httpd_handle_t hd, int sockfd);
 #endif
 public:
     HPEmulator() = default; // Constructor
 
+    // --- Configuration (generated from climate.py) ---
+    void set_climate(esphome::CN105Climate* climate) { cn105 = climate; }
+    void set_remote_uart(esphome::uart::IDFUARTComponent* uart) { reUart = uart; }
+
     // --- Static Constants
     const uint8_t HEADER[5] = { 0xfc, 0x42, 0x01, 0x30, 0x10 };
     const uint8_t COMMANDS[6] = { 0x5a, 0x42, 0x41, 0x7a, 0x62, 0x61};
@@ -127,7 +146,9 @@ public:
 
 
     // --- Primary Entry Points ---
-    void setup();
+    void setup() override;
+    void loop() override { run(); }
+    void dump_config() override;
     void run();
 
     // --- Setters ---
@@ -142,6 +163,13 @@ public:
     // --- Comparison / Debug ---
     void debugHPState(const char* label, const HeatpumpState& state);
 
+    // --- Info reply cache (one ready-to-send 0x62 frame per info code) ---
+    static const int INFO_FRAME_LEN = 22;
+    static const int INFO_CACHE_SIZE = 7;
+    const uint8_t INFO_CODES[INFO_CACHE_SIZE] = { 0x02, 0x03, 0x04, 0x05, 0x06, 0x09, 0x42 };
+    void build_info_response(uint8_t info_mode, uint8_t* frame);
+    void refresh_info_cache();
+
     // --- Logic Methods ---
     const char* lookupByteMapValue(const char* const valuesMap[], const uint8_t byteMap[], int len, uint8_t byteValue);
     int  lookupByteMapValue(const int valuesMap[], const uint8_t byteMap[], int len, uint8_t byteValue);
@@ -149,6 +177,7 @@ public:
     void send_ping_response_to_remote(struct DataBuffer* dbuf, uart_port_t uart_num);
     void send_config_response_to_remote(struct DataBuffer* dbuf, uart_port_t uart_num);
     void send_remote_state_to_heatpump(struct DataBuffer* dbuf, uart_port_t uart_num);
+    void forward_remote_set_to_heatpump(struct DataBuffer* dbuf);
     void send_heatpump_state_to_remote(struct DataBuffer* dbuf, uart_port_t uart_num);
     void print_packet(struct DataBuffer* dbuf, const char* mess1, const char* mess2);
     void add_checksum_to_packet(struct DataBuffer* dbuf);
@@ -157,29 +186,59 @@ public:
     void process_packets(struct DataBuffer* dbuf, uart_port_t uart_num);
     void process_port_emulator(struct DataBuffer* dbuf, uart_port_t uart_num);
 #ifdef WEBPORT
+    static const int WEB_JSON_SIZE = 512;
+    static const int WEB_STACK_SIZE = 8192;  // /events keeps two JSON buffers on the stack, plus httpd's own frames
+    static const int SSE_MAX_CLIENTS = 4;
     void* start_webserver();
+    void publishWebStatus();
+    int formatStatusJson(const WebStatus& st, uint32_t version, const WebStatus* previous, char* buf, size_t size);
 #endif
     bool uartInit();
     void sendEmulatorStateToEngine();
     void updateEmulatorStateFromEngine();
     void checkForRemoteStateChange();
     void getEsphomeStatefromEngine();
+    void onEngineStateChange(const heatpumpStateDelta& delta);
+    void updateUptime();
     void simpleOperation();
+    bool proxyMode() const;
 
 
 private:
+    // Bound engine and remote port
+    esphome::CN105Climate* cn105 = nullptr;
+    esphome::uart::IDFUARTComponent* reUart = nullptr;
+
     // Emulator State Variables
     HeatpumpState emulatorState;
     HeatpumpState esphomeState;
     HeatpumpState remoteState;
+    HeatpumpState lastRemoteState;  // last remote state pushed to the engine
     uint64_t remoteLastUpdateTime=0;
     uint64_t engineUpTime=0;
+    uint64_t proxyHoldUntil=0; // proxy mode: keep the requested settings in the cache until the engine reports them
 
     DataBuffer Stim_buffer; //used to build stimulus
+
+    // Info reply cache and the inputs it was built from
+    uint8_t infoCache[INFO_CACHE_SIZE][INFO_FRAME_LEN];
+    HeatpumpState infoCacheState;
+    heatpumpStatus infoCacheStatus{};
+    uint8_t infoCacheOptions[3] = { 0, 0, 0 };
+    bool infoCacheValid=false;
     DataBuffer Remote_buffer; //used to receive from remote
  
 
     bool _webserver_started=false;
+#ifdef WEBPORT
+    uint8_t instanceIndex=0;  // web port = WEBPORT + instanceIndex
+    httpd_handle_t web_server=NULL;
+    uint32_t webBootId=0;     // ETag prefix of /status.json
+    esphome::SeqlockSlot<WebStatus> webStatus;
+    WebStatus webPublished;   // last snapshot published, source of the SSE deltas
+    bool webPublishedValid=false;
+    int sseFds[SSE_MAX_CLIENTS] = { -1, -1, -1, -1 };  // open /events sockets, httpd task only
+#endif
     bool engineUP=false;
     bool systemUP=false;
     bool remoteInControl=false;
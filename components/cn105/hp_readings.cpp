@@ -4,6 +4,11 @@
 
 using namespace esphome;
 
+// NaN (valeur jamais reçue) vaut NaN: sans ça a != b est toujours vrai et chaque trame notifierait un changement
+static bool floatDiffers(float a, float b) {
+    return std::isnan(a) ? !std::isnan(b) : a != b;
+}
+
 /**
  * Seek the byte pointer to the beginning of the array
  * Initializes few variables
@@ -38,10 +43,13 @@ void CN105Climate::parse(uint8_t inputData) {
             storedInputData[this->bytesRead++] = inputData;
         } else {
             // unknown bytes
+            this->link_stats_.onNoise(1);
         }
     } else {                                // we are getting a packet
-        if (this->bytesRead >= (MAX_DATA_BYTES - 1)) {
+        if (this->bytesRead >= MAX_DATA_BYTES) {
             ESP_LOGW("Decoder", "buffer overflow preventive reset (bytesRead=%d)", this->bytesRead);
+            this->link_stats_.onNoise(this->bytesRead);
+            this->link_stats_.onOverflowReset();
             this->initBytePointer();
             return;
         }
@@ -52,6 +60,8 @@ void CN105Climate::parse(uint8_t inputData) {
         if (this->dataLength != -1) {       // is header complete ?
             if ((this->dataLength + 6) > MAX_DATA_BYTES) {
                 ESP_LOGW("Decoder", "declared data length %d too large, resetting parser", this->dataLength);
+                this->link_stats_.onNoise(this->bytesRead + 1);
+                this->link_stats_.onOverflowReset();
                 this->initBytePointer();
                 return;
             }
@@ -92,6 +102,7 @@ bool CN105Climate::checkSum() {
         ESP_LOGD("chkSum", "OK-> %02X=%02X ", processedCS, packetCheckSum);
     } else {
         ESP_LOGW("chkSum", "KO-> %02X!=%02X ", processedCS, packetCheckSum);
+        this->link_stats_.onChecksumFailure();
         // Pendant le handshake, une erreur de checksum est un signal utile: logguer la trame sous CN105_CONN
         if (!this->isHeatpumpConnected_) {
             ESP_LOGD(LOG_CONN_TAG, "Checksum KO during handshake (computed=%02X packet=%02X, cmd=0x%02X len=%d)",
@@ -111,12 +122,18 @@ void CN105Climate::checkHeader(uint8_t inputData) {
             ESP_LOGV("Header", "[%02X] (%02X) %02X %02X [%02X]<-- header", storedInputData[0], storedInputData[1], storedInputData[2], storedInputData[3], storedInputData[4]);
             ESP_LOGD("Header", "command: (%02X) data length: [%02X]<-- header", storedInputData[1], storedInputData[4]);
             this->command = storedInputData[1];
+        } else {
+            this->link_stats_.onHeaderMismatch();
         }
         this->dataLength = storedInputData[4];
     }
 }
 
 bool CN105Climate::processInput(void) {
+    if (this->rx_task_.is_running()) {
+        return this->processQueuedFrames();
+    }
+
     bool processed = false;
     while (this->get_hw_serial_()->available()) {
         processed = true;
@@ -129,6 +146,50 @@ bool CN105Climate::processInput(void) {
     return processed;
 }
 
+/**
+ * uart_rx_task mode: frames are assembled and checksum-validated by the RX task,
+ * we only decode them here so that publishing stays on the loop thread
+ */
+bool CN105Climate::processQueuedFrames() {
+    bool processed = false;
+    RxFrame frame;
+
+    while (this->rx_task_.pop(frame)) {
+        processed = true;
+        memcpy(this->storedInputData, frame.bytes, frame.length);
+        this->foundStart = true;
+        this->command = 0;
+        if (storedInputData[2] == HEADER[2] && storedInputData[3] == HEADER[3]) {
+            this->command = storedInputData[1];
+        }
+        this->dataLength = storedInputData[4];
+        this->bytesRead = frame.length - 1;
+
+        if (frame.checksumOk) {
+            this->processDataPacket();
+        } else {
+            // même chemin que la lecture directe: log KO, link_stats et trame sous CN105_CONN pendant le handshake
+            this->checkSum();
+        }
+        this->initBytePointer();
+    }
+
+    // overflows et trames perdues sont comptés dans la tâche, on les signale depuis le loop
+    uint32_t overflows = this->rx_task_.get_overflows();
+    if (overflows != this->rx_task_overflows_) {
+        ESP_LOGW("Decoder", "RX task reset its parser %u time(s) (oversized frame)", (unsigned)(overflows - this->rx_task_overflows_));
+        this->link_stats_.onOverflowReset(overflows - this->rx_task_overflows_);
+        this->rx_task_overflows_ = overflows;
+    }
+    uint32_t dropped = this->rx_task_.get_dropped_frames();
+    if (dropped != this->rx_task_dropped_frames_) {
+        ESP_LOGW("Decoder", "RX queue full, %u frame(s) dropped", (unsigned)(dropped - this->rx_task_dropped_frames_));
+        this->rx_task_dropped_frames_ = dropped;
+    }
+
+    return processed;
+}
+
 void CN105Climate::processDataPacket() {
 
     ESP_LOGV(TAG, "processing data packet...");
@@ -136,6 +197,7 @@ void CN105Climate::processDataPacket() {
     this->data = &this->storedInputData[5];
 
     this->hpPacketDebug(this->storedInputData, this->bytesRead + 1, "READ");
+    this->link_stats_.onRxFrame(this->storedInputData, this->bytesRead + 1);
 
     // Pendant le handshake (tant que non connecté), logguer toute trame RX sous CN105_CONN en DEBUG
     // afin de faciliter le diagnostic (0x7A/0x7B attendus, ou autre réponse inattendue).
@@ -147,8 +209,10 @@ void CN105Climate::processDataPacket() {
     if (this->checkSum()) {
         // checkPoint of a heatpump response
         this->lastResponseMs = CUSTOM_MILLIS;    //esphome::CUSTOM_MILLIS;
+        this->link_.responseReceived(this->lastResponseMs);
 
         // processing the specific command
+        LoopProfiler::Scope phase(this->profiler_, LoopProfiler::DECODE, CUSTOM_MICROS);
         processCommand();
     }
 }
@@ -194,7 +258,7 @@ void CN105Climate::getPowerFromResponsePacket() {
             // and publish to Home Assistant
             if (this->use_stage_for_operating_status_) {
                 this->updateAction();
-                this->publish_state();
+                this->publish_dirty_ |= PUBLISH_DIRTY_CLIMATE;
             }
         }
     }
@@ -271,6 +335,7 @@ void CN105Climate::getSettingsFromResponsePacket() {
         if (!this->currentRunStates.airflow_control || strcmp(receivedRunStates.airflow_control, this->currentRunStates.airflow_control) != 0) {
             this->currentRunStates.airflow_control = receivedRunStates.airflow_control;
             this->airflow_control_select_->publish_state(receivedRunStates.airflow_control);
+            this->notifyStateChange(STATE_CHANGED_RUN_STATES);
         }
     }
 
@@ -344,6 +409,7 @@ void CN105Climate::getOperatingAndCompressorFreqFromResponsePacket() {
     receivedStatus.compressorFrequency = data[3];
     receivedStatus.inputPower = (data[5] << 8) | data[6];
     receivedStatus.kWh = float((data[7] << 8) | data[8]) / 10;
+    this->updateEnergyIntegrator(receivedStatus.inputPower, (uint16_t)((data[7] << 8) | data[8]));
 
     // no change with this packet to roomTemperature
     receivedStatus.roomTemperature = currentStatus.roomTemperature;
@@ -360,6 +426,7 @@ void CN105Climate::getHVACOptionsFromResponsePacket() {
     // NM = night mode (1 = on, 0 = off)
     // CL = circulator (1 = on, 0 = off) ! MIGHT BE SAME BYTE AS ECONOCOOL - NEEDS TESTING !
     heatpumpRunStates receivedRunStates{};
+    const heatpumpRunStates previousRunStates = this->currentRunStates;
     ESP_LOGD("Decoder", "[0x42 is HVAC options]");
 
     if (this->air_purifier_switch_ != nullptr) {
@@ -386,6 +453,10 @@ void CN105Climate::getHVACOptionsFromResponsePacket() {
             this->circulator_switch_->publish_state(receivedRunStates.circulator);
         }
     }
+
+    if (this->currentRunStates != previousRunStates) {
+        this->notifyStateChange(STATE_CHANGED_RUN_STATES);
+    }
 }
 
 void CN105Climate::terminateCycle() {
@@ -397,6 +468,12 @@ void CN105Climate::terminateCycle() {
     }
 
     this->loopCycle.cycleEnded();
+    this->confirmWarmStart();
+
+    // une seule publication par cycle, quel que soit le nombre de réponses qui ont changé quelque chose
+    this->flushPendingPublish();
+    this->recordTelemetrySample();
+    this->saveWarmStart(false);
 
     if (this->hp_uptime_connection_sensor_ != nullptr) {
         // if the uptime connection sensor is configured
@@ -410,6 +487,23 @@ void CN105Climate::getDataFromResponsePacket() {
 
     // D'abord, laissons l'orchestrateur traiter les codes connus
     const uint8_t code = this->data[0];
+    if (this->functions_tx_.inFlight() && this->functionsTransactionResponse(code)) {
+        return;     // relecture de vérification d'une transaction de fonctions
+    }
+    if (this->proxy_packet_pending_ && this->loopCycle.isCycleRunning() && this->scheduler_.handles(code)) {
+        // mode proxy: la trame de la télécommande prend le créneau de la prochaine requête INFO,
+        // le cycle reprend à la réception de l'ACK 0x61
+        this->scheduler_.mark_response_seen(code);
+        this->proxy_resume_code_ = code;
+        this->proxy_resume_pending_ = true;
+        this->flushProxyPacket();
+        // ACK perdu: ne pas attendre le timeout du cycle complet pour reprendre le polling
+        this->set_timeout("proxyResume", PROXY_RESUME_TIMEOUT_MS, [this]() {
+            ESP_LOGW(TAG, "proxy: no 0x61 for the forwarded frame, resuming the cycle");
+            this->resumeAfterProxy();
+            });
+        return;
+    }
     if (this->scheduler_.process_response(code)) {
         return;
     }
@@ -478,6 +572,14 @@ void CN105Climate::processCommand() {
     case 0x61:  /* last update was successful */
         this->hpPacketDebug(this->storedInputData, this->bytesRead + 1, LOG_ACK);
         this->updateSuccess();
+        this->settingsWriteAck();
+        if (this->functions_tx_.inFlight()) {
+            this->functionsTransactionAck();
+        }
+        if (this->proxy_resume_pending_) {
+            this->cancel_timeout("proxyResume");
+            this->resumeAfterProxy();
+        }
         break;
 
     case 0x62:  /* packet contains data (room °C, settings, timer, status, or functions...)*/
@@ -492,6 +594,7 @@ void CN105Climate::processCommand() {
         this->hpPacketDebug(this->storedInputData, this->bytesRead + 1, LOG_CONN_TAG);
         //this->isHeatpumpConnected_ = true;
         this->setHeatpumpConnected(true);
+        this->handshakeSucceeded(this->command);
         // let's say that the last complete cycle was over now
         this->loopCycle.lastCompleteCycleMs = CUSTOM_MILLIS;
         this->currentSettings.resetSettings();      // each time we connect, we need to reset current setting to force a complete sync with ha component state and receievdSettings
@@ -509,6 +612,15 @@ void CN105Climate::statusChanged(heatpumpStatus status) {
         this->debugStatus("received", status);
         this->debugStatus("current", currentStatus);
 
+        uint16_t changed = 0;
+        if (floatDiffers(status.roomTemperature, currentStatus.roomTemperature)) changed |= STATE_CHANGED_ROOM_TEMP;
+        if (floatDiffers(status.outsideAirTemperature, currentStatus.outsideAirTemperature)) changed |= STATE_CHANGED_OUTSIDE_TEMP;
+        if (status.operating != currentStatus.operating || status.compressorFrequency != currentStatus.compressorFrequency) {
+            changed |= STATE_CHANGED_OPERATING;
+        }
+        if (status.inputPower != currentStatus.inputPower || status.kWh != currentStatus.kWh || status.runtimeHours != currentStatus.runtimeHours) {
+            changed |= STATE_CHANGED_ENERGY;
+        }
 
         this->currentStatus.operating = status.operating;
         this->currentStatus.compressorFrequency = status.compressorFrequency;
@@ -520,58 +632,97 @@ void CN105Climate::statusChanged(heatpumpStatus status) {
         this->setCurrentTemperature(this->currentStatus.roomTemperature);
 
         this->updateAction();       // update action info on HA climate component
-        this->publish_state();
+        this->publish_dirty_ |= PUBLISH_DIRTY_CLIMATE;
 
-        if (this->compressor_frequency_sensor_ != nullptr) {
-            this->compressor_frequency_sensor_->publish_state(currentStatus.compressorFrequency);
-        }
+        this->notifyStateChange(changed);
+    } // else no change
+}
 
-        if (this->input_power_sensor_ != nullptr) {
-            this->input_power_sensor_->publish_state(currentStatus.inputPower);
-        }
+void CN105Climate::flushPendingPublish() {
+    LoopProfiler::Scope phase(this->profiler_, LoopProfiler::PUBLISH, CUSTOM_MICROS);
+    if (this->publish_dirty_ & PUBLISH_DIRTY_CLIMATE) {
+        this->publish_state();
+    }
+    this->publish_dirty_ = 0;
 
-        if (this->kwh_sensor_ != nullptr) {
-            this->kwh_sensor_->publish_state(currentStatus.kWh);
-        }
+    // chaque capteur décide seul (bande morte, intervalles min/max): évalué à chaque cycle, pour qu'un
+    // changement retenu par min_interval ou un point de vie max_interval parte même sans nouvelle trame
+    const uint32_t now = CUSTOM_MILLIS;
+    if (this->compressor_frequency_sensor_ != nullptr) {
+        this->compressor_frequency_sensor_->publish_if_due(currentStatus.compressorFrequency, now);
+    }
+    if (this->input_power_sensor_ != nullptr) {
+        this->input_power_sensor_->publish_if_due(currentStatus.inputPower, now);
+    }
+    if (this->kwh_sensor_ != nullptr) {
+        this->kwh_sensor_->publish_if_due(currentStatus.kWh, now);
+    }
+    if (this->total_energy_sensor_ != nullptr) {
+        this->total_energy_sensor_->publish_if_due((float)this->energy_integrator_.total(), now);
+    }
+    if (this->runtime_hours_sensor_ != nullptr) {
+        this->runtime_hours_sensor_->publish_if_due(currentStatus.runtimeHours, now);
+    }
+    if (this->outside_air_temperature_sensor_ != nullptr) {
+        this->outside_air_temperature_sensor_->publish_if_due(this->fahrenheitSupport_.normalizeHeatpumpTemperatureToUiTemperature(currentStatus.outsideAirTemperature), now);
+    }
+}
 
-        if (this->runtime_hours_sensor_ != nullptr) {
-            this->runtime_hours_sensor_->publish_state(currentStatus.runtimeHours);
-        }
 
-        if (this->outside_air_temperature_sensor_ != nullptr) {
-            this->outside_air_temperature_sensor_->publish_state(this->fahrenheitSupport_.normalizeHeatpumpTemperatureToUiTemperature(currentStatus.outsideAirTemperature));
+void CN105Climate::recordTelemetrySample() {
+    if (!this->telemetry_history_.is_configured()) {
+        return;
+    }
+    auto tenths = [](float v) -> int16_t { return std::isnan(v) ? TelemetrySample::NO_VALUE : (int16_t)lroundf(v * 10.0f); };
+    // stage et sub_mode pointent dans STAGE_MAP / SUB_MODE_MAP (lookupByteMapValue): l'index suffit
+    auto indexOf = [](const char* value, const char* map[], int len) -> int16_t {
+        for (int i = 0; i < len; i++) {
+            if (value == map[i]) return i;
         }
-    } // else no change
+        return TelemetrySample::NO_VALUE;
+        };
+
+    TelemetrySample sample{};
+    sample.uptimeMs = CUSTOM_MILLIS;
+    sample.values[0] = tenths(this->currentStatus.roomTemperature);
+    sample.values[1] = tenths(this->currentStatus.outsideAirTemperature);
+    sample.values[2] = (int16_t)this->currentStatus.compressorFrequency;
+    sample.values[3] = (int16_t)this->currentStatus.inputPower;
+    sample.values[4] = indexOf(this->currentSettings.stage, STAGE_MAP, 7);
+    sample.values[5] = indexOf(this->currentSettings.sub_mode, SUB_MODE_MAP, 4);
+    this->telemetry_history_.record(sample);
 }
 
 
 void CN105Climate::publishStateToHA(heatpumpSettings& settings) {
+    // demande en cours telle que le TX la voit (instantané publié, pas le brouillon des producteurs)
+    const wantedHeatpumpSettings wanted = this->getCommittedWantedSettings();
 
-    if ((this->wantedSettings.mode == nullptr) && (this->wantedSettings.power == nullptr)) {        // to prevent overwriting a user demand
+    if ((wanted.mode == nullptr) && (wanted.power == nullptr)) {        // to prevent overwriting a user demand
         checkPowerAndModeSettings(settings);
     }
 
     this->updateAction();       // update action info on HA climate component
 
-    if (this->wantedSettings.fan == nullptr) {  // to prevent overwriting a user demand
+    if (wanted.fan == nullptr) {  // to prevent overwriting a user demand
         checkFanSettings(settings);
     }
 
-    if (this->wantedSettings.vane == nullptr) { // to prevent overwriting a user demand
+    if (wanted.vane == nullptr) { // to prevent overwriting a user demand
         checkVaneSettings(settings);
     }
 
-    if (this->wantedSettings.wideVane == nullptr) { // to prevent overwriting a user demand
+    if (wanted.wideVane == nullptr) { // to prevent overwriting a user demand
         checkWideVaneSettings(settings);
     }
 
     // HA Temp
     // Ignorer temporairement une consigne entrante si une consigne utilisateur est en cours
-    bool hasPendingUserTemp = (this->wantedSettings.temperature != -1.0f) && (this->wantedSettings.hasChanged) && (!this->wantedSettings.hasBeenSent);
+    bool hasPendingUserTemp = (wanted.temperature != -1.0f) && (wanted.hasChanged) && (!wanted.hasBeenSent);
     uint32_t graceWindowMs = this->get_update_interval() + DEFER_SCHEDULE_UPDATE_LOOP_DELAY;
-    bool graceAfterSend = (this->wantedSettings.hasBeenSent) && ((CUSTOM_MILLIS - this->wantedSettings.lastChange) < graceWindowMs);
+    bool graceAfterSend = (wanted.hasBeenSent) && ((CUSTOM_MILLIS - wanted.lastChange) < graceWindowMs);
     if (!hasPendingUserTemp && !graceAfterSend) {
-        if (this->wantedSettings.temperature == -1) { // to prevent overwriting a user demand
+        if (wanted.temperature == -1) { // to prevent overwriting a user demand
             this->updateTargetTemperaturesFromSettings(settings.temperature);
             this->currentSettings.temperature = settings.temperature;
         }
@@ -583,8 +734,8 @@ void CN105Climate::publishStateToHA(heatpumpSettings& settings) {
 
     this->currentSettings.connected = true;
 
-    // publish to HA
-    this->publish_state();
+    // publié en fin de cycle (flushPendingPublish)
+    this->publish_dirty_ |= PUBLISH_DIRTY_CLIMATE;
 
 }
 
@@ -600,11 +751,35 @@ void CN105Climate::heatpumpUpdate(heatpumpSettings& settings) {
         this->debugSettings("received", settings);
         this->debugSettings("wanted", this->wantedSettings);
         this->debugClimate("climate");
+        const heatpumpSettings previous = this->currentSettings;
         this->publishStateToHA(settings);
+
+        // only what publishStateToHA really applied (a pending user demand keeps its fields untouched)
+        uint16_t changed = 0;
+        if (this->currentSettings.power != previous.power) changed |= STATE_CHANGED_POWER;
+        if (this->currentSettings.mode != previous.mode) changed |= STATE_CHANGED_MODE;
+        if (floatDiffers(this->currentSettings.temperature, previous.temperature) ||
+            floatDiffers(this->currentSettings.dual_low_target, previous.dual_low_target) ||
+            floatDiffers(this->currentSettings.dual_high_target, previous.dual_high_target)) {
+            changed |= STATE_CHANGED_TARGET_TEMP;
+        }
+        if (this->currentSettings.fan != previous.fan) changed |= STATE_CHANGED_FAN;
+        if (this->currentSettings.vane != previous.vane) changed |= STATE_CHANGED_VANE;
+        if (this->currentSettings.wideVane != previous.wideVane) changed |= STATE_CHANGED_WIDEVANE;
+        this->notifyStateChange(changed);
     }
 
 }
 
+void CN105Climate::notifyStateChange(uint16_t changed) {
+    if (changed == 0) {
+        return;
+    }
+    ESP_LOGV(LOG_SETTINGS_TAG, "state change 0x%03X notified to listeners", changed);
+    heatpumpStateDelta delta{ changed, this->currentSettings, this->currentStatus, this->currentRunStates };
+    this->state_change_callback_.call(delta);
+}
+
 void CN105Climate::checkVaneSettings(heatpumpSettings& settings, bool updateCurrentSettings) {
     if (this->hasChanged(currentSettings.vane, settings.vane, "vane")) {    // widevane setting change ?
         ESP_LOGI(LOG_SETTINGS_TAG, "vane setting changed");
@@ -33,18 +33,31 @@ void CN105Climate::sendFirstConnectionPacket() {
         this->lastSend = CUSTOM_MILLIS;
         this->lastConnectRqTimeMs = CUSTOM_MILLIS;
         this->nbHeatpumpConnections_++;
+        this->handshake_sent_command_ = packet[1];
+        this->handshake_sent_ms_ = this->lastSend;
+
+        // sonde 0x5B: sans réponse après le délai mesuré (cache de handshake), bascule immédiate en 0x5A
+        if (this->installer_mode_effective_ && !this->installer_mode_fallback_done_) {
+            this->set_timeout("handshakeProbe", this->handshakeProbeTimeoutMs(), [this]() {
+                if (!this->isHeatpumpConnected_ && this->installer_mode_effective_) {
+                    this->fallbackToStandardHandshake();
+                    this->sendFirstConnectionPacket();
+                }});
+        } else if (this->isBaudProbing()) {
+            // baud_rates: pas de réponse au CONNECT standard, débit suivant
+            this->set_timeout("handshakeProbe", this->handshakeProbeTimeoutMs(), [this]() {
+                if (!this->isHeatpumpConnected_) {
+                    this->selectNextBaudRate();
+                    this->reconnectUART();
+                }});
+        }
 
         // we wait for a 10s timeout to check if the hp has replied to connection packet
+        // (un CONNECT sans aucune réponse est repris plus tôt par le LinkMonitor, avec backoff)
         this->set_timeout("checkFirstConnection", 10000, [this]() {
-            if (!this->isHeatpumpConnected_) {
+            if (!this->isHeatpumpConnected_ && !this->link_.is_lost()) {
                 ESP_LOGE(LOG_CONN_TAG, "--> Heatpump did not reply: NOT CONNECTED <--");
-                // Fallback automatique: si le mode installateur est demandé mais que la PAC ignore 0x5B,
-                // on retente une fois en mode standard (0x5A) pour préserver la connectivité.
-                if (this->installer_mode_ && this->installer_mode_effective_ && !this->installer_mode_fallback_done_) {
-                    this->installer_mode_effective_ = false;
-                    this->installer_mode_fallback_done_ = true;
-                    ESP_LOGW(LOG_CONN_TAG, "No reply to installer handshake (0x5B). Falling back to standard handshake (0x5A).");
-                }
+                this->fallbackToStandardHandshake();
                 ESP_LOGI(LOG_CONN_TAG, "Reinitializing UART and trying to connect again...");
                 this->reconnectUART();
             }});
@@ -102,9 +115,13 @@ void CN105Climate::writePacket(uint8_t* packet, int length, bool checkIsActive)
         for (int i = 0; i < length; i++) {
             this->get_hw_serial_()->write_byte((uint8_t)packet[i]);
         }
+        this->link_stats_.onTx(packet, length);
+        this->last_write_command_ = packet[1];
+        this->last_write_code_ = (length > 5) ? packet[5] : 0;
 
         // Prevent sending wantedSettings too soon after writing for example the remote temperature update packet
         this->lastSend = CUSTOM_MILLIS;
+        this->link_.requestSent(this->lastSend);     // chaque trame écrite attend une réponse
 
     } else {
         ESP_LOGW(TAG, "could not write as asked, because UART is not connected");
@@ -133,52 +150,52 @@ void CN105Climate::try_write_pending_packet() {
     this->has_pending_packet_ = false;
 }
 
-const char* CN105Climate::getModeSetting() {
-    if (this->wantedSettings.mode) {
-        return this->wantedSettings.mode;
+const char* CN105Climate::getModeSetting(const wantedHeatpumpSettings& wanted) {
+    if (wanted.mode) {
+        return wanted.mode;
     } else {
         return this->currentSettings.mode;
     }
 }
 
-const char* CN105Climate::getPowerSetting() {
-    if (this->wantedSettings.power) {
-        return this->wantedSettings.power;
+const char* CN105Climate::getPowerSetting(const wantedHeatpumpSettings& wanted) {
+    if (wanted.power) {
+        return wanted.power;
     } else {
         return this->currentSettings.power;
     }
 }
 
-const char* CN105Climate::getVaneSetting() {
-    if (this->wantedSettings.vane) {
-        return this->wantedSettings.vane;
+const char* CN105Climate::getVaneSetting(const wantedHeatpumpSettings& wanted) {
+    if (wanted.vane) {
+        return wanted.vane;
     } else {
         return this->currentSettings.vane;
     }
 }
 
-const char* CN105Climate::getWideVaneSetting() {
-    if (this->wantedSettings.wideVane) {
-        if (strcmp(this->wantedSettings.wideVane, lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 8, 0x80 & 0x0F)) == 0 && !this->currentSettings.iSee) {
-            this->wantedSettings.wideVane = this->currentSettings.wideVane;
+const char* CN105Climate::getWideVaneSetting(wantedHeatpumpSettings& wanted) {
+    if (wanted.wideVane) {
+        if (strcmp(wanted.wideVane, lookupByteMapValue(WIDEVANE_MAP, WIDEVANE, 8, 0x80 & 0x0F)) == 0 && !this->currentSettings.iSee) {
+            wanted.wideVane = this->currentSettings.wideVane;
         }
-        return this->wantedSettings.wideVane;
+        return wanted.wideVane;
     } else {
         return this->currentSettings.wideVane;
     }
 }
 
-const char* CN105Climate::getFanSpeedSetting() {
-    if (this->wantedSettings.fan) {
-        return this->wantedSettings.fan;
+const char* CN105Climate::getFanSpeedSetting(const wantedHeatpumpSettings& wanted) {
+    if (wanted.fan) {
+        return wanted.fan;
     } else {
         return this->currentSettings.fan;
     }
 }
 
-float CN105Climate::getTemperatureSetting() {
-    if (this->wantedSettings.temperature != -1.0) {
-        return this->wantedSettings.temperature;
+float CN105Climate::getTemperatureSetting(const wantedHeatpumpSettings& wanted) {
+    if (wanted.temperature != -1.0) {
+        return wanted.temperature;
     } else {
         return this->currentSettings.temperature;
     }
@@ -213,52 +230,52 @@ bool CN105Climate::getCirculatorRunState() {
 }
 
 
-void CN105Climate::createPacket(uint8_t* packet) {
+void CN105Climate::createPacket(uint8_t* packet, wantedHeatpumpSettings& wanted) {
     prepareSetPacket(packet, PACKET_LEN);
 
     //ESP_LOGD(TAG, "checking differences bw asked settings and current ones...");
     ESP_LOGD(TAG, "building packet for writing...");
 
-    if (this->wantedSettings.power != nullptr) {
-        ESP_LOGD(TAG, "power -> %s", getPowerSetting());
-        int idx = lookupByteMapIndex(POWER_MAP, 2, getPowerSetting(), "power (write)");
+    if (wanted.power != nullptr) {
+        ESP_LOGD(TAG, "power -> %s", getPowerSetting(wanted));
+        int idx = lookupByteMapIndex(POWER_MAP, 2, getPowerSetting(wanted), "power (write)");
         if (idx >= 0) { packet[8] = POWER[idx]; packet[6] += CONTROL_PACKET_1[0]; } else { ESP_LOGW(TAG, "Ignoring invalid power setting while building packet"); }
     }
 
-    if (this->wantedSettings.mode != nullptr) {
-        ESP_LOGD(TAG, "heatpump mode -> %s", getModeSetting());
-        int idx = lookupByteMapIndex(MODE_MAP, 5, getModeSetting(), "mode (write)");
+    if (wanted.mode != nullptr) {
+        ESP_LOGD(TAG, "heatpump mode -> %s", getModeSetting(wanted));
+        int idx = lookupByteMapIndex(MODE_MAP, 5, getModeSetting(wanted), "mode (write)");
         if (idx >= 0) { packet[9] = MODE[idx]; packet[6] += CONTROL_PACKET_1[1]; } else { ESP_LOGW(TAG, "Ignoring invalid mode setting while building packet"); }
     }
 
-    if (wantedSettings.temperature != -1) {
+    if (wanted.temperature != -1) {
         if (!tempMode) {
-            ESP_LOGD(TAG, "temperature (tempmode is false) -> %f", getTemperatureSetting());
-            int idx = lookupByteMapIndex(TEMP_MAP, 16, getTemperatureSetting(), "temperature (write)");
+            ESP_LOGD(TAG, "temperature (tempmode is false) -> %f", getTemperatureSetting(wanted));
+            int idx = lookupByteMapIndex(TEMP_MAP, 16, getTemperatureSetting(wanted), "temperature (write)");
             if (idx >= 0) { packet[10] = TEMP[idx]; packet[6] += CONTROL_PACKET_1[2]; } else { ESP_LOGW(TAG, "Ignoring invalid temperature setting while building packet"); }
         } else {
-            ESP_LOGD(TAG, "temperature (tempmode is true) -> %f", getTemperatureSetting());
-            float temp = (getTemperatureSetting() * 2) + 128;
+            ESP_LOGD(TAG, "temperature (tempmode is true) -> %f", getTemperatureSetting(wanted));
+            float temp = (getTemperatureSetting(wanted) * 2) + 128;
             packet[19] = (int)temp;
             packet[6] += CONTROL_PACKET_1[2];
         }
     }
 
-    if (this->wantedSettings.fan != nullptr) {
-        ESP_LOGD(TAG, "heatpump fan -> %s", getFanSpeedSetting());
-        int idx = lookupByteMapIndex(FAN_MAP, 6, getFanSpeedSetting(), "fan (write)");
+    if (wanted.fan != nullptr) {
+        ESP_LOGD(TAG, "heatpump fan -> %s", getFanSpeedSetting(wanted));
+        int idx = lookupByteMapIndex(FAN_MAP, 6, getFanSpeedSetting(wanted), "fan (write)");
         if (idx >= 0) { packet[11] = FAN[idx]; packet[6] += CONTROL_PACKET_1[3]; } else { ESP_LOGW(TAG, "Ignoring invalid fan setting while building packet"); }
     }
 
-    if (this->wantedSettings.vane != nullptr) {
-        ESP_LOGD(TAG, "heatpump vane -> %s", getVaneSetting());
-        int idx = lookupByteMapIndex(VANE_MAP, 7, getVaneSetting(), "vane (write)");
+    if (wanted.vane != nullptr) {
+        ESP_LOGD(TAG, "heatpump vane -> %s", getVaneSetting(wanted));
+        int idx = lookupByteMapIndex(VANE_MAP, 7, getVaneSetting(wanted), "vane (write)");
         if (idx >= 0) { packet[12] = VANE[idx]; packet[6] += CONTROL_PACKET_1[4]; } else { ESP_LOGW(TAG, "Ignoring invalid vane setting while building packet"); }
     }
 
-    if (this->wantedSettings.wideVane != nullptr) {
-        ESP_LOGD(TAG, "heatpump widevane -> %s", getWideVaneSetting());
-        int idx = lookupByteMapIndex(WIDEVANE_MAP, 8, getWideVaneSetting(), "wideVane (write)");
+    if (wanted.wideVane != nullptr) {
+        ESP_LOGD(TAG, "heatpump widevane -> %s", getWideVaneSetting(wanted));
+        int idx = lookupByteMapIndex(WIDEVANE_MAP, 8, getWideVaneSetting(wanted), "wideVane (write)");
         if (idx >= 0) { packet[18] = WIDEVANE[idx] | (this->wideVaneAdj ? 0x80 : 0x00); packet[7] += CONTROL_PACKET_2[0]; } else { ESP_LOGW(TAG, "Ignoring invalid wideVane setting while building packet"); }
     }
 
@@ -274,34 +291,35 @@ void CN105Climate::createPacket(uint8_t* packet) {
 
 
 
-void CN105Climate::publishWantedSettingsStateToHA() {
+void CN105Climate::publishWantedSettingsStateToHA(wantedHeatpumpSettings& settings) {
 
-    if ((this->wantedSettings.mode != nullptr) || (this->wantedSettings.power != nullptr)) {
-        checkPowerAndModeSettings(this->wantedSettings, false);
+    if ((settings.mode != nullptr) || (settings.power != nullptr)) {
+        checkPowerAndModeSettings(settings, false);
         this->updateAction();       // update action info on HA climate component
     }
 
-    if (this->wantedSettings.fan != nullptr) {
-        checkFanSettings(this->wantedSettings, false);
+    if (settings.fan != nullptr) {
+        checkFanSettings(settings, false);
     }
 
 
-    if ((this->wantedSettings.vane != nullptr) || (this->wantedSettings.wideVane != nullptr)) {
-        if (this->wantedSettings.vane == nullptr) { // to prevent a nullpointer error
-            this->wantedSettings.vane = this->currentSettings.vane;
+    if ((settings.vane != nullptr) || (settings.wideVane != nullptr)) {
+        if (settings.vane == nullptr) { // to prevent a nullpointer error
+            settings.vane = this->currentSettings.vane;
         }
-        if (this->wantedSettings.wideVane == nullptr) { // to prevent a nullpointer error
-            this->wantedSettings.wideVane = this->currentSettings.wideVane;
+        if (settings.wideVane == nullptr) { // to prevent a nullpointer error
+            settings.wideVane = this->currentSettings.wideVane;
         }
 
-        checkVaneSettings(this->wantedSettings, false);
+        checkVaneSettings(settings, false);
     }
 
     // HA Temp
-    this->updateTargetTemperaturesFromSettings(this->getTemperatureSetting());
+    this->updateTargetTemperaturesFromSettings(this->getTemperatureSetting(settings));
 
-    // publish to HA
+    // publish to HA (now, right after the confirmed write: this also carries whatever the decoders had marked)
     this->publish_state();
+    this->publish_dirty_ &= ~PUBLISH_DIRTY_CLIMATE;
 
 }
 
@@ -345,21 +363,91 @@ void CN105Climate::publishWantedRunStatesStateToHA() {
 }
 
 
+/**
+ * emulator_proxy_mode: a SET frame coming from the wall remote goes to the heatpump as is.
+ * When the bus is idle it is written right away, otherwise it takes the slot of the next
+ * INFO request of the running cycle (see getDataFromResponsePacket()).
+*/
+bool CN105Climate::proxySetPacket(const uint8_t* packet, int length) {
+    if (length <= 0 || length > PACKET_LEN) {
+        ESP_LOGW(TAG, "proxy: dropping SET frame of %d bytes", length);
+        return false;
+    }
+    if (this->proxy_packet_pending_) {
+        ESP_LOGD(TAG, "proxy: previous SET frame not sent yet, replaced by the newer one");
+    }
+    memcpy(this->proxy_packet_, packet, static_cast<size_t>(length));
+    this->proxy_packet_len_ = length;
+    this->proxy_packet_pending_ = true;
+
+    if (this->isHeatpumpConnected_ && !this->loopCycle.isCycleRunning()) {
+        this->flushProxyPacket();
+    }
+    return true;
+}
+
+void CN105Climate::flushProxyPacket() {
+    if (!this->proxy_packet_pending_) return;
+    this->proxy_packet_pending_ = false;
+    ESP_LOGI(TAG, "proxy: forwarding remote SET frame");
+    this->writePacket(this->proxy_packet_, this->proxy_packet_len_);
+    if (!this->loopCycle.isCycleRunning()) {
+        // comme pour sendWantedSettings: on laisse la PAC traiter la trame avant le prochain cycle
+        this->loopCycle.deferCycle();
+    }
+}
+
+void CN105Climate::settingsWriteAck() {
+    // un 0x61 n'acquitte que la dernière trame écrite: ignorer l'ACK d'une trame proxy ou de fonctions
+    if (!this->settings_ack_waiting_ || this->last_write_command_ != 0x41 || this->last_write_code_ != HEADER[5]) {
+        return;
+    }
+    this->settings_ack_waiting_ = false;
+    this->cancel_timeout("settingsAck");
+    this->publishWantedSettingsStateToHA(this->settings_ack_pending_);
+}
+
+void CN105Climate::resumeAfterProxy() {
+    if (!this->proxy_resume_pending_) return;
+    this->proxy_resume_pending_ = false;
+    if (this->loopCycle.isCycleRunning()) {
+        this->scheduler_.send_next_after(this->proxy_resume_code_);
+    }
+}
+
 void CN105Climate::sendWantedSettingsDelegate() {
+    // latest consistent snapshot published by control(), the selects or the emulator
+    wantedHeatpumpSettings toSend;
+    const uint32_t version = this->wantedSettingsSlot_.read(toSend);
+    toSend.hasBeenSent = true;
     this->wantedSettings.hasBeenSent = true;
     this->lastSend = CUSTOM_MILLIS;
     ESP_LOGI(TAG, "sending wantedSettings..");
-    this->debugSettings("wantedSettings", wantedSettings);
+    this->debugSettings("wantedSettings", toSend);
     // and then we send the update packet
     uint8_t packet[PACKET_LEN] = {};
-    this->createPacket(packet);
+    this->createPacket(packet, toSend);
     this->writePacket(packet, PACKET_LEN);
     this->hpPacketDebug(packet, 22, "WRITE_SETTINGS");
 
-    this->publishWantedSettingsStateToHA();
+    // publication vers HA à l'ACK 0x61 (settingsWriteAck), pas à l'envoi
+    this->settings_ack_pending_ = toSend;
+    this->settings_ack_waiting_ = true;
+    this->set_timeout("settingsAck", SETTINGS_ACK_TIMEOUT_MS, [this]() {
+        if (!this->settings_ack_waiting_) return;
+        this->settings_ack_waiting_ = false;
+        // le prochain 0x02 publiera l'état réel de la PAC
+        ESP_LOGW(TAG, "no 0x61 for the settings write, not publishing the requested state");
+        });
 
     // as soon as the packet is sent, we reset the settings
-    this->wantedSettings.resetSettings();
+    // unless a newer snapshot was published meanwhile: it stays pending for the next send
+    if (this->wantedSettingsSlot_.version() == version) {
+        this->wantedSettings.resetSettings();
+        this->wantedSettingsSlot_.publish(this->wantedSettings);
+    } else {
+        ESP_LOGD(TAG, "wantedSettings changed while sending, keeping the newer request pending");
+    }
 
     // as we've just sent a packet to the heatpump, we let it time for process
     // this might not be necessary but, we give it a try because of issue #32
@@ -378,13 +466,7 @@ void CN105Climate::sendWantedSettings() {
 
             //this->cycleEnded();   // only if we let the cycle be interrupted to send wented settings
 
-#ifdef USE_ESP32
-            std::lock_guard<std::mutex> guard(wantedSettingsMutex);
             this->sendWantedSettingsDelegate();
-#else
-            this->emulateMutex("WRITE_SETTINGS", std::bind(&CN105Climate::sendWantedSettingsDelegate, this));
-
-#endif
 
         } else {
             ESP_LOGD(TAG, "will sendWantedSettings later because we've sent one too recently...");
@@ -422,7 +504,7 @@ void CN105Climate::buildAndSendInfoPacket(uint8_t code) {
 void CN105Climate::buildAndSendRequestsInfoPackets() {
     if (this->isHeatpumpConnected_) {
         ESP_LOGV(LOG_UPD_INT_TAG, "triggering infopacket because of update interval tick");
-        ESP_LOGV("CONTROL_WANTED_SETTINGS", "hasChanged is %s", wantedSettings.hasChanged ? "true" : "false");
+        ESP_LOGV("CONTROL_WANTED_SETTINGS", "hasChanged is %s", this->getCommittedWantedSettings().hasChanged ? "true" : "false");
         this->loopCycle.cycleStarted();
         this->nbCycles_++;
         // Envoie la première requête activable (la liste est enregistrée une fois au constructeur)
@@ -1,12 +1,11 @@
 #pragma once
 
-#include "esphome/components/sensor/sensor.h"
-#include "esphome/core/component.h"
+#include "throttled_sensor.h"
 
 
 namespace esphome {
 
-    class kWhSensor : public sensor::Sensor, public Component {
+    class kWhSensor : public ThrottledSensor {
     public:
         kWhSensor() {
             this->set_unit_of_measurement("kWh");
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+
+    /**
+     * @class LinkMonitor
+     * @brief Détection rapide de la perte du lien CN105 et reconnexion avec backoff.
+     *
+     * Chaque trame écrite attend une réponse. Sans réponse après responseTimeoutMs, c'est un battement
+     * manqué (l'appelant retransmet la requête en attente: un nouveau battement). Après missLimit battements
+     * manqués consécutifs, le lien est déclaré perdu et les reconnexions sont cadencées par un backoff
+     * exponentiel (retryMinMs .. retryMaxMs). La première réponse qui suit rétablit le lien.
+     *
+     * poll() est appelé à chaque passage du loop et renvoie au plus un événement à traiter.
+     */
+    class LinkMonitor {
+    public:
+        enum class Event : uint8_t { NONE, MISSED, LOST, RETRY, RECOVERED };
+
+        void configure(uint32_t responseTimeoutMs, uint8_t missLimit, uint32_t retryMinMs, uint32_t retryMaxMs) {
+            this->responseTimeoutMs_ = responseTimeoutMs;
+            this->missLimit_ = missLimit;
+            this->retryMinMs_ = retryMinMs;
+            this->retryMaxMs_ = retryMaxMs;
+        }
+
+        /// une trame vient d'être écrite: la fenêtre d'attente repart de maintenant
+        void requestSent(uint32_t nowMs) {
+            this->awaiting_ = true;
+            this->sentMs_ = nowMs;
+        }
+
+        /// trame valide reçue de la PAC
+        void responseReceived(uint32_t nowMs) {
+            this->awaiting_ = false;
+            this->missed_ = 0;
+            this->lastResponseMs_ = nowMs;
+            if (this->lost_) {
+                this->lost_ = false;
+                this->recoveredPending_ = true;
+                this->lastReconnectMs_ = nowMs - this->lostAtMs_;
+            }
+        }
+
+        Event poll(uint32_t nowMs) {
+            if (this->recoveredPending_) {
+                this->recoveredPending_ = false;
+                return Event::RECOVERED;
+            }
+            if (this->lost_) {
+                if ((int32_t)(nowMs - this->nextRetryMs_) < 0) {
+                    return Event::NONE;
+                }
+                this->attempts_++;
+                this->nextRetryMs_ = nowMs + this->retryDelay();
+                return Event::RETRY;
+            }
+            if (!this->awaiting_ || nowMs - this->sentMs_ < this->responseTimeoutMs_) {
+                return Event::NONE;
+            }
+            this->awaiting_ = false;
+            if (++this->missed_ < this->missLimit_) {
+                return Event::MISSED;
+            }
+            this->lost_ = true;
+            this->losses_++;
+            this->lostAtMs_ = nowMs;
+            this->lastDetectionMs_ = nowMs - this->lastResponseMs_;
+            this->attempts_ = 0;
+            this->nextRetryMs_ = nowMs;     // première tentative tout de suite
+            return Event::LOST;
+        }
+
+        /// délai avant la prochaine échéance (timeout de réponse ou tentative), UINT32_MAX si aucune
+        uint32_t msUntilDeadline(uint32_t nowMs) const {
+            if (this->recoveredPending_) return 0;
+            uint32_t due;
+            if (this->lost_) {
+                due = this->nextRetryMs_;
+            } else if (this->awaiting_) {
+                due = this->sentMs_ + this->responseTimeoutMs_;
+            } else {
+                return UINT32_MAX;
+            }
+            return ((int32_t)(due - nowMs) > 0) ? due - nowMs : 0;
+        }
+
+        bool is_lost() const { return this->lost_; }
+        uint8_t get_missed() const { return this->missed_; }
+        uint32_t get_losses() const { return this->losses_; }
+        uint32_t get_attempts() const { return this->attempts_; }
+        uint32_t get_last_response_ms() const { return this->lastResponseMs_; }
+        /// dernière perte: délai entre la dernière réponse et la détection
+        uint32_t get_last_detection_ms() const { return this->lastDetectionMs_; }
+        /// dernière perte: délai entre la détection et la première réponse qui a suivi
+        uint32_t get_last_reconnect_ms() const { return this->lastReconnectMs_; }
+
+    private:
+        uint32_t retryDelay() const {
+            uint32_t delay = this->retryMinMs_;
+            for (uint32_t i = 1; i < this->attempts_ && delay < this->retryMaxMs_; i++) {
+                delay *= 2;
+            }
+            return (delay < this->retryMaxMs_) ? delay : this->retryMaxMs_;
+        }
+
+        uint32_t responseTimeoutMs_{ 1000 };
+        uint8_t missLimit_{ 3 };
+        uint32_t retryMinMs_{ 500 };
+        uint32_t retryMaxMs_{ 15000 };
+
+        bool awaiting_{ false };
+        uint32_t sentMs_{ 0 };
+        uint8_t missed_{ 0 };
+        uint32_t lastResponseMs_{ 0 };
+
+        bool lost_{ false };
+        bool recoveredPending_{ false };
+        uint32_t lostAtMs_{ 0 };
+        uint32_t nextRetryMs_{ 0 };
+        uint32_t attempts_{ 0 };
+        uint32_t losses_{ 0 };
+        uint32_t lastDetectionMs_{ 0 };
+        uint32_t lastReconnectMs_{ 0 };
+    };
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace esphome {
+
+    /**
+     * @class LinkStats
+     * @brief Comptabilité du lien CN105: octets et trames par code, erreurs, timeouts soft, reconnexions.
+     *
+     * Les trames sont rangées par (commande, code): 0x42/0x02 pour une requête INFO 0x02, 0x62/0x02 pour sa
+     * réponse, 0x41/0x01 pour un SET de settings... dans un tableau fixe de MAX_CODES entrées.
+     * busyPermille() donne l'occupation du lien sur la fenêtre écoulée depuis l'appel précédent, rapportée à la
+     * capacité théorique (11 bits par octet en 8E1).
+     *
+     * serialize() produit un blob binaire compact (little-endian) pour l'analyse hors ligne:
+     *  u8 version, u8 nb entrées, u16 busy (‰), u32 baud, u32 uptime ms,
+     *  u32 x 10: tx bytes, rx bytes, tx frames, rx frames, checksum, header, overflow, reconnects, cycles, cycles complets
+     *  puis par entrée: u8 commande, u8 code, u16 timeouts soft, u32 tx frames, u32 rx frames
+     */
+    class LinkStats {
+    public:
+        static constexpr uint8_t FORMAT_VERSION = 1;
+        static constexpr uint8_t MAX_CODES = 24;
+        static constexpr size_t HEADER_SIZE = 52;
+        static constexpr size_t ENTRY_SIZE = 12;
+        static constexpr size_t MAX_BLOB_SIZE = HEADER_SIZE + ENTRY_SIZE * MAX_CODES;
+        static constexpr uint8_t BITS_PER_BYTE = 11;    // start + 8 data + parité + stop
+
+        struct CodeCounters {
+            uint8_t command;
+            uint8_t code;
+            uint16_t softTimeouts;
+            uint32_t tx;
+            uint32_t rx;
+        };
+
+        void onTx(const uint8_t* packet, int length) {
+            this->txBytes_ += length;
+            this->txFrames_++;
+            CodeCounters* c = this->entry(packet[1], (length > 5) ? packet[5] : 0);
+            if (c != nullptr) c->tx++;
+        }
+        /// trame complète reçue (header + data + checksum), valide ou non
+        void onRxFrame(const uint8_t* frame, int length) {
+            this->rxBytes_ += length;
+            this->rxFrames_++;
+            CodeCounters* c = this->entry(frame[1], (length > 6) ? frame[5] : 0);
+            if (c != nullptr) c->rx++;
+        }
+        /// octets reçus hors trame (bruit, début de trame perdu)
+        void onNoise(uint32_t bytes) { this->rxBytes_ += bytes; }
+        void onChecksumFailure(uint32_t count = 1) { this->checksumFailures_ += count; }
+        void onHeaderMismatch() { this->headerMismatches_++; }
+        void onOverflowReset(uint32_t count = 1) { this->overflowResets_ += count; }
+        void onReconnect() { this->reconnects_++; }
+        /// compteur de timeouts soft tenu par le RequestScheduler (requête INFO 0x42)
+        void setSoftTimeouts(uint8_t code, uint32_t count) {
+            if (count == 0) return;
+            CodeCounters* c = this->entry(0x42, code);
+            if (c != nullptr) c->softTimeouts = (count > UINT16_MAX) ? UINT16_MAX : (uint16_t)count;
+        }
+
+        /// occupation du lien (‰) depuis l'appel précédent, puis nouvelle fenêtre
+        uint16_t busyPermille(uint32_t nowMs, uint32_t baud) {
+            const uint32_t bytes = (this->txBytes_ + this->rxBytes_) - this->windowBytes_;
+            const uint32_t elapsedMs = nowMs - this->windowStartMs_;
+            this->windowBytes_ = this->txBytes_ + this->rxBytes_;
+            this->windowStartMs_ = nowMs;
+            if (elapsedMs == 0 || baud == 0) return this->lastBusy_;
+            const uint64_t permille = (uint64_t)bytes * BITS_PER_BYTE * 1000 * 1000 / ((uint64_t)baud * elapsedMs);
+            this->lastBusy_ = (permille > 1000) ? 1000 : (uint16_t)permille;
+            return this->lastBusy_;
+        }
+
+        size_t serialize(uint8_t* out, size_t max, uint32_t baud, uint32_t nowMs, uint32_t cycles, uint32_t completeCycles) const {
+            if (max < HEADER_SIZE) return 0;
+            uint8_t* p = out;
+            *p++ = FORMAT_VERSION;
+            *p++ = this->count_;
+            p = put16(p, this->lastBusy_);
+            p = put32(p, baud);
+            p = put32(p, nowMs);
+            const uint32_t totals[10] = { this->txBytes_, this->rxBytes_, this->txFrames_, this->rxFrames_, this->checksumFailures_,
+                this->headerMismatches_, this->overflowResets_, this->reconnects_, cycles, completeCycles };
+            for (uint32_t v : totals) p = put32(p, v);
+            for (uint8_t i = 0; i < this->count_ && (size_t)(p - out) + ENTRY_SIZE <= max; i++) {
+                const CodeCounters& c = this->codes_[i];
+                *p++ = c.command;
+                *p++ = c.code;
+                p = put16(p, c.softTimeouts);
+                p = put32(p, c.tx);
+                p = put32(p, c.rx);
+            }
+            return (size_t)(p - out);
+        }
+
+        uint32_t get_tx_bytes() const { return this->txBytes_; }
+        uint32_t get_rx_bytes() const { return this->rxBytes_; }
+        uint32_t get_tx_frames() const { return this->txFrames_; }
+        uint32_t get_rx_frames() const { return this->rxFrames_; }
+        uint32_t get_errors() const { return this->checksumFailures_ + this->headerMismatches_ + this->overflowResets_; }
+        uint32_t get_checksum_failures() const { return this->checksumFailures_; }
+        uint32_t get_header_mismatches() const { return this->headerMismatches_; }
+        uint32_t get_overflow_resets() const { return this->overflowResets_; }
+        uint32_t get_reconnects() const { return this->reconnects_; }
+
+    private:
+        CodeCounters* entry(uint8_t command, uint8_t code) {
+            for (uint8_t i = 0; i < this->count_; i++) {
+                if (this->codes_[i].command == command && this->codes_[i].code == code) return &this->codes_[i];
+            }
+            if (this->count_ == MAX_CODES) return nullptr;     // les totaux restent justes
+            this->codes_[this->count_] = CodeCounters{ command, code, 0, 0, 0 };
+            return &this->codes_[this->count_++];
+        }
+        static uint8_t* put16(uint8_t* p, uint16_t v) {
+            p[0] = v & 0xFF; p[1] = v >> 8;
+            return p + 2;
+        }
+        static uint8_t* put32(uint8_t* p, uint32_t v) {
+            for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF;
+            return p + 4;
+        }
+
+        uint32_t txBytes_{ 0 };
+        uint32_t rxBytes_{ 0 };
+        uint32_t txFrames_{ 0 };
+        uint32_t rxFrames_{ 0 };
+        uint32_t checksumFailures_{ 0 };
+        uint32_t headerMismatches_{ 0 };
+        uint32_t overflowResets_{ 0 };
+        uint32_t reconnects_{ 0 };
+        uint32_t windowBytes_{ 0 };
+        uint32_t windowStartMs_{ 0 };
+        uint16_t lastBusy_{ 0 };
+        uint8_t count_{ 0 };
+        CodeCounters codes_[MAX_CODES]{};
+    };
+
+}
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <algorithm>
-#include <vector>
+#include <cmath>
+#include <cstdint>
 
 namespace esphome {
     enum class FahrenheitMode {
@@ -10,92 +10,135 @@ namespace esphome {
         ALT = 2
     };
 
+    namespace fahrenheit_tables {
+
+        static constexpr int F_MIN = 61;
+        static constexpr int F_COUNT = 28;          // 61..88 °F
+        static constexpr float C_MIN = 16.0f;
+        static constexpr int MAX_HALF_STEPS = 32;   // 16.0..31.5 °C
+
+        // Given a temperature in Celsius that was converted from Fahrenheit, converts
+        // it to the Celsius value (at half-degree precision) that matches what
+        // Mitsubishi thermostats would have converted the Fahrenheit value to. For
+        // instance, 72°F is 22.22°C, but this class returns 22.5°C.
+        // Index: °F - F_MIN
+        static constexpr float STANDARD[F_COUNT] = {
+            16.0, 16.5, 17.0, 17.5, 18.0,
+            18.5, 19.0, 20.0, 21.0, 21.5,
+            22.0, 22.5, 23.0, 23.5, 24.0,
+            24.5, 25.0, 25.5, 26.0, 26.5,
+            27.0, 27.5, 28.0, 28.5, 29.0,
+            29.5, 30.0, 30.5
+        };
+        static constexpr float ALT[F_COUNT] = {
+            16.0, 16.5, 17.0, 18.0, 18.5,
+            19.0, 19.5, 20.0, 20.5, 21.0,
+            21.5, 22.0, 23.0, 23.5, 24.0,
+            24.5, 25.0, 25.5, 26.0, 26.5,
+            27.0, 28.0, 28.5, 29.0, 29.5,
+            30.0, 30.5, 31.0
+        };
+
+        // Reverse direction, indexed by half-degree step from C_MIN: the °F whose
+        // Mitsubishi Celsius is the closest (ties go to the higher entry).
+        // Steps from the last table Celsius up are out of range (count).
+        struct HalfStepTable {
+            uint8_t fahrenheit[MAX_HALF_STEPS];
+            int count;
+        };
+
+        constexpr float absf(float v) { return v < 0 ? -v : v; }
+
+        constexpr HalfStepTable buildHalfStepTable(const float (&celsius)[F_COUNT]) {
+            HalfStepTable table{};
+            table.count = (int)((celsius[F_COUNT - 1] - C_MIN) * 2.0f);
+            for (int i = 0; i < table.count; i++) {
+                const float c = C_MIN + i * 0.5f;
+                int upper = 0;
+                while (celsius[upper] <= c) upper++;    // first entry above c (always exists: c < last)
+                const int lower = upper - 1;
+                const int best = absf(celsius[lower] - c) < absf(celsius[upper] - c) ? lower : upper;
+                table.fahrenheit[i] = (uint8_t)(F_MIN + best);
+            }
+            return table;
+        }
+
+        static constexpr HalfStepTable HALF_STEP_STANDARD = buildHalfStepTable(STANDARD);
+        static constexpr HalfStepTable HALF_STEP_ALT = buildHalfStepTable(ALT);
+
+        constexpr bool isStrictlyIncreasing(const float (&celsius)[F_COUNT]) {
+            for (int i = 1; i < F_COUNT; i++) {
+                if (celsius[i] <= celsius[i - 1]) return false;
+            }
+            return true;
+        }
+
+        // °F -> Celsius -> °F gives the same °F back, and every half step maps to a °F
+        // whose Celsius is less than half a degree away
+        constexpr bool roundTrips(const float (&celsius)[F_COUNT], const HalfStepTable& table) {
+            for (int f = 0; f < F_COUNT - 1; f++) {
+                const int step = (int)((celsius[f] - C_MIN) * 2.0f);
+                if (step >= table.count || table.fahrenheit[step] != F_MIN + f) return false;
+            }
+            for (int i = 0; i < table.count; i++) {
+                const int f = table.fahrenheit[i] - F_MIN;
+                if (f < 0 || f >= F_COUNT || absf(celsius[f] - (C_MIN + i * 0.5f)) > 0.5f) return false;
+            }
+            return true;
+        }
+
+        static_assert(isStrictlyIncreasing(STANDARD) && isStrictlyIncreasing(ALT), "Fahrenheit tables must be sorted");
+        static_assert(HALF_STEP_STANDARD.count == 29 && HALF_STEP_ALT.count == 30, "unexpected half step range");
+        static_assert(roundTrips(STANDARD, HALF_STEP_STANDARD), "STANDARD Fahrenheit table does not round trip");
+        static_assert(roundTrips(ALT, HALF_STEP_ALT), "ALT Fahrenheit table does not round trip");
+        static_assert(HALF_STEP_STANDARD.fahrenheit[(int)((22.5f - C_MIN) * 2)] == 72, "22.5°C must show 72°F (STANDARD)");
+        static_assert(HALF_STEP_ALT.fahrenheit[(int)((22.0f - C_MIN) * 2)] == 72, "22.0°C must show 72°F (ALT)");
+    }
+
     class FahrenheitSupport {
     public:
         void setUseFahrenheitSupportMode(FahrenheitMode mode) {
             fahrenheit_mode_ = mode;
         }
 
-        float normalizeHeatpumpTemperatureToUiTemperature(const float c) {
-            if (fahrenheit_mode_ == FahrenheitMode::OFF || c == NAN) {
+        // Heat pump temperatures come in half degrees (setpoint, room, OAT): direct index, no search
+        float normalizeHeatpumpTemperatureToUiTemperature(const float c) const {
+            if (fahrenheit_mode_ == FahrenheitMode::OFF || std::isnan(c)) {
                 return c; // If disabled, return the Celsius value as is.
             }
 
-            // Select the appropriate conversion table based on mode
-            const std::vector<std::pair<float, float>>& localTable =
-                (fahrenheit_mode_ == FahrenheitMode::ALT) ? fahrenheitToCelsiusTableAlt : fahrenheitToCelsiusTable;
-
-            auto it = std::upper_bound(
-                localTable.begin(),
-                localTable.end(),
-                std::make_pair(0.0f, c),
-                [](const std::pair<float, float>& a, const std::pair<float, float>& b) {
-                    return a.second < b.second;  // compare Celsius
-                }
-            );
-
-            if (it == localTable.begin() || it == localTable.end()) {
+            const bool alt = (fahrenheit_mode_ == FahrenheitMode::ALT);
+            const fahrenheit_tables::HalfStepTable& table = alt ? fahrenheit_tables::HALF_STEP_ALT : fahrenheit_tables::HALF_STEP_STANDARD;
+            const float lastCelsius = alt ? fahrenheit_tables::ALT[fahrenheit_tables::F_COUNT - 1] : fahrenheit_tables::STANDARD[fahrenheit_tables::F_COUNT - 1];
+            if (c < fahrenheit_tables::C_MIN || c >= lastCelsius) {
                 return c;
             }
 
-            auto prev = it;
-            --prev;
-            float fahrenheitResult = std::abs(prev->second - c) < std::abs(it->second - c) ? prev->first : it->first;
+            int step = (int)std::floor((c - fahrenheit_tables::C_MIN) * 2.0f + 0.5f);
+            if (step >= table.count) step = table.count - 1;
+            float fahrenheitResult = table.fahrenheit[step];
 
             return (fahrenheitResult - 32.0f) / 1.8f;
         }
 
-        float normalizeUiTemperatureToHeatpumpTemperature(const float c) {
-            if (fahrenheit_mode_ == FahrenheitMode::OFF || c == NAN) {
+        float normalizeUiTemperatureToHeatpumpTemperature(const float c) const {
+            if (fahrenheit_mode_ == FahrenheitMode::OFF || std::isnan(c)) {
                 return c; // If disabled, return the Celsius value as is.
             }
 
-            // Select the appropriate conversion table based on mode
-            const std::vector<std::pair<float, float>>& localTable =
-                (fahrenheit_mode_ == FahrenheitMode::ALT) ? fahrenheitToCelsiusTableAlt : fahrenheitToCelsiusTable;
-
             float fahrenheitInput = (c * 1.8f) + 32.0f;
 
             // Due to vagaries of floating point math across architectures, we can't
-            // just look up `c` in the map -- we're very unlikely to find a matching
-            // value. Instead, we find the first value greater than `c`, and the
-            // next-lowest value in the map. We return whichever `c` is closer to.
-            auto it = std::upper_bound(localTable.begin(), localTable.end(), std::make_pair(fahrenheitInput, 0.0f),
-                [](const std::pair<float, float>& a, const std::pair<float, float>& b) {
-                    return a.first < b.first;
-                });
-            if (it == localTable.begin() || it == localTable.end()) {
+            // expect an exact °F: the closest whole °F is taken (ties go up).
+            if (fahrenheitInput < fahrenheit_tables::F_MIN || fahrenheitInput >= fahrenheit_tables::F_MIN + fahrenheit_tables::F_COUNT - 1) {
                 return c;
             }
+            const int index = (int)std::floor(fahrenheitInput + 0.5f) - fahrenheit_tables::F_MIN;
 
-            auto prev = it;
-            --prev;
-
-            return std::abs(prev->first - fahrenheitInput) < std::abs(it->first - fahrenheitInput) ? prev->second : it->second;
+            return (fahrenheit_mode_ == FahrenheitMode::ALT) ? fahrenheit_tables::ALT[index] : fahrenheit_tables::STANDARD[index];
         }
 
     private:
         FahrenheitMode fahrenheit_mode_ = FahrenheitMode::OFF;
-
-        // Given a temperature in Celsius that was converted from Fahrenheit, converts
-        // it to the Celsius value (at half-degree precision) that matches what
-        // Mitsubishi thermostats would have converted the Fahrenheit value to. For
-        // instance, 72°F is 22.22°C, but this class returns 22.5°C.
-        const std::vector<std::pair<float, float>> fahrenheitToCelsiusTable = {
-            {61, 16.0}, {62, 16.5}, {63, 17.0}, {64, 17.5}, {65, 18.0},
-            {66, 18.5}, {67, 19.0}, {68, 20.0}, {69, 21.0}, {70, 21.5},
-            {71, 22.0}, {72, 22.5}, {73, 23.0}, {74, 23.5}, {75, 24.0},
-            {76, 24.5}, {77, 25.0}, {78, 25.5}, {79, 26.0}, {80, 26.5},
-            {81, 27.0}, {82, 27.5}, {83, 28.0}, {84, 28.5}, {85, 29.0},
-            {86, 29.5}, {87, 30.0}, {88, 30.5}
-        };
-        const std::vector<std::pair<float, float>> fahrenheitToCelsiusTableAlt = {
-            {61, 16.0}, {62, 16.5}, {63, 17.0}, {64, 18.0}, {65, 18.5},
-            {66, 19.0}, {67, 19.5}, {68, 20.0}, {69, 20.5}, {70, 21.0},
-            {71, 21.5}, {72, 22.0}, {73, 23.0}, {74, 23.5}, {75, 24.0},
-            {76, 24.5}, {77, 25.0}, {78, 25.5}, {79, 26.0}, {80, 26.5},
-            {81, 27.0}, {82, 28.0}, {83, 28.5}, {84, 29.0}, {85, 29.5},
-            {86, 30.0}, {87, 30.5}, {88, 31.0}
-        };
     };
 }
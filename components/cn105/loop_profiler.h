@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Globals.h"
+#include "alloc_counter.h"
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+
+    /**
+     * @class LoopProfiler
+     * @brief Temps passé dans chaque phase de CN105Climate::loop() (µs): min, moyenne, max et p99.
+     *
+     * Accumulateurs de taille fixe, sans allocation: le p99 est lu dans un histogramme log-linéaire
+     * (4 sous-classes par octave, soit au plus ~25 % d'erreur par excès) qui couvre 0 µs .. ~260 ms;
+     * au-delà, seul le max reste exact.
+     * Les phases sont inclusives et peuvent s'imbriquer: DECODE est compté aussi dans INPUT, PUBLISH
+     * dans DECODE quand la fin de cycle publie. PASS est le passage complet dans loop().
+     * Avec CN105_ALLOC_TRACKING, chaque phase compte aussi les allocations faites pendant sa mesure (AllocCounter).
+     */
+    class LoopProfiler {
+    public:
+        enum Phase : uint8_t { PASS, CONNECTION, LINK, INPUT, DECODE, PUBLISH, SCHEDULE, IDLE_SLEEP, PHASE_COUNT };
+
+        static const char* phase_name(uint8_t phase) {
+            static const char* const NAMES[PHASE_COUNT] = { "pass", "connection", "link", "input", "decode", "publish", "schedule", "idle_sleep" };
+            return (phase < PHASE_COUNT) ? NAMES[phase] : "?";
+        }
+
+        struct Stats {
+            uint32_t count;
+            uint32_t min_us;
+            uint32_t max_us;
+            uint64_t total_us;
+            uint32_t allocs;
+            uint32_t mean_us() const { return count ? (uint32_t)(total_us / count) : 0; }
+        };
+
+        /// mesure d'une phase sur la portée courante (rien si le profiler est désactivé)
+        class Scope {
+        public:
+            Scope(LoopProfiler& profiler, Phase phase, uint32_t nowUs) :
+                profiler_(profiler.enabled_ ? &profiler : nullptr), phase_(phase), startUs_(nowUs), startAllocs_(AllocCounter::count()) {
+            }
+            ~Scope();
+        private:
+            LoopProfiler* profiler_;
+            Phase phase_;
+            uint32_t startUs_;
+            uint32_t startAllocs_;
+        };
+
+        void set_enabled(bool enabled) {
+            this->enabled_ = enabled;
+            this->reset();
+        }
+        bool is_enabled() const { return this->enabled_; }
+
+        void add(Phase phase, uint32_t us, uint32_t allocs = 0) {
+            Stats& s = this->stats_[phase];
+            s.allocs += allocs;
+            if (s.count == 0 || us < s.min_us) s.min_us = us;
+            if (us > s.max_us) s.max_us = us;
+            s.count++;
+            s.total_us += us;
+            this->histogram_[phase][bucketOf(us)]++;
+        }
+
+        const Stats& stats(uint8_t phase) const { return this->stats_[phase]; }
+
+        /// borne haute de la classe qui contient le 99e centile
+        uint32_t p99_us(uint8_t phase) const {
+            const uint32_t count = this->stats_[phase].count;
+            if (count == 0) return 0;
+            const uint32_t rank = count - count / 100;      // échantillons à couvrir
+            uint32_t seen = 0;
+            for (uint8_t b = 0; b < BUCKETS; b++) {
+                seen += this->histogram_[phase][b];
+                if (seen >= rank) {
+                    const uint32_t upper = bucketUpper(b);
+                    return (upper < this->stats_[phase].max_us) ? upper : this->stats_[phase].max_us;
+                }
+            }
+            return this->stats_[phase].max_us;
+        }
+
+        void reset() {
+            memset(this->stats_, 0, sizeof(this->stats_));
+            memset(this->histogram_, 0, sizeof(this->histogram_));
+        }
+
+    private:
+        static constexpr uint8_t BUCKETS = 72;     // 4 classes exactes (0..3 µs) puis 4 par octave jusqu'à 2^18 µs
+
+        static uint8_t bucketOf(uint32_t us) {
+            if (us < 4) return (uint8_t)us;
+            const uint8_t e = 31 - __builtin_clz(us);
+            const uint32_t index = 4u * (e - 1) + ((us >> (e - 2)) & 3);
+            return (index < BUCKETS) ? (uint8_t)index : BUCKETS - 1;
+        }
+
+        static uint32_t bucketUpper(uint8_t b) {
+            if (b < 4) return b;
+            const uint8_t e = b / 4 + 1;
+            return ((4u + (b & 3)) << (e - 2)) + (1u << (e - 2)) - 1;
+        }
+
+        bool enabled_{ false };
+        Stats stats_[PHASE_COUNT]{};
+        uint32_t histogram_[PHASE_COUNT][BUCKETS]{};     // 32 bits: même compte que Stats::count, pas de saturation
+    };
+
+    inline LoopProfiler::Scope::~Scope() {
+        if (this->profiler_ != nullptr) {
+            this->profiler_->add(this->phase_, CUSTOM_MICROS - this->startUs_, AllocCounter::count() - this->startAllocs_);
+        }
+    }
+
+}
@@ -16,8 +16,9 @@ timeout_callback_(timeout_callback),
 terminate_callback_(terminate_callback),
 context_callback_(context_callback) {}
 
-void RequestScheduler::register_request(InfoRequest& req) {
-    requests_.push_back(req);
+void RequestScheduler::register_request(InfoRequest req) {
+    // timeout_name est toujours posé par le constructeur d'InfoRequest
+    requests_.push_back(std::move(req));
 }
 
 void RequestScheduler::clear_requests() {
@@ -34,10 +35,55 @@ void RequestScheduler::disable_request(uint8_t code) {
     }
 }
 
+void RequestScheduler::mark_requested(uint8_t code) {
+    for (auto& req : requests_) {
+        if (req.code == code) {
+            req.last_request_time = CUSTOM_MILLIS;
+            req.requested_once = true;
+            break;
+        }
+    }
+}
+
+uint32_t RequestScheduler::soft_timeouts(uint8_t code) const {
+    for (const auto& req : requests_) {
+        if (req.code == code) {
+            return req.soft_timeouts;
+        }
+    }
+    return 0;
+}
+
+bool RequestScheduler::is_disabled(uint8_t code) const {
+    for (const auto& req : requests_) {
+        if (req.code == code) {
+            return req.disabled;
+        }
+    }
+    return false;
+}
+
+int RequestScheduler::awaiting_code() const {
+    if (current_request_index_ < 0 || current_request_index_ >= static_cast<int>(requests_.size())) {
+        return -1;
+    }
+    const auto& req = requests_[current_request_index_];
+    return req.awaiting ? req.code : -1;
+}
+
 bool RequestScheduler::is_empty() const {
     return requests_.empty();
 }
 
+bool RequestScheduler::handles(uint8_t code) const {
+    for (const auto& req : requests_) {
+        if (req.code == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void RequestScheduler::send_request(uint8_t code, CN105Climate* context) {
     // Obtenir le contexte si non fourni mais que le callback est disponible
     if (!context && context_callback_) {
@@ -61,6 +107,7 @@ void RequestScheduler::send_request(uint8_t code, CN105Climate* context) {
 
         req.awaiting = true;
         req.last_request_time = CUSTOM_MILLIS;
+        req.requested_once = true;
 
         // Envoyer le paquet via le callback
         if (send_callback_) {
@@ -70,11 +117,8 @@ void RequestScheduler::send_request(uint8_t code, CN105Climate* context) {
         // Gérer le timeout si configuré et si le callback est disponible
         if (req.soft_timeout_ms > 0 && timeout_callback_) {
             uint8_t code_copy = req.code;
-            const std::string tname = req.timeout_name.empty() ?
-                (std::string("info_timeout_") + std::to_string(code_copy)) :
-                req.timeout_name;
-
-            timeout_callback_(tname, req.soft_timeout_ms, [this, code_copy]() {
+            // nom stable (set_timeout garde le pointeur) et sans copie: aucune allocation par requête
+            timeout_callback_(req.timeout_name, req.soft_timeout_ms, [this, code_copy]() {
                 // Obtenir le contexte pour send_next_after
                 CN105Climate* ctx = nullptr;
                 if (this->context_callback_) {
@@ -86,6 +130,7 @@ void RequestScheduler::send_request(uint8_t code, CN105Climate* context) {
                     if (r.code == code_copy && r.awaiting) {
                         r.awaiting = false;
                         r.failures++;
+                        r.soft_timeouts++;
                         ESP_LOGW(LOG_CYCLE_TAG, "Soft timeout for %s (0x%02X), failures: %d",
                             r.description, r.code, r.failures);
                         if (r.failures >= r.maxFailures) {
@@ -161,7 +206,8 @@ void RequestScheduler::send_next_after(uint8_t previous_code, CN105Climate* cont
             }
         }
 
-        if (req.interval_ms > 0 && (CUSTOM_MILLIS - req.last_request_time < req.interval_ms)) {
+        // jamais envoyée depuis le boot: due tout de suite, quel que soit l'intervalle
+        if (req.interval_ms > 0 && req.requested_once && (CUSTOM_MILLIS - req.last_request_time < req.interval_ms)) {
             if (req.log_tag) {
                 ESP_LOGD(req.log_tag, "Skipping %s (0x%02X) - interval not elapsed (elapsed: %lu, interval: %u)",
                     req.description, req.code,
@@ -188,14 +234,7 @@ bool RequestScheduler::process_response(uint8_t code, CN105Climate* context) {
     }
 
     // Chercher si le code est géré par le scheduler
-    bool handled = false;
-    for (auto& req : requests_) {
-        if (req.code == code) {
-            handled = true;
-            break;
-        }
-    }
-    if (!handled) return false;
+    if (!this->handles(code)) return false;
 
     mark_response_seen(code, context);
     send_next_after(code, context);
@@ -59,9 +59,9 @@ namespace esphome {
 
         /**
          * @brief Enregistre une requête dans la file d'attente
-         * @param req La requête à enregistrer (référence non-const pour permettre modification)
+         * @param req La requête à enregistrer (déplacée dans la file: passer std::move(req))
          */
-        void register_request(InfoRequest& req);
+        void register_request(InfoRequest req);
 
         /**
          * @brief Vide la liste des requêtes
@@ -74,12 +74,44 @@ namespace esphome {
          */
         void disable_request(uint8_t code);
 
+        /**
+         * @brief Indique si la requête de ce code a été désactivée (non supportée)
+         * @param code Le code de la requête
+         * @return true si enregistrée et désactivée
+         */
+        bool is_disabled(uint8_t code) const;
+
+        /**
+         * @brief Repousse la prochaine requête de ce code d'un intervalle complet (données déjà connues)
+         * @param code Le code de la requête
+         */
+        void mark_requested(uint8_t code);
+
+        /**
+         * @brief Nombre de timeouts soft depuis le boot pour ce code (statistiques du lien)
+         * @param code Le code de la requête
+         * @return 0 si non enregistrée
+         */
+        uint32_t soft_timeouts(uint8_t code) const;
+
+        /**
+         * @brief Code de la requête dont la réponse est attendue
+         * @return le code, ou -1 si aucune réponse n'est attendue
+         */
+        int awaiting_code() const;
+
         /**
          * @brief Vérifie si la file d'attente est vide
          * @return true si vide, false sinon
          */
         bool is_empty() const;
 
+        /**
+         * @brief Indique si le code est géré par l'orchestrateur
+         * @param code Le code INFO à tester
+         */
+        bool handles(uint8_t code) const;
+
         /**
          * @brief Envoie la prochaine requête après celle avec le code spécifié
          * @param previous_code Le code de la requête précédente (0x00 pour démarrer)
@@ -109,6 +141,11 @@ namespace esphome {
          */
         void loop();
 
+        /**
+         * @brief Requêtes enregistrées, dans l'ordre du cycle
+         */
+        const std::vector<InfoRequest>& requests() const { return requests_; }
+
     private:
         std::vector<InfoRequest> requests_;          // File d'attente des requêtes
         int current_request_index_;                  // Index de la requête courante
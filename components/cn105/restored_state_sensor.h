@@ -0,0 +1,15 @@
+#pragma once
+
+#include "esphome/components/binary_sensor/binary_sensor.h"
+#include "esphome/core/component.h"
+
+
+namespace esphome {
+
+    // ON tant que l'état affiché vient du snapshot warm_start et n'a pas encore été confirmé par la PAC
+    class RestoredStateSensor : public binary_sensor::BinarySensor, public Component {
+    public:
+        RestoredStateSensor() {}
+    };
+
+}
@@ -1,12 +1,11 @@
 #pragma once
 
-#include "esphome/components/sensor/sensor.h"
-#include "esphome/core/component.h"
+#include "throttled_sensor.h"
 
 
 namespace esphome {
 
-    class RuntimeHoursSensor : public sensor::Sensor, public Component {
+    class RuntimeHoursSensor : public ThrottledSensor {
     public:
         RuntimeHoursSensor() {
             this->set_unit_of_measurement("h");
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace esphome {
+
+    /**
+     * @class SeqlockSlot
+     * @brief Emplacement double-buffer protégé par un compteur de séquence (seqlock).
+     *
+     * Les producteurs publient des instantanés complets sans jamais attendre : l'écriture se fait
+     * dans le buffer inactif, puis le compteur bascule vers ce buffer. Le consommateur lit toujours
+     * le dernier instantané cohérent et ne recommence que si deux publications l'ont doublé.
+     *
+     * Les producteurs doivent être sérialisés entre eux (c'est le cas: control(), les callbacks des
+     * selects et l'émulateur tournent tous dans le loop ESPHome). Le lecteur peut être n'importe où.
+     */
+    template<typename T>
+    class SeqlockSlot {
+    public:
+        /**
+         * @brief Publie un instantané complet (côté producteur, wait-free)
+         */
+        void publish(const T& value) {
+            const uint32_t seq = this->seq_.load(std::memory_order_relaxed);     // toujours pair ici
+            // impair = écriture en cours dans le buffer inactif
+            this->seq_.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            this->buffers_[((seq >> 1) + 1) & 1] = value;
+            this->seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        /**
+         * @brief Copie le dernier instantané cohérent
+         * @return la version de l'instantané lu (voir version())
+         */
+        uint32_t read(T& out) const {
+            for (;;) {
+                const uint32_t seq = this->seq_.load(std::memory_order_acquire);
+                out = this->buffers_[(seq >> 1) & 1];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                // le buffer lu n'est réécrit qu'à partir de la 2e publication suivante (seq pair + 3)
+                if (this->seq_.load(std::memory_order_relaxed) - (seq & ~1u) <= 2) {
+                    return seq >> 1;
+                }
+            }
+        }
+
+        /**
+         * @brief Nombre de publications terminées: permet de savoir si un instantané lu est toujours le dernier
+         */
+        uint32_t version() const { return this->seq_.load(std::memory_order_acquire) >> 1; }
+
+    private:
+        T buffers_[2]{};
+        std::atomic<uint32_t> seq_{ 0 };
+    };
+
+}
@@ -0,0 +1,307 @@
+#include "telemetry_history.h"
+#include "Globals.h"
+#include "esphome/core/log.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef USE_ESP32
+#include "esp_heap_caps.h"
+#include "esp_http_server.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace esphome {
+
+    static const char* const HISTORY_TAG = "HISTORY";
+
+    // pire cas d'un échantillon: 4+32 bits d'horodatage, 3+16 bits par canal
+    static const uint16_t MAX_SAMPLE_BITS = 36 + 19 * TelemetrySample::CHANNELS;
+
+    void TelemetryHistory::startBlock() {
+        const size_t index = this->headSeq_ % this->blockCount_;
+        memset(this->storage_ + index * BLOCK_SIZE, 0, BLOCK_SIZE);
+        this->infos_[index] = BlockInfo{ 0, 0, 0 };
+        if (this->usedBlocks_ < this->blockCount_) {
+            this->usedBlocks_++;
+        }
+    }
+
+    void TelemetryHistory::writeBits(uint32_t value, uint8_t nbits) {
+        const size_t index = this->headSeq_ % this->blockCount_;
+        uint8_t* block = this->storage_ + index * BLOCK_SIZE;
+        BlockInfo& info = this->infos_[index];
+        for (int i = nbits - 1; i >= 0; i--) {
+            if ((value >> i) & 1) {
+                block[info.bits >> 3] |= (uint8_t)(0x80 >> (info.bits & 7));
+            }
+            info.bits++;
+        }
+    }
+
+    void TelemetryHistory::record(const TelemetrySample& sample) {
+        if (this->storage_ == nullptr) {
+            return;
+        }
+        LockGuard lock(this->mutex_);
+
+        if (static_cast<size_t>(this->infos_[this->headSeq_ % this->blockCount_].bits) + MAX_SAMPLE_BITS > BLOCK_SIZE * 8) {
+            this->headSeq_++;       // écrase le bloc le plus ancien quand le buffer est plein
+            this->startBlock();
+        }
+        BlockInfo& info = this->infos_[this->headSeq_ % this->blockCount_];
+        const uint32_t ds = sample.uptimeMs / 100;
+
+        if (info.samples == 0) {
+            // bloc autonome: premier échantillon en clair
+            info.firstDs = ds;
+            this->writeBits(ds, 32);
+            for (int c = 0; c < TelemetrySample::CHANNELS; c++) {
+                this->writeBits((uint16_t)sample.values[c], 16);
+            }
+            this->enc_.prevDeltaDs = 0;
+        } else {
+            const int32_t deltaDs = (int32_t)(ds - this->enc_.prevDs);
+            const int32_t dod = deltaDs - this->enc_.prevDeltaDs;
+            const uint32_t zz = telemetry_bits::zigzag(dod);
+            if (dod == 0) {
+                this->writeBits(0b0, 1);
+            } else if (zz < (1u << 7)) {
+                this->writeBits(0b10, 2);
+                this->writeBits(zz, 7);
+            } else if (zz < (1u << 9)) {
+                this->writeBits(0b110, 3);
+                this->writeBits(zz, 9);
+            } else if (zz < (1u << 12)) {
+                this->writeBits(0b1110, 4);
+                this->writeBits(zz, 12);
+            } else {
+                this->writeBits(0b1111, 4);
+                this->writeBits((uint32_t)deltaDs, 32);
+            }
+            this->enc_.prevDeltaDs = deltaDs;
+
+            for (int c = 0; c < TelemetrySample::CHANNELS; c++) {
+                const int32_t delta = (int32_t)sample.values[c] - this->enc_.prev[c];
+                const uint32_t dz = telemetry_bits::zigzag(delta);
+                if (delta == 0) {
+                    this->writeBits(0b0, 1);
+                } else if (dz < (1u << 4)) {
+                    this->writeBits(0b10, 2);
+                    this->writeBits(dz, 4);
+                } else if (dz < (1u << 8)) {
+                    this->writeBits(0b110, 3);
+                    this->writeBits(dz, 8);
+                } else {
+                    this->writeBits(0b111, 3);
+                    this->writeBits((uint16_t)sample.values[c], 16);
+                }
+            }
+        }
+        this->enc_.prevDs = ds;
+        memcpy(this->enc_.prev, sample.values, sizeof(this->enc_.prev));
+        info.samples++;
+        this->totalSamples_++;
+    }
+
+    void TelemetryHistory::blockRange(uint32_t& first, uint32_t& end) {
+        LockGuard lock(this->mutex_);
+        end = this->headSeq_ + 1;
+        first = end - this->usedBlocks_;
+    }
+
+    void TelemetryHistory::set_stats_blob(const uint8_t* data, size_t len) {
+        LockGuard lock(this->mutex_);
+        if (this->stats_ == nullptr) {
+            this->stats_ = (uint8_t*)malloc(STATS_BLOB_MAX);
+            if (this->stats_ == nullptr) {
+                return;
+            }
+        }
+        this->statsLen_ = (len < STATS_BLOB_MAX) ? len : STATS_BLOB_MAX;
+        memcpy(this->stats_, data, this->statsLen_);
+    }
+
+    size_t TelemetryHistory::copyStats(uint8_t* out, size_t max) {
+        LockGuard lock(this->mutex_);
+        const size_t len = (this->statsLen_ < max) ? this->statsLen_ : max;
+        if (len > 0) {
+            memcpy(out, this->stats_, len);
+        }
+        return len;
+    }
+
+    void TelemetryHistory::noteHandlerStack() {
+#ifdef USE_ESP32
+        // marque haute de la tâche courante (tâche httpd): minimum depuis sa création, en octets sur ESP-IDF
+        this->handlerStackFree_.store(uxTaskGetStackHighWaterMark(nullptr), std::memory_order_relaxed);
+#endif
+    }
+
+    bool TelemetryHistory::copyBlock(uint32_t seq, BlockInfo& info, uint8_t* out) {
+        LockGuard lock(this->mutex_);
+        if (this->storage_ == nullptr || seq > this->headSeq_ || seq + this->usedBlocks_ <= this->headSeq_) {
+            return false;
+        }
+        const size_t index = seq % this->blockCount_;
+        info = this->infos_[index];
+        memcpy(out, this->storage_ + index * BLOCK_SIZE, (info.bits + 7) / 8);
+        return info.samples > 0;
+    }
+
+#ifdef USE_ESP32
+    static void put_le16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+    static void put_le32(uint8_t* p, uint32_t v) { put_le16(p, v & 0xFFFF); put_le16(p + 2, v >> 16); }
+
+    // en-tête (16 octets): "CNTH", version, nb canaux, taille de bloc, uptime courant (ds), réservé
+    // puis pour chaque bloc, du plus ancien au plus récent: firstDs (u32), samples (u16), bits (u16), données
+    static esp_err_t history_bin_handler(httpd_req_t* req) {
+        TelemetryHistory* self = static_cast<TelemetryHistory*>(req->user_ctx);
+        httpd_resp_set_type(req, "application/octet-stream");
+        httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"cn105_history.bin\"");
+
+        uint8_t header[16] = { 'C', 'N', 'T', 'H', TelemetryHistory::FORMAT_VERSION, TelemetrySample::CHANNELS };
+        put_le16(header + 6, TelemetryHistory::BLOCK_SIZE);
+        put_le32(header + 8, CUSTOM_MILLIS / 100);
+        if (httpd_resp_send_chunk(req, (const char*)header, sizeof(header)) != ESP_OK) {
+            return ESP_FAIL;
+        }
+
+        uint32_t first, end;
+        self->blockRange(first, end);
+        uint8_t buffer[8 + TelemetryHistory::BLOCK_SIZE];
+        for (uint32_t seq = first; seq != end; seq++) {
+            TelemetryHistory::BlockInfo info;
+            if (!self->copyBlock(seq, info, buffer + 8)) {
+                continue;       // écrasé pendant le téléchargement
+            }
+            put_le32(buffer, info.firstDs);
+            put_le16(buffer + 4, info.samples);
+            put_le16(buffer + 6, info.bits);
+            if (httpd_resp_send_chunk(req, (const char*)buffer, 8 + (info.bits + 7) / 8) != ESP_OK) {
+                return ESP_FAIL;
+            }
+        }
+        self->noteHandlerStack();
+        return httpd_resp_send_chunk(req, nullptr, 0);
+    }
+
+    static esp_err_t stats_bin_handler(httpd_req_t* req) {
+        TelemetryHistory* self = static_cast<TelemetryHistory*>(req->user_ctx);
+        uint8_t blob[TelemetryHistory::STATS_BLOB_MAX];
+        const size_t len = self->copyStats(blob, sizeof(blob));
+        if (len == 0) {
+            return httpd_resp_send_404(req);       // link_stats absent ou pas encore de rapport
+        }
+        httpd_resp_set_type(req, "application/octet-stream");
+        httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"cn105_stats.bin\"");
+        return httpd_resp_send(req, (const char*)blob, len);
+    }
+
+    static esp_err_t history_csv_handler(httpd_req_t* req) {
+        TelemetryHistory* self = static_cast<TelemetryHistory*>(req->user_ctx);
+        httpd_resp_set_type(req, "text/csv");
+        char uptime[16];
+        snprintf(uptime, sizeof(uptime), "%u", (unsigned)CUSTOM_MILLIS);
+        httpd_resp_set_hdr(req, "X-Uptime-Ms", uptime);     // pour recaler uptime_s sur l'heure réelle
+
+        static const char* const CSV_HEADER = "uptime_s,room_temp,outside_temp,compressor_hz,input_power_w,stage,sub_mode\n";
+        if (httpd_resp_send_chunk(req, CSV_HEADER, strlen(CSV_HEADER)) != ESP_OK) {
+            return ESP_FAIL;
+        }
+
+        uint32_t first, end;
+        self->blockRange(first, end);
+        uint8_t block[TelemetryHistory::BLOCK_SIZE];
+        char out[256];          // quelques lignes par chunk: la pile du serveur porte déjà le bloc copié
+        size_t len = 0;
+        bool failed = false;
+        for (uint32_t seq = first; seq != end && !failed; seq++) {
+            TelemetryHistory::BlockInfo info;
+            if (!self->copyBlock(seq, info, block)) {
+                continue;
+            }
+            TelemetryHistory::decodeBlock(info, block, [&](const TelemetrySample& s) {
+                if (failed) return;
+                char room[8] = "", outside[8] = "";
+                if (s.values[0] != TelemetrySample::NO_VALUE) snprintf(room, sizeof(room), "%.1f", s.values[0] / 10.0f);
+                if (s.values[1] != TelemetrySample::NO_VALUE) snprintf(outside, sizeof(outside), "%.1f", s.values[1] / 10.0f);
+                const char* stage = (s.values[4] >= 0 && s.values[4] < 7) ? STAGE_MAP[s.values[4]] : "";
+                const char* subMode = (s.values[5] >= 0 && s.values[5] < 4) ? SUB_MODE_MAP[s.values[5]] : "";
+                len += snprintf(out + len, sizeof(out) - len, "%u.%u,%s,%s,%d,%d,%s,%s\n",
+                    (unsigned)(s.uptimeMs / 1000), (unsigned)(s.uptimeMs % 1000) / 100, room, outside,
+                    s.values[2], s.values[3], stage, subMode);
+                if (len > sizeof(out) - 96) {       // une ligne fait moins de 96 caractères
+                    failed = httpd_resp_send_chunk(req, out, len) != ESP_OK;
+                    len = 0;
+                }
+                });
+        }
+        if (failed || (len > 0 && httpd_resp_send_chunk(req, out, len) != ESP_OK)) {
+            return ESP_FAIL;
+        }
+        self->noteHandlerStack();
+        return httpd_resp_send_chunk(req, nullptr, 0);
+    }
+#endif
+
+    bool TelemetryHistory::begin() {
+        if (!this->is_configured() || this->storage_ != nullptr) {
+            return this->storage_ != nullptr;
+        }
+        this->blockCount_ = this->sizeBytes_ / BLOCK_SIZE;
+        const size_t bytes = this->blockCount_ * BLOCK_SIZE;
+#ifdef USE_ESP32
+        // PSRAM si présente, sinon RAM interne
+        this->storage_ = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        const bool psram = this->storage_ != nullptr;
+#else
+        const bool psram = false;
+#endif
+        if (this->storage_ == nullptr) {
+            this->storage_ = (uint8_t*)malloc(bytes);
+        }
+        this->infos_ = (BlockInfo*)calloc(this->blockCount_, sizeof(BlockInfo));
+        if (this->storage_ == nullptr || this->infos_ == nullptr) {
+            ESP_LOGE(HISTORY_TAG, "cannot allocate %u bytes for the telemetry history", (unsigned)bytes);
+            free(this->storage_);
+            free(this->infos_);
+            this->storage_ = nullptr;
+            this->infos_ = nullptr;
+            return false;
+        }
+        this->startBlock();
+        ESP_LOGI(HISTORY_TAG, "telemetry history: %u blocks of %u bytes in %s", (unsigned)this->blockCount_,
+            (unsigned)BLOCK_SIZE, psram ? "PSRAM" : "internal RAM");
+
+#ifdef USE_ESP32
+        static uint16_t nextCtrlPort = 32784;    // ESPHome: 32768, émulateurs: 32769+
+        httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+        config.lru_purge_enable = true;
+        config.stack_size = SERVER_STACK_SIZE;
+        config.server_port = this->port_;
+        config.ctrl_port = nextCtrlPort++;
+        httpd_handle_t server = nullptr;
+        if (httpd_start(&server, &config) != ESP_OK) {
+            ESP_LOGE(HISTORY_TAG, "cannot start the history web server on port %u", this->port_);
+            // sans serveur, personne ne peut lire l'historique: on rend la mémoire
+            LockGuard lock(this->mutex_);
+            free(this->storage_);
+            free(this->infos_);
+            this->storage_ = nullptr;
+            this->infos_ = nullptr;
+            return false;
+        }
+        httpd_uri_t uri_bin = { .uri = "/history.bin", .method = HTTP_GET, .handler = history_bin_handler, .user_ctx = this };
+        httpd_register_uri_handler(server, &uri_bin);
+        httpd_uri_t uri_csv = { .uri = "/history.csv", .method = HTTP_GET, .handler = history_csv_handler, .user_ctx = this };
+        httpd_register_uri_handler(server, &uri_csv);
+        httpd_uri_t uri_stats = { .uri = "/stats.bin", .method = HTTP_GET, .handler = stats_bin_handler, .user_ctx = this };
+        httpd_register_uri_handler(server, &uri_stats);
+        this->server_ = server;
+        ESP_LOGI(HISTORY_TAG, "telemetry history available on port %u (/history.bin, /history.csv, /stats.bin)", this->port_);
+#endif
+        return true;
+    }
+
+}
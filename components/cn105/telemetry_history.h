@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+    /**
+     * @brief Un échantillon par cycle (valeurs déjà décodées, quantifiées pour la compression)
+     */
+    struct TelemetrySample {
+        static constexpr int CHANNELS = 6;
+        static constexpr int16_t NO_VALUE = INT16_MIN;     // température inconnue (NAN), stage/sub_mode inconnu
+
+        uint32_t uptimeMs;
+        // room (°C x10), outside (°C x10), compresseur (Hz), puissance (W), index STAGE_MAP, index SUB_MODE_MAP
+        int16_t values[CHANNELS];
+    };
+
+    /**
+     * @class TelemetryHistory
+     * @brief Historique roulant compressé (style Gorilla) avec téléchargement HTTP en masse.
+     *
+     * Les échantillons sont codés bit à bit dans des blocs de BLOCK_SIZE octets indépendants: premier
+     * échantillon en clair, puis delta-de-delta pour l'horodatage (dixièmes de seconde) et delta à préfixe
+     * variable pour chaque canal (1 bit si la valeur n'a pas bougé, le cas courant). Quand le buffer est plein,
+     * le bloc le plus ancien est écrasé. Le buffer est alloué en PSRAM si disponible.
+     *
+     * Serveur HTTP (ESP-IDF) sur son propre port:
+     *  - /history.bin: blocs bruts (format décrit dans le README), pour l'analyse hors ligne
+     *  - /history.csv: échantillons décodés
+     *  - /stats.bin: dernier blob de statistiques publié par set_stats_blob() (link_stats)
+     * Le lecteur HTTP copie un bloc à la fois sous le mutex: record() n'attend jamais plus d'un memcpy de bloc.
+     */
+    class TelemetryHistory {
+    public:
+        static constexpr size_t BLOCK_SIZE = 256;
+        static constexpr uint8_t FORMAT_VERSION = 1;
+        static constexpr size_t STATS_BLOB_MAX = 512;
+        static constexpr size_t SERVER_STACK_SIZE = 6144;   // CSV: bloc copié (256 o) + sortie (256 o) sur la pile
+
+        void configure(uint32_t sizeBytes, uint16_t port) {
+            this->sizeBytes_ = sizeBytes;
+            this->port_ = port;
+        }
+        bool is_configured() const { return this->sizeBytes_ >= BLOCK_SIZE; }
+
+        /// alloue le buffer et démarre le serveur HTTP
+        bool begin();
+        void record(const TelemetrySample& sample);
+
+        /// copie (sous le mutex) du blob servi sur /stats.bin, tronqué à STATS_BLOB_MAX
+        void set_stats_blob(const uint8_t* data, size_t len);
+        size_t copyStats(uint8_t* out, size_t max);
+
+        uint32_t get_samples() const { return this->totalSamples_; }
+        /// RAM allouée par begin(): blocs + index (0 avant begin())
+        size_t get_allocated_bytes() const { return this->blockCount_ * (BLOCK_SIZE + sizeof(BlockInfo)) + (this->stats_ ? STATS_BLOB_MAX : 0); }
+        /// appelé en fin de handler HTTP: plus petite marge de pile vue sur la tâche du serveur
+        void noteHandlerStack();
+        /// marge de pile minimale du serveur HTTP (octets), 0 si aucune requête servie
+        uint32_t get_handler_stack_free() const { return this->handlerStackFree_.load(std::memory_order_relaxed); }
+        size_t get_block_count() const { return this->blockCount_; }
+
+        struct BlockInfo {
+            uint32_t firstDs;       // horodatage du premier échantillon (dixièmes de seconde depuis le boot)
+            uint16_t samples;
+            uint16_t bits;
+        };
+
+        /**
+         * @brief Copie du bloc de numéro de séquence seq (sous le mutex)
+         * @return false si le bloc a déjà été écrasé ou n'existe pas encore
+         */
+        bool copyBlock(uint32_t seq, BlockInfo& info, uint8_t* out);
+        /// numéros de séquence [first, end) des blocs présents
+        void blockRange(uint32_t& first, uint32_t& end);
+
+        /**
+         * @brief Décode un bloc copié par copyBlock
+         * @param fn appelé pour chaque échantillon
+         */
+        template<typename F> static void decodeBlock(const BlockInfo& info, const uint8_t* block, F fn);
+
+    private:
+        struct Encoder {
+            uint32_t prevDs;
+            int32_t prevDeltaDs;
+            int16_t prev[TelemetrySample::CHANNELS];
+        };
+
+        void startBlock();
+        void writeBits(uint32_t value, uint8_t nbits);
+
+        uint32_t sizeBytes_{ 0 };
+        uint16_t port_{ 0 };
+        uint8_t* storage_{ nullptr };
+        BlockInfo* infos_{ nullptr };
+        size_t blockCount_{ 0 };
+        uint32_t headSeq_{ 0 };         // bloc en cours d'écriture
+        uint32_t usedBlocks_{ 0 };
+        Encoder enc_{};
+        uint32_t totalSamples_{ 0 };
+        Mutex mutex_;              // esphome::Mutex: vrai mutex FreeRTOS sur ESP32, vide sur ESP8266
+        void* server_{ nullptr };
+        uint8_t* stats_{ nullptr };     // alloué au premier set_stats_blob()
+        size_t statsLen_{ 0 };
+        std::atomic<uint32_t> handlerStackFree_{ 0 };
+    };
+
+    namespace telemetry_bits {
+
+        // lecture MSB d'abord, symétrique de TelemetryHistory::writeBits()
+        struct BitReader {
+            const uint8_t* data;
+            uint32_t pos;
+            uint32_t read(uint8_t nbits) {
+                uint32_t v = 0;
+                for (uint8_t i = 0; i < nbits; i++, pos++) {
+                    v = (v << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1);
+                }
+                return v;
+            }
+        };
+
+        inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+        inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    }
+
+    template<typename F> void TelemetryHistory::decodeBlock(const BlockInfo& info, const uint8_t* block, F fn) {
+        telemetry_bits::BitReader r{ block, 0 };
+        TelemetrySample s{};
+        uint32_t ds = 0;
+        int32_t deltaDs = 0;
+        for (uint16_t n = 0; n < info.samples && r.pos < info.bits; n++) {
+            if (n == 0) {
+                ds = r.read(32);
+                for (int c = 0; c < TelemetrySample::CHANNELS; c++) s.values[c] = (int16_t)r.read(16);
+            } else {
+                // horodatage: 0 | 10+7 | 110+9 | 1110+12 bits de delta-de-delta, 1111+32 bits de delta brut
+                if (r.read(1) == 0) {
+                } else if (r.read(1) == 0) {
+                    deltaDs += telemetry_bits::unzigzag(r.read(7));
+                } else if (r.read(1) == 0) {
+                    deltaDs += telemetry_bits::unzigzag(r.read(9));
+                } else if (r.read(1) == 0) {
+                    deltaDs += telemetry_bits::unzigzag(r.read(12));
+                } else {
+                    deltaDs = (int32_t)r.read(32);
+                }
+                ds += deltaDs;
+                // canaux: 0 | 10+4 | 110+8 bits de delta, 111+16 bits de valeur brute
+                for (int c = 0; c < TelemetrySample::CHANNELS; c++) {
+                    if (r.read(1) == 0) {
+                    } else if (r.read(1) == 0) {
+                        s.values[c] = (int16_t)(s.values[c] + telemetry_bits::unzigzag(r.read(4)));
+                    } else if (r.read(1) == 0) {
+                        s.values[c] = (int16_t)(s.values[c] + telemetry_bits::unzigzag(r.read(8)));
+                    } else {
+                        s.values[c] = (int16_t)r.read(16);
+                    }
+                }
+            }
+            s.uptimeMs = ds * 100;
+            fn(s);
+        }
+    }
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/core/component.h"
+#include <cmath>
+
+namespace esphome {
+
+    /**
+     * @class ThrottledSensor
+     * @brief Capteur de télémétrie avec bande morte et intervalles de publication min/max.
+     *
+     * publish_if_due() est appelé à chaque fin de cycle avec la valeur courante. La valeur n'est publiée que
+     * si elle s'écarte d'au moins deadband de la dernière valeur publiée et que min_interval est écoulé, ou si
+     * max_interval est écoulé depuis la dernière publication (point de vie pour l'historique HA).
+     * Tout à 0 (défaut): publie à chaque changement.
+     */
+    class ThrottledSensor : public sensor::Sensor, public Component {
+    public:
+        void set_deadband(float deadband) { this->deadband_ = deadband; }
+        void set_min_interval(uint32_t min_interval_ms) { this->min_interval_ms_ = min_interval_ms; }
+        void set_max_interval(uint32_t max_interval_ms) { this->max_interval_ms_ = max_interval_ms; }
+
+        /**
+         * @brief Publie value si la politique le permet
+         * @return true si une publication a eu lieu
+         */
+        bool publish_if_due(float value, uint32_t now_ms) {
+            if (this->published_) {
+                const uint32_t elapsed = now_ms - this->last_publish_ms_;
+                const bool heartbeat = (this->max_interval_ms_ > 0) && (elapsed >= this->max_interval_ms_);
+                if (!heartbeat) {
+                    if (elapsed < this->min_interval_ms_ || !this->moved_(value)) {
+                        return false;
+                    }
+                }
+            }
+            this->published_ = true;
+            this->last_published_ = value;
+            this->last_publish_ms_ = now_ms;
+            this->publish_state(value);
+            return true;
+        }
+
+    protected:
+        bool moved_(float value) const {
+            if (std::isnan(value) || std::isnan(this->last_published_)) {
+                return std::isnan(value) != std::isnan(this->last_published_);
+            }
+            const float delta = std::fabs(value - this->last_published_);
+            return (this->deadband_ > 0) ? (delta >= this->deadband_) : (delta > 0);
+        }
+
+        float deadband_{ 0 };
+        uint32_t min_interval_ms_{ 0 };
+        uint32_t max_interval_ms_{ 0 };
+        float last_published_{ NAN };
+        uint32_t last_publish_ms_{ 0 };
+        bool published_{ false };
+    };
+
+}
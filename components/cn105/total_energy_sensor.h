@@ -0,0 +1,18 @@
+#pragma once
+
+#include "throttled_sensor.h"
+
+
+namespace esphome {
+
+    class TotalEnergySensor : public ThrottledSensor {
+    public:
+        TotalEnergySensor() {
+            this->set_unit_of_measurement("kWh");
+            this->set_device_class("energy");
+            this->set_state_class(sensor::StateClass::STATE_CLASS_TOTAL_INCREASING);
+            this->set_accuracy_decimals(3);
+        }
+    };
+
+}
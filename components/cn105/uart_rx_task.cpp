@@ -0,0 +1,204 @@
+#include "uart_rx_task.h"
+#include "esphome/components/uart/uart.h"
+#include "esphome/core/log.h"
+
+#if !defined(USE_ESP32) && defined(CN105_RX_TASK_SUPPORTED)
+#include <chrono>
+#endif
+
+namespace esphome {
+
+    static const char* const RX_TASK_TAG = "CN105_RX";
+
+    // A 2400 bauds 8E1 un octet prend ~4.6ms : un poll toutes les 2ms suffit largement
+    static const uint32_t RX_TASK_POLL_MS = 2;
+    static const size_t RX_TASK_CHUNK = 32;
+
+    FrameAssembler::Result FrameAssembler::feed(uint8_t inputData) {
+        if (!this->found_start_) {
+            if (inputData == HEADER[0]) {
+                this->found_start_ = true;
+                this->bytes_read_ = 0;
+                this->data_length_ = -1;
+                this->frame_.bytes[this->bytes_read_++] = inputData;
+            }
+            return Result::PENDING;
+        }
+
+        if (this->bytes_read_ >= MAX_DATA_BYTES) {
+            this->reset();
+            return Result::OVERFLOW;
+        }
+        this->frame_.bytes[this->bytes_read_] = inputData;
+
+        if (this->bytes_read_ == 4) {
+            this->data_length_ = inputData;
+            if ((this->data_length_ + 6) > MAX_DATA_BYTES) {
+                this->reset();
+                return Result::OVERFLOW;
+            }
+        }
+
+        if (this->data_length_ != -1 && this->bytes_read_ == this->data_length_ + 5) {
+            const int length = this->bytes_read_ + 1;
+            uint8_t processedCS = 0;
+            for (int i = 0; i < length - 1; i++) {
+                processedCS += this->frame_.bytes[i];
+            }
+            processedCS = (0xfc - processedCS) & 0xff;
+
+            this->frame_.length = (uint8_t)length;
+            const bool valid = (processedCS == this->frame_.bytes[length - 1]);
+            this->frame_.checksumOk = valid;
+            this->found_start_ = false;
+            this->bytes_read_ = 0;
+            this->data_length_ = -1;
+            return valid ? Result::FRAME_OK : Result::BAD_CHECKSUM;
+        }
+
+        this->bytes_read_++;
+        return Result::PENDING;
+    }
+
+    void FrameAssembler::reset() {
+        this->found_start_ = false;
+        this->bytes_read_ = 0;
+        this->data_length_ = -1;
+    }
+
+    void UartRxTask::run_() {
+        uint8_t chunk[RX_TASK_CHUNK];
+
+        while (!this->stop_requested_.load(std::memory_order_acquire)) {
+            if (this->resync_.exchange(false, std::memory_order_acq_rel)) {
+                this->assembler_.reset();
+            }
+
+            int available = this->uart_->available();
+            if (available <= 0) {
+                this->idle_();
+                continue;
+            }
+
+            size_t len = (size_t)available < RX_TASK_CHUNK ? (size_t)available : RX_TASK_CHUNK;
+            if (!this->uart_->read_array(chunk, len)) {
+                this->idle_();
+                continue;
+            }
+
+            for (size_t i = 0; i < len; i++) {
+                switch (this->assembler_.feed(chunk[i])) {
+                case FrameAssembler::Result::BAD_CHECKSUM:
+                    this->bad_checksums_.fetch_add(1, std::memory_order_relaxed);
+                    // remise au loop quand même: il la journalise et la compte comme en lecture directe
+                    [[fallthrough]];
+                case FrameAssembler::Result::FRAME_OK:
+                    if (!this->queue_.push(this->assembler_.frame())) {
+                        this->dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (this->frame_callback_) {
+                        this->frame_callback_();
+                    }
+                    break;
+                case FrameAssembler::Result::OVERFLOW:
+                    this->overflows_.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case FrameAssembler::Result::PENDING:
+                    break;
+                }
+            }
+        }
+    }
+
+#ifdef USE_ESP32
+
+    void UartRxTask::idle_() {
+        // au moins 1 tick pour ne pas affamer la tâche idle (watchdog)
+        TickType_t ticks = pdMS_TO_TICKS(RX_TASK_POLL_MS);
+        vTaskDelay(ticks > 0 ? ticks : 1);
+    }
+
+    void UartRxTask::task_entry_(void* arg) {
+        UartRxTask* self = static_cast<UartRxTask*>(arg);
+        self->run_();
+        self->handle_ = nullptr;
+        self->running_.store(false, std::memory_order_release);
+        vTaskDelete(nullptr);
+    }
+
+    bool UartRxTask::start(uart::UARTComponent* uart) {
+        if (this->is_running() || uart == nullptr) {
+            return this->is_running();
+        }
+        this->uart_ = uart;
+        this->assembler_.reset();
+        this->stop_requested_.store(false, std::memory_order_release);
+        this->running_.store(true, std::memory_order_release);
+
+        // priorité juste au-dessus de la loopTask (1) pour vider le FIFO même quand le loop est occupé
+        if (xTaskCreatePinnedToCore(&UartRxTask::task_entry_, "cn105_rx", STACK_SIZE, this, 2, &this->handle_, tskNO_AFFINITY) != pdPASS) {
+            this->running_.store(false, std::memory_order_release);
+            ESP_LOGE(RX_TASK_TAG, "unable to create UART RX task, falling back to loop reads");
+            return false;
+        }
+        ESP_LOGI(RX_TASK_TAG, "UART RX task started (queue depth %u)", (unsigned)QUEUE_DEPTH);
+        return true;
+    }
+
+    void UartRxTask::stop() {
+        if (!this->is_running()) {
+            return;
+        }
+        this->stop_requested_.store(true, std::memory_order_release);
+        while (this->is_running()) {
+            vTaskDelay(1);
+        }
+        ESP_LOGI(RX_TASK_TAG, "UART RX task stopped");
+    }
+
+#elif defined(CN105_RX_TASK_SUPPORTED)
+
+    void UartRxTask::idle_() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(RX_TASK_POLL_MS));
+    }
+
+    bool UartRxTask::start(uart::UARTComponent* uart) {
+        if (this->is_running() || uart == nullptr) {
+            return this->is_running();
+        }
+        this->uart_ = uart;
+        this->assembler_.reset();
+        this->stop_requested_.store(false, std::memory_order_release);
+        this->running_.store(true, std::memory_order_release);
+        this->thread_ = std::thread([this]() { this->run_(); });
+        ESP_LOGI(RX_TASK_TAG, "UART RX thread started (queue depth %u)", (unsigned)QUEUE_DEPTH);
+        return true;
+    }
+
+    void UartRxTask::stop() {
+        if (!this->is_running()) {
+            return;
+        }
+        this->stop_requested_.store(true, std::memory_order_release);
+        if (this->thread_.joinable()) {
+            this->thread_.join();
+        }
+        this->running_.store(false, std::memory_order_release);
+        ESP_LOGI(RX_TASK_TAG, "UART RX thread stopped");
+    }
+
+#else
+
+    void UartRxTask::idle_() {}
+
+    bool UartRxTask::start(uart::UARTComponent* uart) {
+        (void)uart;
+        ESP_LOGW(RX_TASK_TAG, "UART RX task not supported on this platform, using loop reads");
+        return false;
+    }
+
+    void UartRxTask::stop() {}
+
+#endif
+
+}
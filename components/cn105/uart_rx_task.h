@@ -0,0 +1,178 @@
+#pragma once
+
+#include "cn105_types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#define CN105_RX_TASK_SUPPORTED
+#elif defined(USE_HOST)
+// build host (tests): std::thread; les autres plateformes lisent depuis le loop
+#include <thread>
+#define CN105_RX_TASK_SUPPORTED
+#endif
+
+namespace esphome {
+
+    namespace uart {
+        class UARTComponent;
+    }
+
+    /**
+     * @brief Trame CN105 complète (header + data + checksum), telle que reçue sur l'UART
+     */
+    struct RxFrame {
+        uint8_t bytes[MAX_DATA_BYTES];
+        uint8_t length;
+        // checksum faux: la trame est quand même remise au loop pour les diagnostics (handshake, link_stats)
+        bool checksumOk;
+    };
+
+    /**
+     * @class SpscQueue
+     * @brief File circulaire lock-free à un seul producteur et un seul consommateur.
+     *
+     * Le producteur (tâche de lecture UART) n'écrit que head_, le consommateur (loop ESPHome)
+     * n'écrit que tail_ : aucune section critique n'est nécessaire.
+     * N doit être une puissance de deux.
+     */
+    template<typename T, size_t N>
+    class SpscQueue {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue size must be a power of two");
+
+    public:
+        /**
+         * @brief Ajoute un élément (côté producteur)
+         * @return false si la file est pleine (l'élément est perdu)
+         */
+        bool push(const T& item) {
+            const size_t head = this->head_.load(std::memory_order_relaxed);
+            if (head - this->tail_.load(std::memory_order_acquire) >= N) {
+                return false;
+            }
+            this->slots_[head & (N - 1)] = item;
+            this->head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Retire l'élément le plus ancien (côté consommateur)
+         * @return false si la file est vide
+         */
+        bool pop(T& out) {
+            const size_t tail = this->tail_.load(std::memory_order_relaxed);
+            if (this->head_.load(std::memory_order_acquire) == tail) {
+                return false;
+            }
+            out = this->slots_[tail & (N - 1)];
+            this->tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool empty() const {
+            return this->head_.load(std::memory_order_acquire) == this->tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        T slots_[N];
+        std::atomic<size_t> head_{ 0 };
+        std::atomic<size_t> tail_{ 0 };
+    };
+
+    /**
+     * @class FrameAssembler
+     * @brief Reconstitue les trames CN105 octet par octet et valide leur checksum.
+     *
+     * Même découpage que CN105Climate::parse() : 0xFC de début, longueur data en header[4],
+     * total = 5 (header) + data + 1 (checksum).
+     */
+    class FrameAssembler {
+    public:
+        enum class Result { PENDING, FRAME_OK, BAD_CHECKSUM, OVERFLOW };
+
+        Result feed(uint8_t inputData);
+        void reset();
+
+        /// Dernière trame complète (valide tant que feed() n'est pas rappelé)
+        const RxFrame& frame() const { return this->frame_; }
+
+    private:
+        RxFrame frame_{};
+        int bytes_read_ = 0;
+        int data_length_ = -1;
+        bool found_start_ = false;
+    };
+
+    /**
+     * @class UartRxTask
+     * @brief Tâche de lecture UART dédiée (mode optionnel `uart_rx_task`).
+     *
+     * La tâche lit l'UART, assemble et valide les trames, puis les remet au loop ESPHome
+     * via une SpscQueue de taille fixe. Le décodage et les publications restent dans le loop.
+     * Backend FreeRTOS sur ESP32, std::thread sur le build host (USE_HOST, tests). Ailleurs, lecture depuis le loop.
+     */
+    class UartRxTask {
+    public:
+        static constexpr size_t QUEUE_DEPTH = 8;
+        static constexpr uint32_t STACK_SIZE = 3072;
+
+        ~UartRxTask() { this->stop(); }
+
+        /**
+         * @brief Démarre la tâche de lecture sur l'UART donné
+         * @return false si la tâche n'a pas pu être créée ou si la plateforme ne le supporte pas
+         */
+        bool start(uart::UARTComponent* uart);
+        void stop();
+        bool is_running() const { return this->running_.load(std::memory_order_acquire); }
+
+        /// Côté loop: récupère la prochaine trame (checksumOk = false si le checksum est faux)
+        bool pop(RxFrame& frame) { return this->queue_.pop(frame); }
+
+        /// Appelé depuis la tâche RX après chaque trame mise en file (doit être utilisable hors loop)
+        void set_frame_callback(std::function<void()>&& callback) { this->frame_callback_ = std::move(callback); }
+
+        /// Demande à la tâche d'abandonner la trame partielle en cours (ex: après une reconnexion)
+        void request_resync() { this->resync_.store(true, std::memory_order_release); }
+
+        uint32_t get_bad_checksums() const { return this->bad_checksums_.load(std::memory_order_relaxed); }
+        uint32_t get_overflows() const { return this->overflows_.load(std::memory_order_relaxed); }
+        uint32_t get_dropped_frames() const { return this->dropped_frames_.load(std::memory_order_relaxed); }
+        /// marge de pile minimale de la tâche depuis son démarrage (octets), 0 si indisponible
+        uint32_t get_stack_free() const {
+#ifdef USE_ESP32
+            return (this->handle_ != nullptr) ? uxTaskGetStackHighWaterMark(this->handle_) : 0;
+#else
+            return 0;
+#endif
+        }
+
+    protected:
+        void run_();
+        void idle_();
+
+        uart::UARTComponent* uart_ = nullptr;
+        std::function<void()> frame_callback_;
+        FrameAssembler assembler_;
+        SpscQueue<RxFrame, QUEUE_DEPTH> queue_;
+
+        std::atomic<bool> running_{ false };
+        std::atomic<bool> stop_requested_{ false };
+        std::atomic<bool> resync_{ false };
+        std::atomic<uint32_t> bad_checksums_{ 0 };
+        std::atomic<uint32_t> overflows_{ 0 };
+        std::atomic<uint32_t> dropped_frames_{ 0 };
+
+#ifdef USE_ESP32
+        static void task_entry_(void* arg);
+        TaskHandle_t handle_ = nullptr;
+#elif defined(CN105_RX_TASK_SUPPORTED)
+        std::thread thread_;
+#endif
+    };
+
+}
@@ -328,41 +328,45 @@ void CN105Climate::debugSettingsAndStatus(const char* settingName, heatpumpSetti
 
 
 void CN105Climate::hpPacketDebug(uint8_t* packet, unsigned int length, const char* packetDirection) {
-    // Construire la chaîne de sortie de façon sûre et performante
-    std::string output;
-    output.reserve(length * 3 + 1); // "FF " par octet
-
-    char byteBuf[4];
+    // Chaîne de sortie sur la pile: appelé pour chaque trame, aucune allocation
+    char output[MAX_DATA_BYTES * 3 + 24];   // "FF " par octet, plus la marque de troncature
+    const unsigned int total = length;
+    if (length > MAX_DATA_BYTES) {
+        length = MAX_DATA_BYTES;
+    }
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
     for (unsigned int i = 0; i < length; i++) {
-        // Toujours borné à 3 caractères + NUL
-        int written = snprintf(byteBuf, sizeof(byteBuf), "%02X ", packet[i]);
-        if (written > 0) {
-            output.append(byteBuf, static_cast<size_t>(written));
-        }
+        output[i * 3] = HEX_DIGITS[packet[i] >> 4];
+        output[i * 3 + 1] = HEX_DIGITS[packet[i] & 0x0F];
+        output[i * 3 + 2] = ' ';
+    }
+    output[length * 3] = '\0';
+    if (total > length) {
+        // trame plus longue que le buffer: le dire plutôt que de la montrer comme complète
+        snprintf(output + length * 3, sizeof(output) - length * 3, "... (+%u bytes)", total - length);
     }
 
     char outputForSensor[15];
     // Tronquer proprement pour la publication éventuelle sur un capteur
-    strncpy(outputForSensor, output.c_str(), sizeof(outputForSensor) - 1);
+    strncpy(outputForSensor, output, sizeof(outputForSensor) - 1);
     outputForSensor[sizeof(outputForSensor) - 1] = '\0';
 
     /*if (strcasecmp(packetDirection, "WRITE") == 0) {
         this->last_sent_packet_sensor->publish_state(outputForSensor);
     }*/
 
-    ESP_LOGD(packetDirection, "%s", output.c_str());
+    ESP_LOGD(packetDirection, "%s", output);
 }
 
 void CN105Climate::hpFunctionsDebug(uint8_t* packet, unsigned int length) {
     if (length < 2) return; // Pas de données à décoder
 
-    std::string output;
-    output.reserve(length * 8); // Pré-allocation pour éviter les réallocations
-
-    char buffer[16];
+    char output[MAX_DATA_BYTES * 8];        // " 102:3" par octet, sur la pile
+    size_t len = 0;
+    output[0] = '\0';
 
     // On commence à i=1 pour sauter l'octet de commande (0x20 ou 0x22)
-    for (unsigned int i = 1; i < length; i++) {
+    for (unsigned int i = 1; i < length && len < sizeof(output) - 8; i++) {
         uint8_t byte = packet[i];
 
         // Logique de décodage Mitsubishi (copiée de heatpumpFunctions)
@@ -370,13 +374,12 @@ void CN105Climate::hpFunctionsDebug(uint8_t* packet, unsigned int length) {
         int value = byte & 3;
 
         // Formatage "Code:Valeur" (ex: " 102:3")
-        snprintf(buffer, sizeof(buffer), " %d:%d", code, value);
-        output += buffer;
+        len += snprintf(output + len, sizeof(output) - len, " %d:%d", code, value);
     }
 
     // Affichage avec le tag LOG_FUNCTIONS_TAG (défini dans cn105_types.h)
     // Affiche par exemple : [FUNCTIONS] Decoded 20: 101:1 102:3 103:2 ...
-    ESP_LOGD(LOG_FUNCTIONS_TAG, "Decoded %02X:%s", packet[0], output.c_str());
+    ESP_LOGD(LOG_FUNCTIONS_TAG, "Decoded %02X:%s", packet[0], output);
 }
 
 int CN105Climate::lookupByteMapIndex(const int valuesMap[], int len, int lookupValue, const char* debugInfo) {
@@ -425,32 +428,6 @@ int CN105Climate::lookupByteMapValue(const int valuesMap[], const uint8_t byteMa
 }
 
 #ifndef USE_ESP32
-/**
- * This methode emulates the esp32 lock_guard feature with a boolean variable
- *
-*/
-void CN105Climate::emulateMutex(const char* retryName, std::function<void()>&& f) {
-    this->set_retry(retryName, 100, 10, [this, f, retryName](uint8_t retry_count) {
-        if (this->wantedSettingsMutex) {
-            if (retry_count < 1) {
-                ESP_LOGW(retryName, "10 retry calls failed because mutex was locked, forcing unlock...");
-                this->wantedSettingsMutex = true;
-                f();
-                this->wantedSettingsMutex = false;
-                return RetryResult::DONE;
-            }
-            ESP_LOGI(retryName, "wantedSettingsMutex is already locked, defferring...");
-            return RetryResult::RETRY;
-        } else {
-            this->wantedSettingsMutex = true;
-            ESP_LOGD(retryName, "emulateMutex normal behaviour, locking...");
-            f();
-            ESP_LOGD(retryName, "emulateMutex unlocking...");
-            this->wantedSettingsMutex = false;
-            return RetryResult::DONE;
-        }
-        }, 1.2f);
-}
 #ifdef TEST_MODE
 
 void CN105Climate::testEmulateMutex(const char* retryName, std::function<void()>&& f) {
@@ -512,14 +489,14 @@ void CN105Climate::testCase1() {
     ESP_LOGI("testMutex", "Test 1: VERROUILLAGE ET APPEL DE logDelegate...");
     ESP_LOGI("testMutex", "verrouillage du mutex...");
     this->esp8266Mutex = true;
-    this->testEmulateMutex("testMutex", std::bind(&CN105Climate::logDelegate, this));
+    this->testEmulateMutex("testMutex", [this]() { this->logDelegate(); });
     CUSTOM_DELAY(testDelay);
     ESP_LOGI("testMutex", "Déverrouillage du mutex...");
     this->esp8266Mutex = false;
     CUSTOM_DELAY(200);
     ESP_LOGI("testMutex", "verrouillage du mutex...");
     this->esp8266Mutex = true;
-    this->testEmulateMutex("testMutex", std::bind(&CN105Climate::logDelegate, this));
+    this->testEmulateMutex("testMutex", [this]() { this->logDelegate(); });
     ESP_LOGI("testMutex", "blocage de 2,5s...");
     CUSTOM_DELAY(2500);
     ESP_LOGI("testMutex", "fin du test");
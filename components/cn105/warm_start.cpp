@@ -0,0 +1,181 @@
+#include "cn105.h"
+
+using namespace esphome;
+
+/**
+ * warm_start: the last confirmed state is kept in flash and republished at boot, before
+ * the first cycle, so HA does not show the climate as unknown during the handshake.
+ * The restored_state_sensor stays ON until the heat pump has confirmed it (first complete cycle).
+ */
+
+static uint8_t warmStartIndex(const char* value, const char* map[], int len) {
+    if (value == nullptr) {
+        return WARM_START_UNKNOWN;
+    }
+    for (int i = 0; i < len; i++) {
+        if (value == map[i] || strcmp(value, map[i]) == 0) {
+            return (uint8_t)i;
+        }
+    }
+    return WARM_START_UNKNOWN;
+}
+
+static const char* warmStartValue(uint8_t index, const char* map[], int len) {
+    return (index < len) ? map[index] : nullptr;
+}
+
+void CN105Climate::setupWarmStart() {
+    if (!this->warm_start_) {
+        return;
+    }
+    this->warm_start_pref_ = global_preferences->make_preference<warmStartSnapshot>(
+        this->get_object_id_hash() ^ WARM_START_PREF_HASH_SALT, true);
+
+    warmStartSnapshot snapshot{};
+    if (!this->warm_start_pref_.load(&snapshot) || snapshot.settings.version != WARM_START_VERSION ||
+        warmStartValue(snapshot.settings.power, POWER_MAP, 2) == nullptr) {
+        ESP_LOGI(LOG_CONN_TAG, "Warm start: no saved state, waiting for the heat pump");
+        return;
+    }
+    this->warm_start_saved_ = snapshot;
+    this->warm_start_saved_ms_ = CUSTOM_MILLIS;
+    this->applyWarmStart(snapshot);
+}
+
+void CN105Climate::applyWarmStart(const warmStartSnapshot& snapshot) {
+    // capacités: évite de re-sonder ce qui a déjà échoué sur cette unité
+    if (snapshot.settings.installerFallback && this->installer_mode_) {
+        this->installer_mode_effective_ = false;
+        this->installer_mode_fallback_done_ = true;
+    }
+    if (snapshot.settings.functionsUnsupported) {
+        this->scheduler_.disable_request(0x20);
+        this->scheduler_.disable_request(0x22);
+        for (auto* setting : this->hardware_settings_) {
+            setting->set_enabled(false);
+        }
+    } else if (snapshot.settings.functionsValid) {
+        uint8_t part1[15], part2[15];
+        memcpy(part1, snapshot.settings.functions1, sizeof(part1));
+        memcpy(part2, snapshot.settings.functions2, sizeof(part2));
+        this->functions.setData1(part1);
+        this->functions.setData2(part2);
+        this->functionsArrived();
+    }
+
+    // même chemin que les trames reçues: publishStateToHA, selects, écouteurs
+    heatpumpSettings settings = this->currentSettings;
+    settings.power = warmStartValue(snapshot.settings.power, POWER_MAP, 2);
+    settings.mode = warmStartValue(snapshot.settings.mode, MODE_MAP, 5);
+    settings.fan = warmStartValue(snapshot.settings.fan, FAN_MAP, 6);
+    settings.vane = warmStartValue(snapshot.settings.vane, VANE_MAP, 7);
+    settings.wideVane = warmStartValue(snapshot.settings.wideVane, WIDEVANE_MAP, 8);
+    settings.iSee = snapshot.settings.iSee != 0;
+    settings.temperature = snapshot.settings.temperature;
+    settings.dual_low_target = snapshot.settings.dualLow;
+    settings.dual_high_target = snapshot.settings.dualHigh;
+    this->heatpumpUpdate(settings);
+
+    this->currentSettings.stage = warmStartValue(snapshot.status.stage, STAGE_MAP, 7);
+    this->currentSettings.sub_mode = warmStartValue(snapshot.status.subMode, SUB_MODE_MAP, 4);
+    this->currentSettings.auto_sub_mode = warmStartValue(snapshot.status.autoSubMode, AUTO_SUB_MODE_MAP, 4);
+    if (this->stage_sensor_ != nullptr && this->currentSettings.stage != nullptr) {
+        this->stage_sensor_->publish_state(this->currentSettings.stage);
+    }
+    if (this->Sub_mode_sensor_ != nullptr && this->currentSettings.sub_mode != nullptr) {
+        this->Sub_mode_sensor_->publish_state(this->currentSettings.sub_mode);
+    }
+    if (this->Auto_sub_mode_sensor_ != nullptr && this->currentSettings.auto_sub_mode != nullptr) {
+        this->Auto_sub_mode_sensor_->publish_state(this->currentSettings.auto_sub_mode);
+    }
+
+    heatpumpStatus status = this->currentStatus;
+    status.roomTemperature = snapshot.status.roomTemperature;
+    status.outsideAirTemperature = snapshot.status.outsideAirTemperature;
+    status.operating = snapshot.status.operating != 0;
+    status.compressorFrequency = snapshot.status.compressorFrequency;
+    status.inputPower = snapshot.status.inputPower;
+    status.kWh = snapshot.status.kWh;
+    status.runtimeHours = snapshot.status.runtimeHours;
+    this->statusChanged(status);
+
+    this->flushPendingPublish();
+    this->warm_start_restored_ = true;
+    if (this->restored_state_sensor_ != nullptr) {
+        this->restored_state_sensor_->publish_state(true);
+    }
+    ESP_LOGI(LOG_CONN_TAG, "Warm start: restored %s %s %.1f°C (room %.1f°C), waiting for confirmation",
+        settings.power, settings.mode != nullptr ? settings.mode : "?", settings.temperature, status.roomTemperature);
+}
+
+void CN105Climate::buildWarmStart(warmStartSnapshot& snapshot) {
+    memset(&snapshot, 0, sizeof(snapshot));     // octets de padding à zéro: comparaison par memcmp
+    snapshot.settings.version = WARM_START_VERSION;
+    snapshot.settings.power = warmStartIndex(this->currentSettings.power, POWER_MAP, 2);
+    snapshot.settings.mode = warmStartIndex(this->currentSettings.mode, MODE_MAP, 5);
+    snapshot.settings.fan = warmStartIndex(this->currentSettings.fan, FAN_MAP, 6);
+    snapshot.settings.vane = warmStartIndex(this->currentSettings.vane, VANE_MAP, 7);
+    snapshot.settings.wideVane = warmStartIndex(this->currentSettings.wideVane, WIDEVANE_MAP, 8);
+    snapshot.settings.iSee = this->currentSettings.iSee;
+    // même règle que le cache de handshake: 0x5A seulement après plusieurs sondes 0x5B ignorées
+    snapshot.settings.installerFallback = this->handshake_cache_.command == 0x5A;
+    snapshot.settings.functionsUnsupported = this->scheduler_.is_disabled(0x20) || this->scheduler_.is_disabled(0x22);
+    snapshot.settings.temperature = this->currentSettings.temperature;
+    snapshot.settings.dualLow = this->currentSettings.dual_low_target;
+    snapshot.settings.dualHigh = this->currentSettings.dual_high_target;
+    snapshot.settings.functionsValid = this->functions.isValid();
+    if (snapshot.settings.functionsValid) {
+        this->functions.getData1(snapshot.settings.functions1);
+        this->functions.getData2(snapshot.settings.functions2);
+    }
+
+    snapshot.status.roomTemperature = this->currentStatus.roomTemperature;
+    snapshot.status.outsideAirTemperature = this->currentStatus.outsideAirTemperature;
+    snapshot.status.compressorFrequency = this->currentStatus.compressorFrequency;
+    snapshot.status.inputPower = this->currentStatus.inputPower;
+    snapshot.status.kWh = this->currentStatus.kWh;
+    snapshot.status.runtimeHours = this->currentStatus.runtimeHours;
+    snapshot.status.operating = this->currentStatus.operating;
+    snapshot.status.stage = warmStartIndex(this->currentSettings.stage, STAGE_MAP, 7);
+    snapshot.status.subMode = warmStartIndex(this->currentSettings.sub_mode, SUB_MODE_MAP, 4);
+    snapshot.status.autoSubMode = warmStartIndex(this->currentSettings.auto_sub_mode, AUTO_SUB_MODE_MAP, 4);
+}
+
+void CN105Climate::saveWarmStart(bool force) {
+    // rien de neuf tant que l'état restauré n'a pas été confirmé
+    if (!this->warm_start_ || this->warm_start_restored_ || this->currentSettings.power == nullptr) {
+        return;
+    }
+    warmStartSnapshot snapshot;
+    this->buildWarmStart(snapshot);
+
+    const uint32_t now = CUSTOM_MILLIS;
+    const uint32_t elapsed = now - this->warm_start_saved_ms_;
+    const bool settingsChanged = memcmp(&snapshot.settings, &this->warm_start_saved_.settings, sizeof(snapshot.settings)) != 0;
+    const bool statusChanged = memcmp(&snapshot.status, &this->warm_start_saved_.status, sizeof(snapshot.status)) != 0;
+    const bool due = (settingsChanged && (this->warm_start_saved_ms_ == 0 || elapsed >= WARM_START_SAVE_MIN_INTERVAL_MS)) ||
+        (statusChanged && elapsed >= WARM_START_STATUS_SAVE_INTERVAL_MS);
+    if (!(due || (force && (settingsChanged || statusChanged)))) {
+        return;
+    }
+
+    this->warm_start_pref_.save(&snapshot);
+    if (force) {
+        global_preferences->sync();
+    }
+    this->warm_start_saved_ = snapshot;
+    this->warm_start_saved_ms_ = now;
+    ESP_LOGD(LOG_CONN_TAG, "Warm start: state saved (%s)", settingsChanged ? "settings" : "status");
+}
+
+void CN105Climate::confirmWarmStart() {
+    if (!this->warm_start_restored_) {
+        return;
+    }
+    // premier cycle complet: l'état affiché vient désormais de la PAC
+    this->warm_start_restored_ = false;
+    if (this->restored_state_sensor_ != nullptr) {
+        this->restored_state_sensor_->publish_state(false);
+    }
+    ESP_LOGI(LOG_CONN_TAG, "Warm start: state confirmed by the heat pump %u ms after boot", (unsigned)(CUSTOM_MILLIS - this->boot_ms_));
+}
@@ -0,0 +1,294 @@
+// Flotte d'instances CN105Climate réelles (sources du composant) sur le build host, chacune rebouclée sur
+// son unité simulée.
+//
+//   cn105_host_fleet --units 100 --duration 600 --latency 30 --jitter 10 --corrupt 0.005
+//
+// Rapport: trames/s, CPU du loop par unité, latence de commande, et tas par instance avec le détail
+// table de requêtes (vecteur du RequestScheduler), std::function et std::string.
+#include "host_node.h"
+
+#include <malloc.h>
+#include <time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace cn105_host;
+
+namespace {
+
+    struct Options {
+        int units = 50;
+        uint32_t duration_s = 600;
+        uint32_t set_interval_s = 60;
+        NodeConfig node;
+        bool check = false;
+    };
+
+    void usage() {
+        std::printf(
+            "usage: cn105_host_fleet [--units N] [--duration S] [--update-interval MS] [--set-interval S]\n"
+            "                        [--latency MS] [--jitter MS] [--corrupt P] [--drop P] [--no-wire-speed]\n"
+            "                        [--event-driven] [--seed N] [--check]\n"
+            "  --check  exit 1 unless every unit connected, completed its cycles and applied its setpoints\n");
+    }
+
+    bool parse(int argc, char** argv, Options& opt) {
+        for (int i = 1; i < argc; i++) {
+            const std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--units" && has_value) {
+                opt.units = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--duration" && has_value) {
+                opt.duration_s = (uint32_t)std::atoi(argv[++i]);
+            } else if (arg == "--update-interval" && has_value) {
+                opt.node.update_interval_ms = (uint32_t)std::atoi(argv[++i]);
+            } else if (arg == "--set-interval" && has_value) {
+                opt.set_interval_s = (uint32_t)std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "--latency" && has_value) {
+                opt.node.link.latency_ms = (float)std::atof(argv[++i]);
+            } else if (arg == "--jitter" && has_value) {
+                opt.node.link.jitter_ms = (float)std::atof(argv[++i]);
+            } else if (arg == "--corrupt" && has_value) {
+                opt.node.link.corrupt = (float)std::atof(argv[++i]);
+            } else if (arg == "--drop" && has_value) {
+                opt.node.link.drop = (float)std::atof(argv[++i]);
+            } else if (arg == "--no-wire-speed") {
+                opt.node.link.wire_speed = false;
+            } else if (arg == "--event-driven") {
+                opt.node.event_driven_loop = true;
+            } else if (arg == "--seed" && has_value) {
+                opt.node.link.seed = (uint32_t)std::atoi(argv[++i]);
+            } else if (arg == "--check") {
+                opt.check = true;
+            } else {
+                usage();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double cpu_seconds() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+
+    double wall_seconds() {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    }
+
+    double percentile(std::vector<double> values, double pct) {
+        if (values.empty()) {
+            return NAN;
+        }
+        std::sort(values.begin(), values.end());
+        const size_t index = (size_t)std::lround(pct / 100.0 * (values.size() - 1));
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    /// taille sur le tas de la cible d'une std::function (0 si elle tient dans le stockage local)
+    template<typename F> size_t function_heap_bytes(const F& f) {
+        const size_t before = mallinfo2().uordblks;
+        F copy = f;
+        return mallinfo2().uordblks - before;
+    }
+
+    struct HeapBreakdown {
+        size_t requests = 0;
+        size_t request_capacity = 0;
+        size_t vector_bytes = 0;
+        size_t string_bytes = 0;
+        size_t function_bytes = 0;
+        size_t functions_on_heap = 0;
+    };
+
+    HeapBreakdown heap_breakdown(const esphome::CN105Climate& climate) {
+        HeapBreakdown out;
+        const auto& requests = climate.get_request_scheduler().requests();
+        out.requests = requests.size();
+        out.request_capacity = requests.capacity();
+        out.vector_bytes = requests.capacity() * sizeof(esphome::InfoRequest);
+        const std::string empty;
+        for (const auto& req : requests) {
+            // libstdc++: au-delà du SSO, capacity() + 1 octets alloués
+            if (req.timeout_name.capacity() > empty.capacity()) {
+                out.string_bytes += req.timeout_name.capacity() + 1;
+            }
+            const size_t can_send = function_heap_bytes(req.canSend);
+            const size_t on_response = function_heap_bytes(req.onResponse);
+            out.function_bytes += can_send + on_response;
+            out.functions_on_heap += (can_send > 0) + (on_response > 0);
+        }
+        return out;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) {
+        return 2;
+    }
+    std::printf("CN105 host fleet: %d units, %u s simulated, update interval %u ms, latency %.0f±%.0f ms, corrupt %.3f, drop %.3f, "
+        "event driven loop %s\n", opt.units, (unsigned)opt.duration_s, (unsigned)opt.node.update_interval_ms, opt.node.link.latency_ms,
+        opt.node.link.jitter_ms, opt.node.link.corrupt, opt.node.link.drop, opt.node.event_driven_loop ? "on" : "off");
+
+    // --- démarrage: construction, setup, connexion, premiers cycles ---
+    std::vector<std::string> names;
+    names.reserve(opt.units);
+    for (int i = 0; i < opt.units; i++) {
+        names.push_back("hp" + std::to_string(i));
+    }
+    std::vector<std::unique_ptr<HostNode>> nodes;
+    std::vector<HostNode*> ptrs;
+    nodes.reserve(opt.units);
+    ptrs.reserve(opt.units);
+
+    const size_t heap_before = mallinfo2().uordblks;
+    for (int i = 0; i < opt.units; i++) {
+        NodeConfig config = opt.node;
+        config.name = names[i].c_str();
+        config.link.seed = opt.node.link.seed * 7919u + (uint32_t)i;
+        nodes.emplace_back(new HostNode(config));
+        ptrs.push_back(nodes.back().get());
+    }
+    // après le rodage toutes les requêtes (fonctions comprises) ont été envoyées au moins une fois
+    const uint32_t connect_ms = HostNode::start_connected(ptrs.data(), ptrs.size());
+    const size_t heap_after = mallinfo2().uordblks;
+
+    int connected = 0;
+    for (auto& node : nodes) {
+        connected += node->connected() ? 1 : 0;
+    }
+
+    // --- tas par instance ---
+    const HeapBreakdown heap = heap_breakdown(nodes.front()->climate);
+    const size_t harness_bytes = sizeof(HostNode) - sizeof(esphome::CN105Climate);
+    const double measured = (heap_after > heap_before) ? (double)(heap_after - heap_before) / opt.units : 0.0;
+    const double component = measured - harness_bytes;
+    const double other = component - sizeof(esphome::CN105Climate) - heap.vector_bytes - heap.string_bytes - heap.function_bytes;
+
+    std::printf("heap per instance (live after connection, malloc delta / units minus the simulated unit and UART):\n");
+    std::printf("  CN105Climate object          %7u B\n", (unsigned)sizeof(esphome::CN105Climate));
+    std::printf("  RequestScheduler vector      %7u B  (%u requests, capacity %u x %u B InfoRequest)\n", (unsigned)heap.vector_bytes,
+        (unsigned)heap.requests, (unsigned)heap.request_capacity, (unsigned)sizeof(esphome::InfoRequest));
+    std::printf("  std::string (timeout names)  %7u B\n", (unsigned)heap.string_bytes);
+    std::printf("  std::function targets        %7u B  (%u of %u callbacks on the heap)\n", (unsigned)heap.function_bytes,
+        (unsigned)heap.functions_on_heap, (unsigned)(heap.requests * 2));
+    std::printf("  other (scheduler items, preferences, sensor states)  %7.0f B\n", other);
+    std::printf("  total                        %7.0f B\n", component);
+
+    // --- régime établi ---
+    std::vector<uint32_t> calls_before(nodes.size());
+    std::vector<uint64_t> ns_before(nodes.size());
+    std::vector<unsigned long> cycles_before(nodes.size());
+    uint64_t frames_before = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        calls_before[i] = nodes[i]->climate.get_host_loop_calls();
+        ns_before[i] = nodes[i]->climate.get_host_loop_ns();
+        cycles_before[i] = nodes[i]->climate.nbCompleteCycles_;
+        frames_before += nodes[i]->uart.get_requests() + nodes[i]->uart.get_replies();
+    }
+
+    std::vector<double> control_ms;
+    std::vector<double> pending_since(nodes.size(), -1.0);
+    std::vector<float> pending_target(nodes.size(), 0.0f);
+    uint32_t control_requests = 0;
+    const uint64_t set_period_us = (uint64_t)opt.set_interval_s * 1000000;
+    const uint64_t start_us = esphome::host::now_us();
+    const uint64_t end_us = start_us + (uint64_t)opt.duration_s * 1000000;
+    uint64_t next_step_us = start_us;
+    std::vector<uint64_t> next_set_us(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        next_set_us[i] = start_us + set_period_us * (i + 1) / nodes.size();
+    }
+
+    const double cpu0 = cpu_seconds();
+    const double wall0 = wall_seconds();
+    while (esphome::host::now_us() < end_us) {
+        const uint64_t now = esphome::host::now_us();
+        for (size_t i = 0; i < nodes.size(); i++) {
+            HostNode& node = *nodes[i];
+            if (now >= next_set_us[i]) {
+                next_set_us[i] += set_period_us;
+                if (pending_since[i] < 0) {
+                    pending_target[i] = (node.unit.setpoint >= 21.75f) ? 21.0f : 22.5f;
+                    pending_since[i] = now / 1000.0;
+                    node.request_setpoint(pending_target[i]);
+                    control_requests++;
+                }
+            }
+            if (pending_since[i] >= 0 && std::fabs(node.unit.setpoint - pending_target[i]) < 0.01f) {
+                control_ms.push_back(now / 1000.0 - pending_since[i]);
+                pending_since[i] = -1.0;
+            }
+        }
+        if (now >= next_step_us) {
+            next_step_us += 1000000;
+            for (auto& node : nodes) {
+                node->step_unit();
+            }
+        }
+        esphome::App.loop();
+    }
+    const double cpu = cpu_seconds() - cpu0;
+    const double wall = wall_seconds() - wall0;
+
+    uint64_t frames = 0;
+    uint64_t passes = 0;
+    uint64_t loop_ns = 0;
+    unsigned long cycles = 0;
+    uint32_t corrupted = 0;
+    uint32_t dropped = 0;
+    uint32_t soft_timeouts = 0;
+    int stalled = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        HostNode& node = *nodes[i];
+        frames += node.uart.get_requests() + node.uart.get_replies();
+        passes += node.climate.get_host_loop_calls() - calls_before[i];
+        loop_ns += node.climate.get_host_loop_ns() - ns_before[i];
+        const unsigned long unit_cycles = node.climate.nbCompleteCycles_ - cycles_before[i];
+        cycles += unit_cycles;
+        stalled += (unit_cycles == 0) ? 1 : 0;
+        corrupted += node.uart.get_corrupted();
+        dropped += node.uart.get_dropped();
+        for (const auto& req : node.climate.get_request_scheduler().requests()) {
+            soft_timeouts += req.soft_timeouts;
+        }
+    }
+    frames -= frames_before;
+
+    const double sim_s = opt.duration_s;
+    const double units = opt.units;
+    // start_connected rend 0 quand une unité ne s'est pas connectée dans les 60 s
+    std::printf("connected: %d/%d after %.1f s, complete cycles %lu (%.1f per unit), soft timeouts %u, replies corrupted %u, dropped %u\n",
+        connected, opt.units, (connect_ms > 0 ? connect_ms : 60000) / 1000.0, cycles, cycles / units, (unsigned)soft_timeouts, (unsigned)corrupted,
+        (unsigned)dropped);
+    std::printf("frames: %llu (%.1f frames/s simulated, %.0f frames/s wall, %.0fx real time)\n", (unsigned long long)frames,
+        frames / sim_s, wall > 0 ? frames / wall : 0.0, wall > 0 ? sim_s / wall : 0.0);
+    std::printf("cpu: %.3f s process, loop %.1f us per unit per simulated second, %.1f passes per unit per second, %.2f us per pass\n",
+        cpu, loop_ns / 1000.0 / units / sim_s, passes / units / sim_s, passes > 0 ? loop_ns / 1000.0 / passes : 0.0);
+    std::printf("control latency (ClimateCall until the unit applies the setpoint): n=%u/%u p50=%.0f ms p95=%.0f ms max=%.0f ms\n",
+        (unsigned)control_ms.size(), (unsigned)control_requests, percentile(control_ms, 50), percentile(control_ms, 95),
+        control_ms.empty() ? NAN : *std::max_element(control_ms.begin(), control_ms.end()));
+
+    if (opt.check) {
+        const bool ok = connected == opt.units && stalled == 0 && control_ms.size() + opt.units >= control_requests;
+        if (!ok) {
+            std::printf("CHECK FAILED: connected %d/%d, %d unit(s) without complete cycle, %u/%u setpoints applied\n", connected,
+                opt.units, stalled, (unsigned)control_ms.size(), (unsigned)control_requests);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdio>
+
+// Assertions minimales des tests host: on continue après un échec pour tout voir d'un coup,
+// HOST_CHECK_RESULT() donne le code de sortie pour ctest.
+
+namespace cn105_host {
+    inline int& check_failures() {
+        static int failures = 0;
+        return failures;
+    }
+}
+
+#define HOST_CHECK(cond)                                                                   \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond);  \
+            cn105_host::check_failures()++;                                                \
+        }                                                                                  \
+    } while (0)
+
+#define HOST_CHECK_EQ(a, b)                                                                \
+    do {                                                                                   \
+        const long long va_ = (long long)(a);                                              \
+        const long long vb_ = (long long)(b);                                              \
+        if (va_ != vb_) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s == %s (%lld != %lld)\n",         \
+                __FILE__, __LINE__, #a, #b, va_, vb_);                                     \
+            cn105_host::check_failures()++;                                                \
+        }                                                                                  \
+    } while (0)
+
+#define HOST_CHECK_RESULT()                                                                \
+    (cn105_host::check_failures() == 0 ? (std::printf("OK\n"), 0)                          \
+        : (std::fprintf(stderr, "%d check(s) failed\n", cn105_host::check_failures()), 1))
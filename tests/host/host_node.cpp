@@ -0,0 +1,88 @@
+#include "host_node.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace cn105_host {
+
+    HostNode::HostNode(const NodeConfig& config)
+        : uart(&unit, config.link), climate(&uart), update_interval_ms_(config.update_interval_ms), uart_rx_task_(config.uart_rx_task),
+        unit_time_us_(esphome::host::now_us()) {
+        // ordre des appels de main.cpp généré par climate.py (warm_start et emulator_proxy_mode: défauts de la classe)
+        this->climate.set_name(config.name);
+        this->climate.set_update_interval(config.update_interval_ms);
+        this->climate.set_installer_mode(false);
+        this->climate.set_uart_rx_task(config.uart_rx_task);
+        this->climate.set_event_driven_loop(config.event_driven_loop);
+        this->climate.set_connection_bootstrap_delay(config.bootstrap_delay_ms);
+        this->climate.set_remote_temp_timeout(4294967295);
+        this->climate.set_debounce_delay(100);
+        if (config.sensors) {
+            this->climate.set_compressor_frequency_sensor(&this->compressor_frequency);
+            this->climate.set_input_power_sensor(&this->input_power);
+            this->climate.set_outside_air_temperature_sensor(&this->outside_temperature);
+            this->climate.set_stage_sensor(&this->stage);
+            this->climate.set_sub_mode_sensor(&this->sub_mode);
+        }
+    }
+
+    uint32_t HostNode::start_connected(HostNode* const* nodes, size_t count) {
+        esphome::host::preferences_clear();
+        uint32_t update_interval_ms = 0;
+        for (size_t i = 0; i < count; i++) {
+            esphome::App.register_component(&nodes[i]->climate);
+            update_interval_ms = std::max(update_interval_ms, nodes[i]->update_interval_ms_);
+        }
+        esphome::App.setup();
+
+        uint32_t connect_ms = 0;
+        while (!std::all_of(nodes, nodes + count, [](const HostNode* node) { return node->connected(); })) {
+            if (connect_ms >= 60000) {
+                return 0;
+            }
+            run(nodes, count, 1000);
+            connect_ms += 1000;
+        }
+        run(nodes, count, update_interval_ms * 5);
+        return connect_ms;
+    }
+
+    void HostNode::run(HostNode* const* nodes, size_t count, uint32_t duration_ms) {
+        const uint64_t end_us = esphome::host::now_us() + (uint64_t)duration_ms * 1000;
+        uint64_t next_step_us = esphome::host::now_us();
+        while (esphome::host::now_us() < end_us) {
+            if (esphome::host::now_us() >= next_step_us) {
+                next_step_us += 1000000;
+                for (size_t i = 0; i < count; i++) {
+                    nodes[i]->step_unit();
+                }
+            }
+            esphome::App.loop();
+            for (size_t i = 0; i < count; i++) {
+                nodes[i]->wait_rx_drained_();
+            }
+        }
+    }
+
+    void HostNode::step_unit() {
+        const uint64_t now = esphome::host::now_us();
+        if (now > this->unit_time_us_) {
+            this->unit.step((now - this->unit_time_us_) / 1e6f);
+            this->unit_time_us_ = now;
+        }
+    }
+
+    void HostNode::request_setpoint(float setpoint) {
+        auto call = this->climate.make_call();
+        call.set_target_temperature(setpoint);
+        call.perform();
+    }
+
+    void HostNode::wait_rx_drained_() {
+        while (this->uart_rx_task_ && this->uart.available() > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+}
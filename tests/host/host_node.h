@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cn105.h"
+#include "host_uart.h"
+#include "sim_unit.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cn105_host {
+
+    struct NodeConfig {
+        const char* name = "cn105";
+        uint32_t update_interval_ms = 2000;     // défaut de climate.py
+        uint32_t bootstrap_delay_ms = 0;        // pas de flux OTA à attendre sur le host
+        bool event_driven_loop = false;
+        bool uart_rx_task = false;
+        bool sensors = true;                    // capteurs usuels: fréquence, puissance, extérieur, stage, sous-mode
+        LinkProfile link;
+    };
+
+    /**
+     * @class HostNode
+     * @brief Une instance CN105Climate configurée comme par climate.py, câblée à son unité simulée.
+     */
+    class HostNode {
+    public:
+        explicit HostNode(const NodeConfig& config);
+
+        /**
+         * @brief Préférences vides, enregistrement dans App et App.setup(), puis connexion (60 s simulées au plus)
+         * et cinq update_interval de rodage: toutes les requêtes ont été envoyées, les slots du scheduler sont en place.
+         * @return temps simulé jusqu'à la connexion de toutes les instances (ms), 0 si l'une d'elles ne s'est pas connectée
+         */
+        static uint32_t start_connected(HostNode* const* nodes, size_t count);
+        bool start_connected() {
+            HostNode* self = this;
+            return start_connected(&self, 1) != 0;
+        }
+
+        /// fait tourner App pendant duration_ms de temps simulé, les unités avançant chaque seconde
+        static void run(HostNode* const* nodes, size_t count, uint32_t duration_ms);
+        void run(uint32_t duration_ms) {
+            HostNode* self = this;
+            run(&self, 1, duration_ms);
+        }
+
+        /// avance le modèle de l'unité jusqu'à maintenant
+        void step_unit();
+        /// consigne demandée comme depuis Home Assistant (ClimateCall)
+        void request_setpoint(float setpoint);
+
+        bool connected() const { return this->climate.isHeatpumpConnected_; }
+
+        SimulatedUnit unit;
+        HostUart uart;
+        esphome::CN105Climate climate;
+        esphome::CompressorFrequencySensor compressor_frequency;
+        esphome::InputPowerSensor input_power;
+        esphome::OutsideAirTemperatureSensor outside_temperature;
+        esphome::StageSensor stage;
+        esphome::SubModSensor sub_mode;
+
+    protected:
+        /// la tâche RX tourne en temps réel: on la laisse vider l'UART avant d'avancer l'horloge simulée
+        void wait_rx_drained_();
+
+        uint32_t update_interval_ms_;
+        bool uart_rx_task_;
+        uint64_t unit_time_us_;
+    };
+
+}
@@ -0,0 +1,117 @@
+#include "host_uart.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+
+namespace cn105_host {
+
+    HostUart::HostUart(SimulatedUnit* unit, const LinkProfile& link) : unit_(unit), link_(link), rng_(link.seed != 0 ? link.seed : 1) {}
+
+    uint64_t HostUart::byte_us_() const {
+        return this->link_.wire_speed ? (uint64_t)(11 * 1000000ULL / this->get_baud_rate()) : 0;
+    }
+
+    float HostUart::random_() {
+        this->rng_ ^= this->rng_ << 13;
+        this->rng_ ^= this->rng_ >> 17;
+        this->rng_ ^= this->rng_ << 5;
+        return (this->rng_ >> 8) / 16777216.0f;
+    }
+
+    void HostUart::push_locked_(uint8_t value, uint64_t due_us) {
+        if (this->head_ - this->tail_ >= RX_RING) {
+            this->overruns_++;      // FIFO plein: octet perdu, comme un débordement du driver
+            return;
+        }
+        this->ring_[this->head_ % RX_RING] = { value, due_us };
+        this->head_++;
+    }
+
+    size_t HostUart::arrived_locked_() const {
+        const uint64_t now = esphome::host::now_us();
+        size_t count = 0;
+        for (size_t i = this->tail_; i != this->head_ && this->ring_[i % RX_RING].due_us <= now; i++) {
+            count++;
+        }
+        return count;
+    }
+
+    void HostUart::write_array(const uint8_t* data, size_t len) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        const uint64_t now = esphome::host::now_us();
+        const uint64_t byte_us = this->byte_us_();
+
+        for (size_t i = 0; i < len; i++) {
+            this->tx_free_us_ = std::max(this->tx_free_us_, now) + byte_us;
+            if (this->assembler_.feed(data[i]) != esphome::FrameAssembler::Result::FRAME_OK) {
+                continue;
+            }
+            this->requests_++;
+            const esphome::RxFrame& request = this->assembler_.frame();
+            uint8_t reply[SimulatedUnit::MAX_FRAME + 6];
+            size_t reply_len = this->unit_->handle(request.bytes, request.length, reply);
+            if (reply_len == 0) {
+                continue;
+            }
+            if (this->link_.drop > 0 && this->random_() < this->link_.drop) {
+                this->dropped_++;
+                continue;
+            }
+            if (this->link_.corrupt > 0 && this->random_() < this->link_.corrupt) {
+                // même longueur, un bit inversé
+                const size_t at = (size_t)(this->random_() * reply_len) % reply_len;
+                reply[at] ^= (uint8_t)(1u << ((size_t)(this->random_() * 8) % 8));
+                this->corrupted_++;
+            }
+            this->replies_++;
+
+            // l'unité commence à compter quand la requête a fini de passer sur le fil
+            float latency_ms = this->link_.latency_ms;
+            if (this->link_.jitter_ms > 0) {
+                latency_ms += (this->random_() * 2.0f - 1.0f) * this->link_.jitter_ms;
+            }
+            uint64_t due = this->tx_free_us_ + (uint64_t)(std::max(0.0f, latency_ms) * 1000.0f);
+            due = std::max(due, this->rx_free_us_);
+            for (size_t b = 0; b < reply_len; b++) {
+                due += byte_us;
+                this->push_locked_(reply[b], due);
+            }
+            this->rx_free_us_ = due;
+        }
+    }
+
+    void HostUart::inject(const uint8_t* data, size_t len) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        const uint64_t now = esphome::host::now_us();
+        for (size_t i = 0; i < len; i++) {
+            this->push_locked_(data[i], now);
+        }
+    }
+
+    int HostUart::available() {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return (int)this->arrived_locked_();
+    }
+
+    bool HostUart::peek_byte(uint8_t* data) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (this->arrived_locked_() == 0) {
+            return false;
+        }
+        *data = this->ring_[this->tail_ % RX_RING].value;
+        return true;
+    }
+
+    bool HostUart::read_array(uint8_t* data, size_t len) {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (this->arrived_locked_() < len) {
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            data[i] = this->ring_[this->tail_ % RX_RING].value;
+            this->tail_++;
+        }
+        return true;
+    }
+
+}
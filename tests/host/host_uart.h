@@ -0,0 +1,79 @@
+#pragma once
+
+#include "esphome/components/uart/uart.h"
+#include "sim_unit.h"
+#include "uart_rx_task.h"
+
+#include <cstdint>
+#include <mutex>
+
+namespace cn105_host {
+
+    /// livraison des réponses de l'unité: latence, gigue et défauts du lien
+    struct LinkProfile {
+        float latency_ms = 20.0f;
+        float jitter_ms = 0.0f;
+        float corrupt = 0.0f;       // probabilité d'un bit inversé par réponse
+        float drop = 0.0f;          // probabilité d'une réponse perdue
+        bool wire_speed = true;     // octets cadencés au débit de l'UART (11 bits par octet en 8E1)
+        uint32_t seed = 1;
+    };
+
+    /**
+     * @class HostUart
+     * @brief UART ESPHome rebouclé sur une SimulatedUnit, sur l'horloge simulée.
+     *
+     * Les trames écrites par le composant sont réassemblées par le FrameAssembler du composant et passées
+     * à l'unité; la réponse arrive octet par octet après la latence du lien. available() ne compte que les
+     * octets déjà arrivés. Protégé par un mutex: la tâche RX (std::thread sur le build host) lit en parallèle.
+     */
+    class HostUart : public esphome::uart::UARTComponent {
+    public:
+        explicit HostUart(SimulatedUnit* unit, const LinkProfile& link = LinkProfile());
+
+        void write_array(const uint8_t* data, size_t len) override;
+        bool peek_byte(uint8_t* data) override;
+        bool read_array(uint8_t* data, size_t len) override;
+        int available() override;
+        void flush() override {}
+
+        /// octets reçus immédiatement, sans passer par l'unité (tests du décodeur)
+        void inject(const uint8_t* data, size_t len);
+
+        uint32_t get_requests() const { return this->requests_; }
+        uint32_t get_replies() const { return this->replies_; }
+        uint32_t get_dropped() const { return this->dropped_; }
+        uint32_t get_corrupted() const { return this->corrupted_; }
+        uint32_t get_overruns() const { return this->overruns_; }
+
+    protected:
+        static constexpr size_t RX_RING = 1024;
+
+        struct RxByte {
+            uint8_t value;
+            uint64_t due_us;
+        };
+
+        uint64_t byte_us_() const;
+        float random_();
+        void push_locked_(uint8_t value, uint64_t due_us);
+        size_t arrived_locked_() const;
+
+        SimulatedUnit* unit_;
+        LinkProfile link_;
+        esphome::FrameAssembler assembler_;
+        std::mutex mutex_;
+        RxByte ring_[RX_RING];
+        size_t head_ = 0;
+        size_t tail_ = 0;
+        uint64_t tx_free_us_ = 0;
+        uint64_t rx_free_us_ = 0;
+        uint32_t rng_;
+        uint32_t requests_ = 0;
+        uint32_t replies_ = 0;
+        uint32_t dropped_ = 0;
+        uint32_t corrupted_ = 0;
+        uint32_t overruns_ = 0;
+    };
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+// Équivalent host de l'en-tête généré par ESPHome: seulement ce que le composant cn105 utilise
+#include "esphome/core/component.h"
+#include "esphome/core/log.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "esphome/core/application.h"
+#include "esphome/core/version.h"
+#include "esphome/components/climate/climate.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+#include "esphome/components/select/select.h"
+#include "esphome/components/binary_sensor/binary_sensor.h"
+using namespace esphome;
@@ -0,0 +1,15 @@
+#pragma once
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace binary_sensor {
+
+        class BinarySensor : public EntityBase {
+        public:
+            void publish_state(bool state) { this->state = state; }
+
+            bool state{ false };
+        };
+
+    }
+}
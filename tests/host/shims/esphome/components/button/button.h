@@ -0,0 +1,16 @@
+#pragma once
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace button {
+
+        class Button : public EntityBase {
+        public:
+            void press() { this->press_action(); }
+
+        protected:
+            virtual void press_action() = 0;
+        };
+
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+    namespace climate {
+
+        enum ClimateMode : uint8_t {
+            CLIMATE_MODE_OFF = 0, CLIMATE_MODE_HEAT_COOL = 1, CLIMATE_MODE_COOL = 2, CLIMATE_MODE_HEAT = 3,
+            CLIMATE_MODE_FAN_ONLY = 4, CLIMATE_MODE_DRY = 5, CLIMATE_MODE_AUTO = 6
+        };
+        enum ClimateAction : uint8_t {
+            CLIMATE_ACTION_OFF = 0, CLIMATE_ACTION_COOLING = 2, CLIMATE_ACTION_HEATING = 3, CLIMATE_ACTION_IDLE = 4,
+            CLIMATE_ACTION_DRYING = 5, CLIMATE_ACTION_FAN = 6
+        };
+        enum ClimateFanMode : uint8_t {
+            CLIMATE_FAN_ON = 0, CLIMATE_FAN_OFF = 1, CLIMATE_FAN_AUTO = 2, CLIMATE_FAN_LOW = 3, CLIMATE_FAN_MEDIUM = 4,
+            CLIMATE_FAN_HIGH = 5, CLIMATE_FAN_MIDDLE = 6, CLIMATE_FAN_FOCUS = 7, CLIMATE_FAN_DIFFUSE = 8, CLIMATE_FAN_QUIET = 9
+        };
+        enum ClimateSwingMode : uint8_t {
+            CLIMATE_SWING_OFF = 0, CLIMATE_SWING_BOTH = 1, CLIMATE_SWING_VERTICAL = 2, CLIMATE_SWING_HORIZONTAL = 3
+        };
+        enum ClimateFeature : uint32_t {
+            CLIMATE_SUPPORTS_CURRENT_TEMPERATURE = 1 << 0,
+            CLIMATE_SUPPORTS_TWO_POINT_TARGET_TEMPERATURE = 1 << 1,
+            CLIMATE_REQUIRES_TWO_POINT_TARGET_TEMPERATURE = 1 << 2,
+            CLIMATE_SUPPORTS_ACTION = 1 << 3,
+        };
+
+        const char* climate_mode_to_string(ClimateMode mode);
+        const char* climate_fan_mode_to_string(ClimateFanMode fan_mode);
+        const char* climate_swing_mode_to_string(ClimateSwingMode swing_mode);
+
+        class ClimateTraits {
+        public:
+            void add_feature_flags(uint32_t flags) { this->feature_flags_ |= flags; }
+            void clear_feature_flags(uint32_t flags) { this->feature_flags_ &= ~flags; }
+            bool has_feature_flags(uint32_t flags) const { return (this->feature_flags_ & flags) == flags; }
+            void set_visual_min_temperature(float value) { this->visual_min_temperature_ = value; }
+            void set_visual_max_temperature(float value) { this->visual_max_temperature_ = value; }
+            void set_visual_temperature_step(float value) { this->visual_temperature_step_ = value; }
+            // toutes les configurations d'exemple déclarent les swings vertical et horizontal
+            bool supports_swing_mode(ClimateSwingMode swing_mode) const { (void)swing_mode; return true; }
+            bool supports_mode(ClimateMode mode) const { (void)mode; return true; }
+
+        protected:
+            uint32_t feature_flags_ = 0;
+            float visual_min_temperature_ = 10.0f;
+            float visual_max_temperature_ = 30.0f;
+            float visual_temperature_step_ = 0.1f;
+        };
+
+        class Climate;
+
+        class ClimateCall {
+        public:
+            explicit ClimateCall(Climate* parent) : parent_(parent) {}
+
+            ClimateCall& set_mode(ClimateMode mode) { this->mode_ = mode; return *this; }
+            ClimateCall& set_target_temperature(float value) { this->target_temperature_ = value; return *this; }
+            ClimateCall& set_target_temperature_low(float value) { this->target_temperature_low_ = value; return *this; }
+            ClimateCall& set_target_temperature_high(float value) { this->target_temperature_high_ = value; return *this; }
+            ClimateCall& set_fan_mode(ClimateFanMode fan_mode) { this->fan_mode_ = fan_mode; return *this; }
+            ClimateCall& set_swing_mode(ClimateSwingMode swing_mode) { this->swing_mode_ = swing_mode; return *this; }
+            void perform();
+
+            const optional<ClimateMode>& get_mode() const { return this->mode_; }
+            const optional<float>& get_target_temperature() const { return this->target_temperature_; }
+            const optional<float>& get_target_temperature_low() const { return this->target_temperature_low_; }
+            const optional<float>& get_target_temperature_high() const { return this->target_temperature_high_; }
+            const optional<ClimateFanMode>& get_fan_mode() const { return this->fan_mode_; }
+            const optional<ClimateSwingMode>& get_swing_mode() const { return this->swing_mode_; }
+
+        protected:
+            Climate* parent_;
+            optional<ClimateMode> mode_;
+            optional<float> target_temperature_;
+            optional<float> target_temperature_low_;
+            optional<float> target_temperature_high_;
+            optional<ClimateFanMode> fan_mode_;
+            optional<ClimateSwingMode> swing_mode_;
+        };
+
+        class Climate : public EntityBase {
+        public:
+            ClimateCall make_call() { return ClimateCall(this); }
+            void publish_state() { this->publish_count_++; }
+            uint32_t get_publish_count() const { return this->publish_count_; }
+
+            ClimateMode mode{ CLIMATE_MODE_OFF };
+            ClimateAction action{ CLIMATE_ACTION_OFF };
+            float current_temperature{ 0 };
+            float target_temperature{ 0 };
+            float target_temperature_low{ 0 };
+            float target_temperature_high{ 0 };
+            optional<ClimateFanMode> fan_mode;
+            ClimateSwingMode swing_mode{ CLIMATE_SWING_OFF };
+
+        protected:
+            friend class ClimateCall;
+            virtual void control(const ClimateCall& call) = 0;
+            virtual ClimateTraits traits() = 0;
+
+            uint32_t publish_count_ = 0;
+        };
+
+        inline void ClimateCall::perform() { this->parent_->control(*this); }
+
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cmath>
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace number {
+
+        class Number : public EntityBase {
+        public:
+            void publish_state(float state) { this->state = state; }
+
+            float state{ NAN };
+
+        protected:
+            virtual void control(float value) = 0;
+        };
+
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <initializer_list>
+#include <string>
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+    namespace select {
+
+        class SelectTraits {
+        public:
+            void set_options(std::initializer_list<const char*> options) { (void)options; }
+            void set_options(const FixedVector<const char*>& options) { (void)options; }
+        };
+
+        class Select : public EntityBase {
+        public:
+            void publish_state(const std::string& state) { this->state = state; }
+            void publish_state(const char* state) { this->state = state; }
+            // 2025.11: current_option() -> const char*
+            const char* current_option() const { return this->state.c_str(); }
+
+            SelectTraits traits;
+            std::string state;
+
+        protected:
+            virtual void control(const std::string& value) = 0;
+        };
+
+    }
+}
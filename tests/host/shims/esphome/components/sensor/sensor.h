@@ -0,0 +1,35 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace sensor {
+
+        enum StateClass : uint8_t { STATE_CLASS_NONE = 0, STATE_CLASS_MEASUREMENT = 1, STATE_CLASS_TOTAL_INCREASING = 2, STATE_CLASS_TOTAL = 3 };
+
+        class Sensor : public EntityBase {
+        public:
+            void publish_state(float state) {
+                this->state = state;
+                this->has_state_ = true;
+                this->publish_count_++;
+            }
+            float get_state() const { return this->state; }
+            bool has_state() const { return this->has_state_; }
+            uint32_t get_publish_count() const { return this->publish_count_; }
+            void set_unit_of_measurement(const char* unit) { (void)unit; }
+            void set_device_class(const char* device_class) { (void)device_class; }
+            void set_state_class(StateClass state_class) { (void)state_class; }
+            void set_accuracy_decimals(int8_t accuracy_decimals) { (void)accuracy_decimals; }
+            void set_force_update(bool force_update) { (void)force_update; }
+
+            float state{ NAN };
+
+        protected:
+            bool has_state_ = false;
+            uint32_t publish_count_ = 0;
+        };
+
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace switch_ {
+
+        class Switch : public EntityBase {
+        public:
+            void publish_state(bool state) { this->state = state; }
+
+            bool state{ false };
+
+        protected:
+            virtual void write_state(bool state) = 0;
+        };
+
+    }
+}
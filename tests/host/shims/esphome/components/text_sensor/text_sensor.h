@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include "esphome/core/entity_base.h"
+
+namespace esphome {
+    namespace text_sensor {
+
+        class TextSensor : public EntityBase {
+        public:
+            void publish_state(const std::string& state) {
+                this->state = state;
+                this->publish_count_++;
+            }
+            void publish_state(const char* state) {
+                this->state = state;
+                this->publish_count_++;
+            }
+            uint32_t get_publish_count() const { return this->publish_count_; }
+
+            std::string state;
+
+        protected:
+            uint32_t publish_count_ = 0;
+        };
+
+    }
+}
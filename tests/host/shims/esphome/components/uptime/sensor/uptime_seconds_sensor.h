@@ -0,0 +1,18 @@
+#pragma once
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+
+namespace esphome {
+    namespace uptime {
+
+        class UptimeSecondsSensor : public sensor::Sensor, public PollingComponent {
+        public:
+            void update() override { this->publish_state((float)(millis() / 1000)); }
+
+        protected:
+            uint64_t uptime_{ 0 };
+        };
+
+    }
+}
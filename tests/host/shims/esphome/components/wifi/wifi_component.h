@@ -0,0 +1,18 @@
+#pragma once
+
+namespace esphome {
+    namespace wifi {
+
+        class WiFiComponent {
+        public:
+            bool is_connected() { return this->connected_; }
+            void set_connected(bool connected) { this->connected_ = connected; }
+
+        protected:
+            bool connected_ = true;
+        };
+
+        extern WiFiComponent* global_wifi_component;
+
+    }
+}
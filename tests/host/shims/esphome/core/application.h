@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "esphome/core/scheduler.h"
+
+namespace esphome {
+
+    class Component;
+
+    /**
+     * @class Application
+     * @brief Boucle principale host: scheduler puis loop() des composants actifs, un passage toutes les
+     * loop_interval ms de temps simulé (16 ms par défaut, comme App.set_loop_interval).
+     */
+    class Application {
+    public:
+        const std::string& get_name() const { return this->name_; }
+        uint32_t get_config_hash() { return 0; }
+
+        void register_component(Component* component) { this->components_.push_back(component); }
+        void setup();
+        void loop();
+        /// enchaîne les passages de loop jusqu'à now + duration_ms (temps simulé)
+        void run_for(uint32_t duration_ms);
+        void set_loop_interval(uint32_t loop_interval_ms) { this->loop_interval_ms_ = loop_interval_ms; }
+        uint32_t get_loop_interval() const { return this->loop_interval_ms_; }
+        /// retire tous les composants (ex: entre deux scénarios d'un même test)
+        void reset();
+
+        Scheduler scheduler;
+
+    protected:
+        std::string name_ = "cn105-host";
+        std::vector<Component*> components_;
+        uint32_t loop_interval_ms_ = 16;
+    };
+
+    extern Application App;
+
+}
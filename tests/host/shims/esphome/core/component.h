@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace esphome {
+
+    enum class RetryResult { DONE, RETRY };
+
+    namespace setup_priority {
+        const float BUS = 1000.0f;
+        const float IO = 900.0f;
+        const float HARDWARE = 800.0f;
+        const float DATA = 600.0f;
+        const float PROCESSOR = 400.0f;
+        const float AFTER_WIFI = 250.0f;
+        const float LATE = -100.0f;
+    }
+
+    class Application;
+
+    class Component {
+    public:
+        virtual ~Component() = default;
+        virtual void setup() {}
+        virtual void loop() {}
+        virtual void dump_config() {}
+        virtual float get_setup_priority() const { return setup_priority::DATA; }
+        virtual float get_loop_priority() const { return 0.0f; }
+        virtual void on_shutdown() {}
+        virtual void on_safe_shutdown() {}
+
+        bool is_failed() const { return this->failed_; }
+        void mark_failed() { this->failed_ = true; }
+        void status_set_warning(const char* message = nullptr) { (void)message; this->warning_ = true; }
+        void status_clear_warning() { this->warning_ = false; }
+        bool status_has_warning() const { return this->warning_; }
+        uint32_t get_component_source() const { return 0; }
+
+        /// le loop n'est plus appelé par Application::loop() jusqu'à enable_loop()
+        void disable_loop() { this->loop_enabled_ = false; }
+        void enable_loop() { this->loop_enabled_ = true; }
+        /// utilisable depuis un autre thread: pris en compte au prochain passage d'Application::loop()
+        void enable_loop_soon_any_context() { this->pending_enable_loop_.store(true, std::memory_order_release); }
+        bool is_loop_enabled() const { return this->loop_enabled_; }
+
+        // mesures host (Application::loop): nombre d'appels à loop() et temps passé dedans
+        uint32_t get_host_loop_calls() const { return this->host_loop_calls_; }
+        uint64_t get_host_loop_ns() const { return this->host_loop_ns_; }
+
+    protected:
+        friend class Application;
+
+        void set_timeout(const std::string& name, uint32_t timeout, std::function<void()>&& f);
+        void set_timeout(const char* name, uint32_t timeout, std::function<void()>&& f);
+        void set_timeout(uint32_t timeout, std::function<void()>&& f);
+        bool cancel_timeout(const std::string& name);
+        bool cancel_timeout(const char* name);
+        void set_interval(const std::string& name, uint32_t interval, std::function<void()>&& f);
+        void set_interval(const char* name, uint32_t interval, std::function<void()>&& f);
+        void set_interval(uint32_t interval, std::function<void()>&& f);
+        bool cancel_interval(const std::string& name);
+        bool cancel_interval(const char* name);
+        void set_retry(const std::string& name, uint32_t initial_wait_time, uint8_t max_attempts,
+            std::function<RetryResult(uint8_t)>&& f, float backoff_increase_factor = 1.0f);
+        void defer(std::function<void()>&& f);
+        void defer(const char* name, std::function<void()>&& f);
+
+        bool failed_ = false;
+        bool warning_ = false;
+        bool loop_enabled_ = true;
+        std::atomic<bool> pending_enable_loop_{ false };
+        uint32_t host_loop_calls_ = 0;
+        uint64_t host_loop_ns_ = 0;
+    };
+
+    class PollingComponent : public Component {
+    public:
+        PollingComponent() = default;
+        explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+        virtual void update() = 0;
+        void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+        uint32_t get_update_interval() const { return this->update_interval_; }
+
+    protected:
+        uint32_t update_interval_ = 0;
+    };
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+    class EntityBase {
+    public:
+        const char* get_name() const { return this->name_; }
+        /// comme le code généré par ESPHome: le hash de l'object_id est la clé des préférences de l'entité
+        void set_name(const char* name) {
+            this->name_ = name;
+            this->object_id_hash_ = fnv1_hash(name);
+        }
+        std::string get_object_id() const { return this->name_; }
+        uint32_t get_object_id_hash() { return this->object_id_hash_; }
+        void set_internal(bool internal) { this->internal_ = internal; }
+        bool is_internal() const { return this->internal_; }
+
+    protected:
+        const char* name_ = "";
+        uint32_t object_id_hash_ = 0;
+        bool internal_ = false;
+    };
+
+}
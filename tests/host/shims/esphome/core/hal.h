@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+namespace esphome {
+
+    // horloge simulée (host_runtime.cpp): n'avance que par Application::loop(), delay() et host::advance_us()
+    uint32_t millis();
+    uint32_t micros();
+    void delay(uint32_t ms);
+    void delayMicroseconds(uint32_t us);
+    void yield();
+    uint32_t arch_get_cpu_cycle_count();
+    uint32_t arch_get_cpu_freq_hz();
+
+    namespace host {
+        uint64_t now_us();
+        void advance_us(uint64_t us);
+    }
+
+}
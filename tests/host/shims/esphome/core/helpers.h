@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+    std::string get_mac_address();
+    uint32_t fnv1_hash(const char* str);
+    inline uint32_t fnv1_hash(const std::string& str) { return fnv1_hash(str.c_str()); }
+    uint32_t random_uint32();
+
+    template<typename T> class optional {
+    public:
+        optional() {}
+        optional(T value) : value_(value), has_value_(true) {}
+        optional& operator=(T value) {
+            this->value_ = value;
+            this->has_value_ = true;
+            return *this;
+        }
+        bool has_value() const { return this->has_value_; }
+        T value() const { return this->value_; }
+        T value_or(T other) const { return this->has_value_ ? this->value_ : other; }
+        T operator*() const { return this->value_; }
+        void reset() { this->has_value_ = false; }
+
+    private:
+        T value_{};
+        bool has_value_ = false;
+    };
+
+    /// taille fixée une fois (init), comme dans ESPHome: une seule allocation
+    template<typename T> class FixedVector {
+    public:
+        void init(size_t n) { this->data_.reserve(n); }
+        void push_back(const T& value) { this->data_.push_back(value); }
+        size_t size() const { return this->data_.size(); }
+        const T& operator[](size_t i) const { return this->data_[i]; }
+        typename std::vector<T>::const_iterator begin() const { return this->data_.begin(); }
+        typename std::vector<T>::const_iterator end() const { return this->data_.end(); }
+
+    private:
+        std::vector<T> data_;
+    };
+
+    class StringRef {
+    public:
+        StringRef() = default;
+        StringRef(const char* str) : str_(str != nullptr ? str : "") {}
+        const char* c_str() const { return this->str_; }
+
+    private:
+        const char* str_ = "";
+    };
+
+    template<typename... X> class CallbackManager;
+    template<typename... Ts> class CallbackManager<void(Ts...)> {
+    public:
+        void add(std::function<void(Ts...)>&& callback) { this->callbacks_.push_back(std::move(callback)); }
+        void call(Ts... args) {
+            for (auto& cb : this->callbacks_) {
+                cb(args...);
+            }
+        }
+        size_t size() const { return this->callbacks_.size(); }
+
+    protected:
+        std::vector<std::function<void(Ts...)>> callbacks_;
+    };
+
+    /// backend host d'esphome::Mutex: std::mutex (le serveur d'historique tourne dans un autre contexte)
+    class Mutex {
+    public:
+        void lock() { this->mutex_.lock(); }
+        bool try_lock() { return this->mutex_.try_lock(); }
+        void unlock() { this->mutex_.unlock(); }
+
+    private:
+        std::mutex mutex_;
+    };
+
+    class LockGuard {
+    public:
+        LockGuard(Mutex& mutex) : mutex_(mutex) { this->mutex_.lock(); }
+        ~LockGuard() { this->mutex_.unlock(); }
+
+    private:
+        Mutex& mutex_;
+    };
+
+}
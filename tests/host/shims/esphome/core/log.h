@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdio>
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+
+// niveau de compilation des builds de production (logger: level: DEBUG)
+#ifndef ESPHOME_LOG_LEVEL
+#define ESPHOME_LOG_LEVEL ESPHOME_LOG_LEVEL_DEBUG
+#endif
+
+namespace esphome {
+
+    /// niveau d'affichage à l'exécution: variable d'environnement CN105_HOST_LOG (0..7), muet par défaut
+    int host_log_level();
+    void host_log_printf(int level, const char* tag, int line, const char* format, ...)
+        __attribute__((format(printf, 4, 5)));
+
+    namespace host {
+        /// remplace le niveau et la sortie (stderr par défaut), ex: logs DEBUG vers /dev/null pour les tests d'allocation
+        void set_log(int level, FILE* stream);
+    }
+
+}
+
+#define ESPHOME_HOST_LOG_(level, tag, ...) \
+    do { \
+        if (esphome::host_log_level() >= (level)) { \
+            esphome::host_log_printf((level), (tag), __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define ESP_LOGE(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+#define ESP_LOGV(tag, ...) ESPHOME_HOST_LOG_(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#else
+#define ESP_LOGV(tag, ...) do { } while (0)
+#endif
+
+#define LOG_STR_ARG(s) (s)
+#define LOG_SENSOR(prefix, type, obj) \
+    do { \
+        if ((obj) != nullptr) { \
+            ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name()); \
+        } \
+    } while (0)
+#define LOG_TEXT_SENSOR(prefix, type, obj) LOG_SENSOR(prefix, type, obj)
+#define LOG_SELECT(prefix, type, obj) LOG_SENSOR(prefix, type, obj)
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+
+    class ESPPreferenceBackend {
+    public:
+        virtual bool save(const uint8_t* data, size_t len) = 0;
+        virtual bool load(uint8_t* data, size_t len) = 0;
+    };
+
+    class ESPPreferenceObject {
+    public:
+        ESPPreferenceObject() = default;
+        explicit ESPPreferenceObject(ESPPreferenceBackend* backend) : backend_(backend) {}
+
+        template<typename T> bool save(const T* src) {
+            return this->backend_ != nullptr && this->backend_->save(reinterpret_cast<const uint8_t*>(src), sizeof(T));
+        }
+        template<typename T> bool load(T* dest) {
+            return this->backend_ != nullptr && this->backend_->load(reinterpret_cast<uint8_t*>(dest), sizeof(T));
+        }
+
+    private:
+        ESPPreferenceBackend* backend_ = nullptr;
+    };
+
+    class ESPPreferences {
+    public:
+        virtual ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) = 0;
+        template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = false) {
+            return this->make_preference(sizeof(T), type, in_flash);
+        }
+        virtual bool sync() = 0;
+    };
+
+    extern ESPPreferences* global_preferences;
+
+    namespace host {
+        /// efface la flash simulée (premier boot); sans appel, un nouvel objet retrouve l'état sauvegardé (reboot)
+        void preferences_clear();
+        /// nombre d'écritures de préférences depuis le lancement (usure flash)
+        uint32_t preferences_writes();
+    }
+
+}
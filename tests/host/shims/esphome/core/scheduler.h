@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace esphome {
+
+    class Component;
+
+    /**
+     * @class Scheduler
+     * @brief Timeouts et intervalles nommés par composant, sur l'horloge simulée.
+     *
+     * Mêmes règles qu'ESPHome: un nom est unique par composant et par type (un set_timeout remplace le
+     * précédent de même nom), un nom const char* est gardé par pointeur et comparé par contenu.
+     * Les entrées sont recyclées (comme le pool d'ESPHome): en régime établi, programmer un timeout
+     * n'alloue rien tant que le callback tient dans le stockage local de std::function.
+     */
+    class Scheduler {
+    public:
+        void set_timeout(Component* component, const char* name, uint32_t timeout_ms, std::function<void()>&& f);
+        void set_timeout(Component* component, const std::string& name, uint32_t timeout_ms, std::function<void()>&& f);
+        void set_interval(Component* component, const char* name, uint32_t interval_ms, std::function<void()>&& f);
+        void set_interval(Component* component, const std::string& name, uint32_t interval_ms, std::function<void()>&& f);
+        bool cancel_timeout(Component* component, const char* name);
+        bool cancel_interval(Component* component, const char* name);
+
+        /// exécute tout ce qui est échu à now_us, dans l'ordre des échéances
+        void call(uint64_t now_us);
+        /// prochaine échéance (UINT64_MAX si rien n'est programmé)
+        uint64_t next_deadline_us() const;
+        /// entrées actives appartenant à ce composant
+        size_t active_items(const Component* component) const;
+        size_t capacity() const { return this->items_.capacity(); }
+        /// oublie toutes les entrées (composants détruits entre deux scénarios)
+        void clear() { this->items_.clear(); }
+
+    protected:
+        struct Item {
+            Component* component = nullptr;
+            const char* static_name = nullptr;
+            std::string dynamic_name;
+            bool dynamic = false;
+            bool interval = false;
+            bool active = false;
+            bool running = false;
+            uint32_t interval_ms = 0;
+            uint64_t next_us = 0;
+            uint32_t sequence = 0;
+            std::function<void()> callback;
+
+            const char* name() const { return this->dynamic ? this->dynamic_name.c_str() : this->static_name; }
+        };
+
+        Item* find_(Component* component, const char* name, bool interval);
+        Item& acquire_(Component* component, const char* name, bool interval);
+        void schedule_(Item& item, uint32_t delay_ms, bool interval, std::function<void()>&& f);
+
+        std::vector<Item> items_;
+        uint32_t sequence_ = 0;
+    };
+
+}
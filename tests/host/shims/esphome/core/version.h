@@ -0,0 +1,4 @@
+#pragma once
+#define VERSION_CODE(major, minor, patch) ((major) << 16 | (minor) << 8 | (patch))
+// version contre laquelle la CI compile le composant (.github/workflows/build.yaml)
+#define ESPHOME_VERSION_CODE VERSION_CODE(2025, 11, 0)
@@ -0,0 +1,466 @@
+// Implémentation host des parties d'ESPHome utilisées par le composant cn105:
+// horloge simulée, scheduler, boucle principale, préférences en mémoire et logs.
+#include "esphome/core/application.h"
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/core/scheduler.h"
+#include "esphome/components/climate/climate.h"
+#include "esphome/components/wifi/wifi_component.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+
+namespace esphome {
+
+    // --- horloge simulée -----------------------------------------------------------------------------
+
+    // démarre après 500 ms, comme un ESP32 qui arrive dans setup()
+    static uint64_t now_us_ = 500000;
+
+    namespace host {
+        uint64_t now_us() { return now_us_; }
+        void advance_us(uint64_t us) { now_us_ += us; }
+    }
+
+    uint32_t millis() { return (uint32_t)(now_us_ / 1000); }
+    uint32_t micros() { return (uint32_t)now_us_; }
+    void delay(uint32_t ms) { now_us_ += (uint64_t)ms * 1000; }
+    void delayMicroseconds(uint32_t us) { now_us_ += us; }
+    void yield() {}
+    uint32_t arch_get_cpu_freq_hz() { return 240000000; }
+    uint32_t arch_get_cpu_cycle_count() { return (uint32_t)(now_us_ * 240); }
+
+    // --- logs ------------------------------------------------------------------------------------
+
+    static int log_level_ = -1;
+    static FILE* log_stream_ = nullptr;
+
+    int host_log_level() {
+        if (log_level_ < 0) {
+            const char* env = std::getenv("CN105_HOST_LOG");
+            log_level_ = env != nullptr ? std::atoi(env) : ESPHOME_LOG_LEVEL_NONE;
+        }
+        return log_level_;
+    }
+
+    namespace host {
+        void set_log(int level, FILE* stream) {
+            log_level_ = level;
+            log_stream_ = stream;
+        }
+    }
+
+    void host_log_printf(int level, const char* tag, int line, const char* format, ...) {
+        static const char LETTERS[] = "?EWICDVV";
+        const char letter = LETTERS[(level >= 0 && level <= 7) ? level : 0];
+        FILE* stream = log_stream_ != nullptr ? log_stream_ : stderr;
+        std::fprintf(stream, "[%10.3f][%c][%s:%03d]: ", now_us_ / 1e6, letter, tag, line);
+        va_list args;
+        va_start(args, format);
+        std::vfprintf(stream, format, args);
+        va_end(args);
+        std::fputc('\n', stream);
+    }
+
+    // --- helpers ---------------------------------------------------------------------------------
+
+    std::string get_mac_address() { return "02cafe010105"; }
+
+    uint32_t fnv1_hash(const char* str) {
+        uint32_t hash = 2166136261UL;
+        for (; *str != '\0'; str++) {
+            hash *= 16777619UL;
+            hash ^= (uint8_t)*str;
+        }
+        return hash;
+    }
+
+    uint32_t random_uint32() {
+        static uint32_t state = 0x2545F491;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    namespace climate {
+
+        const char* climate_mode_to_string(ClimateMode mode) {
+            switch (mode) {
+            case CLIMATE_MODE_OFF: return "OFF";
+            case CLIMATE_MODE_HEAT_COOL: return "HEAT_COOL";
+            case CLIMATE_MODE_COOL: return "COOL";
+            case CLIMATE_MODE_HEAT: return "HEAT";
+            case CLIMATE_MODE_FAN_ONLY: return "FAN_ONLY";
+            case CLIMATE_MODE_DRY: return "DRY";
+            case CLIMATE_MODE_AUTO: return "AUTO";
+            }
+            return "UNKNOWN";
+        }
+
+        const char* climate_fan_mode_to_string(ClimateFanMode fan_mode) {
+            switch (fan_mode) {
+            case CLIMATE_FAN_ON: return "ON";
+            case CLIMATE_FAN_OFF: return "OFF";
+            case CLIMATE_FAN_AUTO: return "AUTO";
+            case CLIMATE_FAN_LOW: return "LOW";
+            case CLIMATE_FAN_MEDIUM: return "MEDIUM";
+            case CLIMATE_FAN_HIGH: return "HIGH";
+            case CLIMATE_FAN_MIDDLE: return "MIDDLE";
+            case CLIMATE_FAN_FOCUS: return "FOCUS";
+            case CLIMATE_FAN_DIFFUSE: return "DIFFUSE";
+            case CLIMATE_FAN_QUIET: return "QUIET";
+            }
+            return "UNKNOWN";
+        }
+
+        const char* climate_swing_mode_to_string(ClimateSwingMode swing_mode) {
+            switch (swing_mode) {
+            case CLIMATE_SWING_OFF: return "OFF";
+            case CLIMATE_SWING_BOTH: return "BOTH";
+            case CLIMATE_SWING_VERTICAL: return "VERTICAL";
+            case CLIMATE_SWING_HORIZONTAL: return "HORIZONTAL";
+            }
+            return "UNKNOWN";
+        }
+
+    }
+
+    namespace wifi {
+        // pas de WiFi sur le build host (USE_WIFI non défini)
+        WiFiComponent* global_wifi_component = nullptr;
+    }
+
+    // --- préférences -----------------------------------------------------------------------------
+
+    static std::map<uint32_t, std::vector<uint8_t>> flash_;
+    static uint32_t flash_writes_ = 0;
+
+    class HostPreferenceBackend : public ESPPreferenceBackend {
+    public:
+        HostPreferenceBackend(uint32_t key, size_t length) : key_(key), length_(length) {}
+
+        bool save(const uint8_t* data, size_t len) override {
+            if (len != this->length_) {
+                return false;
+            }
+            std::vector<uint8_t>& slot = flash_[this->key_];
+            slot.assign(data, data + len);
+            flash_writes_++;
+            return true;
+        }
+
+        bool load(uint8_t* data, size_t len) override {
+            auto it = flash_.find(this->key_);
+            // taille différente: type changé depuis la sauvegarde, comme une préférence ESPHome invalide
+            if (it == flash_.end() || it->second.size() != len || len != this->length_) {
+                return false;
+            }
+            std::memcpy(data, it->second.data(), len);
+            return true;
+        }
+
+    protected:
+        uint32_t key_;
+        size_t length_;
+    };
+
+    class HostPreferences : public ESPPreferences {
+    public:
+        ESPPreferenceObject make_preference(size_t length, uint32_t type, bool in_flash) override {
+            (void)in_flash;
+            this->backends_.emplace_back(type, length);
+            return ESPPreferenceObject(&this->backends_.back());
+        }
+        bool sync() override { return true; }
+
+    protected:
+        std::deque<HostPreferenceBackend> backends_;
+    };
+
+    static HostPreferences host_preferences_;
+    ESPPreferences* global_preferences = &host_preferences_;
+
+    namespace host {
+        void preferences_clear() { flash_.clear(); }
+        uint32_t preferences_writes() { return flash_writes_; }
+    }
+
+    // --- scheduler -------------------------------------------------------------------------------
+
+    static bool same_name(const char* a, const char* b) {
+        return a != nullptr && b != nullptr && (a == b || std::strcmp(a, b) == 0);
+    }
+
+    Scheduler::Item* Scheduler::find_(Component* component, const char* name, bool interval) {
+        for (auto& item : this->items_) {
+            if (item.active && item.component == component && item.interval == interval && same_name(item.name(), name)) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+
+    Scheduler::Item& Scheduler::acquire_(Component* component, const char* name, bool interval) {
+        Item* existing = this->find_(component, name, interval);
+        if (existing != nullptr) {
+            if (!existing->running) {
+                return *existing;     // remplacement sur place
+            }
+            existing->active = false;   // en cours d'exécution: libéré à la fin de son callback
+        }
+        for (auto& item : this->items_) {
+            if (!item.active && !item.running) {
+                return item;
+            }
+        }
+        this->items_.emplace_back();
+        return this->items_.back();
+    }
+
+    void Scheduler::schedule_(Item& item, uint32_t delay_ms, bool interval, std::function<void()>&& f) {
+        item.interval = interval;
+        item.interval_ms = delay_ms;
+        item.next_us = host::now_us() + (uint64_t)delay_ms * 1000;
+        item.sequence = this->sequence_++;
+        item.callback = std::move(f);
+        item.active = true;
+    }
+
+    void Scheduler::set_timeout(Component* component, const char* name, uint32_t timeout_ms, std::function<void()>&& f) {
+        Item& item = this->acquire_(component, name, false);
+        item.component = component;
+        item.static_name = name;
+        item.dynamic = false;
+        this->schedule_(item, timeout_ms, false, std::move(f));
+    }
+
+    void Scheduler::set_timeout(Component* component, const std::string& name, uint32_t timeout_ms, std::function<void()>&& f) {
+        Item& item = this->acquire_(component, name.c_str(), false);
+        item.component = component;
+        item.dynamic_name.assign(name);
+        item.dynamic = true;
+        this->schedule_(item, timeout_ms, false, std::move(f));
+    }
+
+    void Scheduler::set_interval(Component* component, const char* name, uint32_t interval_ms, std::function<void()>&& f) {
+        Item& item = this->acquire_(component, name, true);
+        item.component = component;
+        item.static_name = name;
+        item.dynamic = false;
+        this->schedule_(item, interval_ms, true, std::move(f));
+    }
+
+    void Scheduler::set_interval(Component* component, const std::string& name, uint32_t interval_ms, std::function<void()>&& f) {
+        Item& item = this->acquire_(component, name.c_str(), true);
+        item.component = component;
+        item.dynamic_name.assign(name);
+        item.dynamic = true;
+        this->schedule_(item, interval_ms, true, std::move(f));
+    }
+
+    bool Scheduler::cancel_timeout(Component* component, const char* name) {
+        Item* item = this->find_(component, name, false);
+        if (item == nullptr) {
+            return false;
+        }
+        item->active = false;
+        if (!item->running) {
+            item->callback = nullptr;
+        }
+        return true;
+    }
+
+    bool Scheduler::cancel_interval(Component* component, const char* name) {
+        Item* item = this->find_(component, name, true);
+        if (item == nullptr) {
+            return false;
+        }
+        item->active = false;
+        if (!item->running) {
+            item->callback = nullptr;
+        }
+        return true;
+    }
+
+    void Scheduler::call(uint64_t now_us) {
+        // ce qui est programmé pendant ce passage (même à 0 ms) attend le suivant, comme dans ESPHome
+        const uint32_t pass_sequence = this->sequence_;
+        while (true) {
+            size_t due = this->items_.size();
+            for (size_t i = 0; i < this->items_.size(); i++) {
+                const Item& item = this->items_[i];
+                if (!item.active || item.running || item.next_us > now_us || (int32_t)(item.sequence - pass_sequence) >= 0) {
+                    continue;
+                }
+                if (due == this->items_.size() || item.next_us < this->items_[due].next_us ||
+                    (item.next_us == this->items_[due].next_us && item.sequence < this->items_[due].sequence)) {
+                    due = i;
+                }
+            }
+            if (due == this->items_.size()) {
+                return;
+            }
+
+            // le callback peut reprogrammer (et agrandir items_): on l'exécute hors du vecteur
+            std::function<void()> callback = std::move(this->items_[due].callback);
+            Item& item = this->items_[due];
+            item.running = true;
+            if (item.interval) {
+                item.next_us = now_us + (uint64_t)item.interval_ms * 1000;
+                item.sequence = this->sequence_++;
+            } else {
+                item.active = false;
+            }
+
+            callback();
+
+            Item& after = this->items_[due];
+            after.running = false;
+            if (after.active) {
+                after.callback = std::move(callback);
+            }
+        }
+    }
+
+    uint64_t Scheduler::next_deadline_us() const {
+        uint64_t next = UINT64_MAX;
+        for (const auto& item : this->items_) {
+            if (item.active && item.next_us < next) {
+                next = item.next_us;
+            }
+        }
+        return next;
+    }
+
+    size_t Scheduler::active_items(const Component* component) const {
+        size_t count = 0;
+        for (const auto& item : this->items_) {
+            if (item.active && item.component == component) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // --- Component -------------------------------------------------------------------------------
+
+    void Component::set_timeout(const std::string& name, uint32_t timeout, std::function<void()>&& f) {
+        App.scheduler.set_timeout(this, name, timeout, std::move(f));
+    }
+    void Component::set_timeout(const char* name, uint32_t timeout, std::function<void()>&& f) {
+        App.scheduler.set_timeout(this, name, timeout, std::move(f));
+    }
+    void Component::set_timeout(uint32_t timeout, std::function<void()>&& f) {
+        App.scheduler.set_timeout(this, (const char*)nullptr, timeout, std::move(f));
+    }
+    bool Component::cancel_timeout(const std::string& name) { return App.scheduler.cancel_timeout(this, name.c_str()); }
+    bool Component::cancel_timeout(const char* name) { return App.scheduler.cancel_timeout(this, name); }
+    void Component::set_interval(const std::string& name, uint32_t interval, std::function<void()>&& f) {
+        App.scheduler.set_interval(this, name, interval, std::move(f));
+    }
+    void Component::set_interval(const char* name, uint32_t interval, std::function<void()>&& f) {
+        App.scheduler.set_interval(this, name, interval, std::move(f));
+    }
+    void Component::set_interval(uint32_t interval, std::function<void()>&& f) {
+        App.scheduler.set_interval(this, (const char*)nullptr, interval, std::move(f));
+    }
+    bool Component::cancel_interval(const std::string& name) { return App.scheduler.cancel_interval(this, name.c_str()); }
+    bool Component::cancel_interval(const char* name) { return App.scheduler.cancel_interval(this, name); }
+    void Component::defer(std::function<void()>&& f) { this->set_timeout((uint32_t)0, std::move(f)); }
+    void Component::defer(const char* name, std::function<void()>&& f) { this->set_timeout(name, 0, std::move(f)); }
+
+    namespace {
+        struct RetryArgs {
+            std::function<RetryResult(uint8_t)> func;
+            std::string name;
+            uint8_t retry_countdown;
+            uint32_t current_interval;
+            float backoff_increase_factor;
+            Component* component;
+        };
+
+        // même déroulé qu'ESPHome: premier essai tout de suite, puis intervalle multiplié à chaque RETRY
+        void retry_handler(const std::shared_ptr<RetryArgs>& args) {
+            const RetryResult result = args->func(--args->retry_countdown);
+            if (result == RetryResult::DONE || args->retry_countdown <= 0) {
+                return;
+            }
+            App.scheduler.set_timeout(args->component, args->name, args->current_interval, [args]() { retry_handler(args); });
+            args->current_interval = (uint32_t)(args->current_interval * args->backoff_increase_factor);
+        }
+    }
+
+    void Component::set_retry(const std::string& name, uint32_t initial_wait_time, uint8_t max_attempts,
+        std::function<RetryResult(uint8_t)>&& f, float backoff_increase_factor) {
+        auto args = std::make_shared<RetryArgs>();
+        args->func = std::move(f);
+        args->name = name;
+        args->retry_countdown = max_attempts;
+        args->current_interval = initial_wait_time;
+        args->backoff_increase_factor = backoff_increase_factor;
+        args->component = this;
+        App.scheduler.set_timeout(this, name, 0, [args]() { retry_handler(args); });
+    }
+
+    // --- Application -----------------------------------------------------------------------------
+
+    Application App;
+
+    void Application::setup() {
+        std::stable_sort(this->components_.begin(), this->components_.end(), [](Component* a, Component* b) {
+            return a->get_setup_priority() > b->get_setup_priority();
+            });
+        for (Component* component : this->components_) {
+            component->setup();
+        }
+    }
+
+    void Application::loop() {
+        const uint64_t start_us = host::now_us();
+        this->scheduler.call(start_us);
+
+        for (Component* component : this->components_) {
+            if (component->pending_enable_loop_.exchange(false, std::memory_order_acq_rel)) {
+                component->loop_enabled_ = true;
+            }
+            if (!component->loop_enabled_ || component->failed_) {
+                continue;
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            component->loop();
+            const auto t1 = std::chrono::steady_clock::now();
+            component->host_loop_calls_++;
+            component->host_loop_ns_ += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+        }
+
+        // un passage toutes les loop_interval ms (delay() dans un loop peut déjà avoir dépassé l'échéance)
+        const uint64_t next_us = start_us + (uint64_t)this->loop_interval_ms_ * 1000;
+        if (host::now_us() < next_us) {
+            host::advance_us(next_us - host::now_us());
+        }
+    }
+
+    void Application::run_for(uint32_t duration_ms) {
+        const uint64_t end_us = host::now_us() + (uint64_t)duration_ms * 1000;
+        while (host::now_us() < end_us) {
+            this->loop();
+        }
+    }
+
+    void Application::reset() {
+        this->components_.clear();
+        this->scheduler.clear();
+    }
+
+}
@@ -0,0 +1,264 @@
+#include "sim_unit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace cn105_host {
+
+    static const uint8_t FRAME_START = 0xFC;
+    // index = code de consigne (16 pas)
+    static const int TEMP_MAP[16] = { 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16 };
+    // mêmes octets que HPEmulator::CONFIG_RESPONSE (connexion étendue / installateur)
+    static const uint8_t CONFIG_RESPONSE_DATA[16] = { 0xC9, 0x03, 0x00, 0x20, 0x00, 0x14, 0x07, 0x75, 0x0C, 0x05,
+                                                      0xA0, 0xBE, 0x94, 0xBE, 0xA0, 0xBE };
+
+    static const uint8_t MODE_HEAT = 0x01;
+    static const uint8_t MODE_DRY = 0x02;
+    static const uint8_t MODE_COOL = 0x03;
+    static const uint8_t MODE_AUTO = 0x08;
+
+    static float fan_speed(uint8_t fan) {
+        switch (fan) {
+        case 0x01: return 0.3f;
+        case 0x02: return 0.4f;
+        case 0x05: return 0.8f;
+        case 0x06: return 1.0f;
+        default: return 0.6f;
+        }
+    }
+
+    static uint8_t encode_half_degree(float value) {
+        const int v = (int)std::lround(value * 2) + 128;
+        return (uint8_t)std::max(0, std::min(255, v));
+    }
+
+    SimulatedUnit::SimulatedUnit(float room, float outside) : room(room), outside(outside) {
+        for (int code = 101; code <= 128; code++) {
+            this->functions[code - 100] = (uint8_t)(1 + (code % 3));
+        }
+    }
+
+    uint8_t SimulatedUnit::checksum(const uint8_t* frame, size_t len) {
+        uint8_t sum = 0;
+        for (size_t i = 0; i < len; i++) {
+            sum += frame[i];
+        }
+        return (uint8_t)(0xFC - sum);
+    }
+
+    size_t SimulatedUnit::make_frame(uint8_t cmd, const uint8_t* data, size_t data_len, uint8_t* out) {
+        out[0] = FRAME_START;
+        out[1] = cmd;
+        out[2] = 0x01;
+        out[3] = 0x30;
+        out[4] = (uint8_t)data_len;
+        std::memcpy(out + 5, data, data_len);
+        out[5 + data_len] = checksum(out, 5 + data_len);
+        return data_len + 6;
+    }
+
+    float SimulatedUnit::control_temperature_() const {
+        return (this->remote_temp > -100.0f) ? this->remote_temp : this->room;
+    }
+
+    int SimulatedUnit::demand_sign_() const {
+        switch (this->mode) {
+        case MODE_HEAT: return 1;
+        case MODE_COOL:
+        case MODE_DRY: return -1;
+        case MODE_AUTO: return (this->control_temperature_() < this->setpoint) ? 1 : -1;
+        default: return 0;
+        }
+    }
+
+    void SimulatedUnit::step(float dt) {
+        const int sign = this->power ? this->demand_sign_() : 0;
+        float target = 0.0f;
+        if (sign != 0) {
+            const float error = sign * (this->setpoint - this->control_temperature_());
+            this->integral = std::max(-3600.0f, std::min(3600.0f, this->integral + error * dt));
+            target = KP_HZ_PER_K * error + KI_HZ_PER_KS * this->integral;
+            if (this->mode == MODE_DRY) {
+                target = std::min(target, 0.4f * MAX_FREQUENCY_HZ);
+            }
+            target = (target < MIN_FREQUENCY_HZ) ? 0.0f : std::min(target, MAX_FREQUENCY_HZ);
+        } else {
+            this->integral = 0.0f;
+        }
+
+        const float max_delta = FREQUENCY_SLEW_HZ_S * dt;
+        this->frequency += std::max(-max_delta, std::min(max_delta, target - this->frequency));
+        if (target == 0.0f && this->frequency < MIN_FREQUENCY_HZ) {
+            this->frequency = 0.0f;
+        }
+
+        const float compressor_watts = this->frequency * WATTS_PER_HZ;
+        const float fan_watts = this->power ? FAN_WATTS * fan_speed(this->fan) : 0.0f;
+        this->input_watts = STANDBY_WATTS + compressor_watts + fan_watts;
+        const float heat_watts = sign * compressor_watts * COP;
+
+        const float losses = (this->outside - this->room) / ROOM_TIME_CONSTANT_S;
+        this->room += (losses + heat_watts / ROOM_HEAT_CAPACITY_J_K) * dt;
+        this->energy_wh += this->input_watts * dt / 3600.0;
+        if (this->power) {
+            this->runtime_s += dt;
+        }
+    }
+
+    size_t SimulatedUnit::handle(const uint8_t* frame, size_t len, uint8_t* out) {
+        this->frames_in++;
+        const uint8_t cmd = frame[1];
+        const uint8_t* data = frame + 5;
+        const size_t data_len = len - 6;
+        uint8_t payload[16] = {};
+
+        switch (cmd) {
+        case 0x5A:
+            return make_frame(0x7A, payload, 1, out);
+        case 0x5B:
+            return make_frame(0x7B, CONFIG_RESPONSE_DATA, sizeof(CONFIG_RESPONSE_DATA), out);
+        case 0x41:
+            if (data_len == 0) {
+                return 0;
+            }
+            this->apply_set_(data, data_len);
+            return make_frame(0x61, payload, sizeof(payload), out);
+        case 0x42:
+            if (data_len == 0) {
+                return 0;
+            }
+            this->info_(data[0], payload);
+            return make_frame(0x62, payload, sizeof(payload), out);
+        default:
+            return 0;
+        }
+    }
+
+    void SimulatedUnit::apply_set_(const uint8_t* data, size_t len) {
+        if (len < 16) {
+            return;
+        }
+        this->sets++;
+        switch (data[0]) {
+        case 0x01: {
+            const uint8_t mask1 = data[1];
+            const uint8_t mask2 = data[2];
+            if (mask1 & 0x01) {
+                this->power = data[3];
+            }
+            if (mask1 & 0x02) {
+                this->mode = data[4];
+            }
+            if (mask1 & 0x04) {
+                // consigne au demi-degré (data[14]) prioritaire sur l'ancien code à 16 pas
+                const float before = this->setpoint;
+                if (data[14]) {
+                    this->setpoint = (data[14] - 128) / 2.0f;
+                } else if (data[5] < 16) {
+                    this->setpoint = (float)TEMP_MAP[data[5]];
+                }
+                if (this->setpoint != before) {
+                    this->setpoint_changes++;
+                }
+            }
+            if (mask1 & 0x08) {
+                this->fan = data[6];
+            }
+            if (mask1 & 0x10) {
+                this->vane = data[7];
+            }
+            if (mask2 & 0x01) {
+                this->wide_vane = data[13] & 0x0F;
+            }
+            break;
+        }
+        case 0x07:
+            this->remote_temp = (data[1] == 0x01) ? (data[3] - 128) / 2.0f : -1000.0f;
+            break;
+        case 0x08:
+            this->airflow_control = data[6];
+            this->air_purifier = data[12];
+            this->night_mode = data[13];
+            this->circulator = data[14];
+            break;
+        case 0x1F:
+        case 0x21:
+            for (size_t i = 1; i < 16; i++) {
+                const uint8_t b = data[i];
+                const int code = (b >> 2) + 100;
+                if (b != 0 && code >= 101 && code <= 128) {
+                    this->functions[code - 100] = b & 0x03;
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void SimulatedUnit::info_(uint8_t code, uint8_t* d) {
+        d[0] = code;
+        switch (code) {
+        case 0x02: {
+            d[3] = this->power;
+            d[4] = this->mode;
+            const int rounded = std::max(16, std::min(31, (int)std::lround(this->setpoint)));
+            d[5] = (uint8_t)(31 - rounded);
+            d[6] = this->fan;
+            d[7] = this->vane;
+            d[10] = this->wide_vane;
+            d[11] = encode_half_degree(this->setpoint);
+            d[14] = this->airflow_control;
+            break;
+        }
+        case 0x03: {
+            d[3] = (uint8_t)std::max(0, std::min(31, (int)std::lround(this->room) - 10));
+            d[5] = encode_half_degree(this->outside);
+            d[6] = encode_half_degree(this->room);
+            const uint32_t minutes = (uint32_t)(this->runtime_s / 60) & 0xFFFFFF;
+            d[11] = (minutes >> 16) & 0xFF;
+            d[12] = (minutes >> 8) & 0xFF;
+            d[13] = minutes & 0xFF;
+            break;
+        }
+        case 0x06: {
+            d[3] = (uint8_t)std::lround(this->frequency);
+            d[4] = (this->frequency > 0) ? 0x01 : 0x00;
+            const uint32_t watts = (uint32_t)std::lround(this->input_watts) & 0xFFFF;
+            d[5] = watts >> 8;
+            d[6] = watts & 0xFF;
+            const uint32_t tenths = (uint32_t)(this->energy_wh / 100) & 0xFFFF;
+            d[7] = tenths >> 8;
+            d[8] = tenths & 0xFF;
+            break;
+        }
+        case 0x09: {
+            d[3] = (this->power && this->frequency == 0) ? 0x08 : 0x00;
+            d[4] = (this->frequency == 0) ? 0 : (uint8_t)(1 + std::min(4, (int)(this->frequency * 5 / MAX_FREQUENCY_HZ)));
+            if (this->mode == MODE_AUTO) {
+                d[5] = (this->demand_sign_() > 0) ? 0x02 : 0x01;
+            }
+            break;
+        }
+        case 0x42:
+            d[1] = this->air_purifier;
+            d[2] = this->night_mode;
+            d[3] = this->circulator;
+            break;
+        case 0x20:
+        case 0x22: {
+            const int first = (code == 0x20) ? 101 : 116;
+            const int last = (code == 0x20) ? 115 : 128;
+            for (int fcode = first; fcode <= last; fcode++) {
+                d[1 + fcode - first] = (uint8_t)(((fcode - 100) << 2) | this->functions[fcode - 100]);
+            }
+            break;
+        }
+        default:
+            // 0x04 (inconnu) et 0x05 (timers): payload vide, comme la plupart des unités
+            break;
+        }
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cn105_host {
+
+    /**
+     * @class SimulatedUnit
+     * @brief Unité intérieure simulée, côté CN105.
+     *
+     * CONNECT 0x5A/0x5B -> 0x7A/0x7B, SET 0x41 -> 0x61, INFO 0x42 -> 0x62. Température de la pièce,
+     * fréquence du compresseur, puissance, kWh et heures de fonctionnement suivent un petit modèle
+     * thermique et inverter (sans bruit sur la température extérieure ni dégivrage).
+     */
+    class SimulatedUnit {
+    public:
+        static constexpr size_t MAX_FRAME = 22;
+
+        explicit SimulatedUnit(float room = 19.0f, float outside = 7.0f);
+
+        /// réponse à une trame valide (longueur écrite dans out, 0 si une vraie unité se tait)
+        size_t handle(const uint8_t* frame, size_t len, uint8_t* out);
+        /// avance les modèles de dt secondes
+        void step(float dt);
+
+        // réglages (octets du protocole)
+        uint8_t power = 0x01;
+        uint8_t mode = 0x01;
+        float setpoint = 21.0f;
+        uint8_t fan = 0x00;
+        uint8_t vane = 0x00;
+        uint8_t wide_vane = 0x03;
+        uint8_t airflow_control = 0x00;
+        uint8_t air_purifier = 0;
+        uint8_t night_mode = 0;
+        uint8_t circulator = 0;
+        uint8_t functions[29] = {};     // codes 101..128 (index code - 100), 0 = non supporté
+
+        // modèle physique
+        float room;
+        float outside;
+        float remote_temp = -1000.0f;   // < -100: capteur interne
+        float frequency = 0.0f;
+        float integral = 0.0f;
+        float input_watts = STANDBY_WATTS;
+        double energy_wh = 0.0;
+        double runtime_s = 0.0;
+
+        // statistiques
+        uint32_t frames_in = 0;
+        uint32_t sets = 0;
+        uint32_t setpoint_changes = 0;
+
+        static uint8_t checksum(const uint8_t* frame, size_t len);
+        static size_t make_frame(uint8_t cmd, const uint8_t* data, size_t data_len, uint8_t* out);
+
+    protected:
+        static constexpr float ROOM_TIME_CONSTANT_S = 3 * 3600.0f;
+        static constexpr float ROOM_HEAT_CAPACITY_J_K = 2.5e6f;
+        static constexpr float MAX_FREQUENCY_HZ = 90.0f;
+        static constexpr float MIN_FREQUENCY_HZ = 15.0f;
+        static constexpr float FREQUENCY_SLEW_HZ_S = 0.5f;
+        static constexpr float KP_HZ_PER_K = 25.0f;
+        static constexpr float KI_HZ_PER_KS = 0.02f;
+        static constexpr float COP = 3.5f;
+        static constexpr float WATTS_PER_HZ = 11.0f;
+        static constexpr float FAN_WATTS = 25.0f;
+        static constexpr float STANDBY_WATTS = 4.0f;
+
+        float control_temperature_() const;
+        int demand_sign_() const;
+        void apply_set_(const uint8_t* data, size_t len);
+        void info_(uint8_t code, uint8_t* d);
+    };
+
+}
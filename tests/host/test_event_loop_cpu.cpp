@@ -0,0 +1,81 @@
+// Mesure avant/après de event_driven_loop: passes de loop() et temps CPU ramenés à l'heure, avec et sans tâche RX.
+// Échoue si le mode événementiel ne réduit pas les passes ou fait perdre des cycles.
+//   test_event_loop_cpu [secondes simulées par scénario, 600 par défaut]
+
+#include "host_check.h"
+#include "host_node.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using cn105_host::HostNode;
+using cn105_host::NodeConfig;
+
+namespace {
+
+    uint32_t measure_s = 600;
+
+    struct LoopCost {
+        uint64_t passes;
+        uint64_t loop_ns;
+        unsigned long cycles;
+    };
+
+    LoopCost measure(const char* label, const NodeConfig& config) {
+        std::unique_ptr<HostNode> node(new HostNode(config));
+        HOST_CHECK(node->start_connected());
+
+        const uint64_t passes_before = node->climate.get_host_loop_calls();
+        const uint64_t ns_before = node->climate.get_host_loop_ns();
+        const unsigned long cycles_before = node->climate.nbCompleteCycles_;
+        node->run(measure_s * 1000);
+        LoopCost cost;
+        cost.passes = node->climate.get_host_loop_calls() - passes_before;
+        cost.loop_ns = node->climate.get_host_loop_ns() - ns_before;
+        cost.cycles = node->climate.nbCompleteCycles_ - cycles_before;
+
+        const double per_hour = 3600.0 / measure_s;
+        std::printf("%-24s %9.0f passes/h %9.1f ms CPU/h (host) %6.0f cycles/h\n", label, cost.passes * per_hour,
+            cost.loop_ns / 1e6 * per_hour, cost.cycles * per_hour);
+        esphome::App.reset();
+        return cost;
+    }
+
+    void compare(const LoopCost& before, const LoopCost& after, double max_pass_ratio) {
+        HOST_CHECK(before.passes > 0);
+        HOST_CHECK(after.passes <= before.passes * max_pass_ratio);
+        // autant de cycles complets à 5% près: le sommeil ne retarde pas le polling
+        HOST_CHECK(after.cycles * 100 >= before.cycles * 95);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        measure_s = (uint32_t)std::strtoul(argv[1], nullptr, 10);
+    }
+    NodeConfig config;
+    std::printf("one unit, %u s simulated per scenario, update interval %u ms, 2400 bauds 8E1:\n", (unsigned)measure_s,
+        (unsigned)config.update_interval_ms);
+
+    const LoopCost polling = measure("polling", config);
+    config.event_driven_loop = true;
+    const LoopCost event_driven = measure("event driven", config);
+
+    // sans tâche RX le loop lit lui-même les réponses: il ne dort qu'entre deux cycles
+    compare(polling, event_driven, 0.9);
+
+    // réponses livrées d'un bloc (une seule attente de la tâche RX par trame)
+    config.link.wire_speed = false;
+    config.uart_rx_task = true;
+    config.event_driven_loop = false;
+    const LoopCost rx_polling = measure("rx task, polling", config);
+    config.event_driven_loop = true;
+    const LoopCost rx_event_driven = measure("rx task, event driven", config);
+
+    // avec la tâche RX le loop dort aussi pendant que les réponses arrivent
+    compare(rx_polling, rx_event_driven, 0.1);
+
+    return HOST_CHECK_RESULT();
+}
@@ -0,0 +1,191 @@
+// Tests host de la chaîne de réception: SpscQueue, FrameAssembler et UartRxTask (backend std::thread).
+
+#include "host_check.h"
+#include "host_uart.h"
+#include "sim_unit.h"
+#include "uart_rx_task.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using cn105_host::SimulatedUnit;
+using esphome::FrameAssembler;
+using esphome::RxFrame;
+
+namespace {
+
+    using Result = FrameAssembler::Result;
+
+    size_t info_frame(uint8_t code, uint8_t* out) {
+        uint8_t data[16] = { code };
+        return SimulatedUnit::make_frame(0x62, data, sizeof(data), out);
+    }
+
+    /// passe la trame octet par octet, renvoie le dernier résultat différent de PENDING (PENDING sinon)
+    Result feed_all(FrameAssembler& assembler, const uint8_t* bytes, size_t len) {
+        Result last = Result::PENDING;
+        for (size_t i = 0; i < len; i++) {
+            Result result = assembler.feed(bytes[i]);
+            if (result != Result::PENDING) {
+                last = result;
+            }
+        }
+        return last;
+    }
+
+    void test_queue_full_and_order() {
+        esphome::SpscQueue<int, 4> queue;
+        int out = -1;
+        HOST_CHECK(queue.empty());
+        HOST_CHECK(!queue.pop(out));
+        for (int i = 0; i < 4; i++) {
+            HOST_CHECK(queue.push(i));
+        }
+        HOST_CHECK(!queue.push(99));        // pleine: refusé, rien d'écrasé
+        for (int i = 0; i < 4; i++) {
+            HOST_CHECK(queue.pop(out));
+            HOST_CHECK_EQ(out, i);
+        }
+        HOST_CHECK(queue.empty());
+    }
+
+    void test_queue_wraparound() {
+        // head_/tail_ font de nombreux tours des 4 slots, avec un remplissage variable (vide, partiel, plein)
+        esphome::SpscQueue<int, 4> queue;
+        int next_in = 0;
+        int next_out = 0;
+        int fill = 0;
+        for (int round = 0; round < 1000; round++) {
+            for (int i = 0; i < (round * 7) % 5; i++) {
+                const bool room = fill < 4;
+                HOST_CHECK(queue.push(next_in) == room);
+                if (room) {
+                    next_in++;
+                    fill++;
+                }
+            }
+            for (int i = 0; i < (round * 3) % 5; i++) {
+                int out = -1;
+                const bool pending = fill > 0;
+                HOST_CHECK(queue.pop(out) == pending);
+                if (pending) {
+                    HOST_CHECK_EQ(out, next_out++);
+                    fill--;
+                }
+            }
+            HOST_CHECK(queue.empty() == (fill == 0));
+        }
+        HOST_CHECK(next_in > 1000);
+    }
+
+    void test_assembler_frames() {
+        FrameAssembler assembler;
+        uint8_t frame[SimulatedUnit::MAX_FRAME + 6];
+
+        const size_t len = info_frame(0x03, frame);
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::FRAME_OK);
+        HOST_CHECK_EQ(assembler.frame().length, len);
+        HOST_CHECK(assembler.frame().checksumOk);
+        HOST_CHECK_EQ(assembler.frame().bytes[5], 0x03);
+
+        // checksum faux: la trame complète est quand même rendue, marquée invalide
+        frame[len - 1] ^= 0x01;
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::BAD_CHECKSUM);
+        HOST_CHECK_EQ(assembler.frame().length, len);
+        HOST_CHECK(!assembler.frame().checksumOk);
+        frame[len - 1] ^= 0x01;
+
+        // et la trame suivante repart proprement
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::FRAME_OK);
+        HOST_CHECK(assembler.frame().checksumOk);
+    }
+
+    void test_assembler_resync() {
+        FrameAssembler assembler;
+        uint8_t frame[SimulatedUnit::MAX_FRAME + 6];
+        const size_t len = info_frame(0x06, frame);
+
+        // octets parasites avant le 0xFC de début: ignorés
+        const uint8_t garbage[] = { 0x00, 0x62, 0x55, 0xff, 0x10 };
+        HOST_CHECK(feed_all(assembler, garbage, sizeof(garbage)) == Result::PENDING);
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::FRAME_OK);
+        HOST_CHECK_EQ(assembler.frame().bytes[5], 0x06);
+
+        // longueur annoncée hors buffer: OVERFLOW, puis la trame suivante est reconnue
+        const uint8_t oversized[] = { 0xfc, 0x62, 0x01, 0x30, (uint8_t)MAX_DATA_BYTES };
+        HOST_CHECK(feed_all(assembler, oversized, sizeof(oversized)) == Result::OVERFLOW);
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::FRAME_OK);
+
+        // trame tronquée puis reset() (request_resync après reconnexion): pas de mélange avec la suivante
+        HOST_CHECK(feed_all(assembler, frame, len / 2) == Result::PENDING);
+        assembler.reset();
+        HOST_CHECK(feed_all(assembler, frame, len) == Result::FRAME_OK);
+        HOST_CHECK(assembler.frame().checksumOk);
+        HOST_CHECK_EQ(assembler.frame().length, len);
+    }
+
+    bool wait_for(const std::atomic<uint32_t>& counter, uint32_t target) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (counter.load() < target) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    void test_rx_task() {
+        SimulatedUnit unit;
+        cn105_host::HostUart uart(&unit);
+        esphome::UartRxTask task;
+        std::atomic<uint32_t> callbacks{ 0 };
+        task.set_frame_callback([&callbacks]() { callbacks++; });
+        HOST_CHECK(task.start(&uart));
+
+        uint8_t frame[SimulatedUnit::MAX_FRAME + 6];
+        const size_t len = info_frame(0x02, frame);
+        uart.inject(frame, len);
+        frame[len - 1] ^= 0x01;
+        uart.inject(frame, len);
+        frame[len - 1] ^= 0x01;
+        HOST_CHECK(wait_for(callbacks, 2));
+
+        RxFrame out;
+        HOST_CHECK(task.pop(out));
+        HOST_CHECK(out.checksumOk);
+        HOST_CHECK_EQ(out.length, len);
+        HOST_CHECK(task.pop(out));
+        HOST_CHECK(!out.checksumOk);        // remise au loop malgré le checksum faux
+        HOST_CHECK(!task.pop(out));
+        HOST_CHECK_EQ(task.get_bad_checksums(), 1);
+
+        // loop bloqué: au-delà de QUEUE_DEPTH les trames sont comptées perdues, les premières restent intactes
+        const uint32_t extra = 3;
+        for (uint32_t i = 0; i < esphome::UartRxTask::QUEUE_DEPTH + extra; i++) {
+            const size_t n = info_frame((uint8_t)i, frame);
+            uart.inject(frame, n);
+        }
+        HOST_CHECK(wait_for(callbacks, 2 + esphome::UartRxTask::QUEUE_DEPTH + extra));
+        HOST_CHECK_EQ(task.get_dropped_frames(), extra);
+        for (uint32_t i = 0; i < esphome::UartRxTask::QUEUE_DEPTH; i++) {
+            HOST_CHECK(task.pop(out));
+            HOST_CHECK_EQ(out.bytes[5], i);
+        }
+        HOST_CHECK(!task.pop(out));
+
+        task.stop();
+        HOST_CHECK(!task.is_running());
+    }
+
+}
+
+int main() {
+    test_queue_full_and_order();
+    test_queue_wraparound();
+    test_assembler_frames();
+    test_assembler_resync();
+    test_rx_task();
+    return HOST_CHECK_RESULT();
+}
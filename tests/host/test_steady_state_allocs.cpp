@@ -0,0 +1,68 @@
+// Régression: une fois connecté, le cycle de polling ne doit faire aucune allocation (operator new compté par AllocCounter).
+// Logs au niveau DEBUG des builds de production, envoyés vers /dev/null: leurs arguments sont évalués comme sur l'ESP.
+
+#include "alloc_counter.h"
+#include "host_check.h"
+#include "host_node.h"
+
+#include <cstdio>
+#include <memory>
+
+using cn105_host::HostNode;
+using cn105_host::NodeConfig;
+
+namespace {
+
+    const unsigned long STEADY_CYCLES = 50;
+
+    void check_scenario(const char* label, NodeConfig config) {
+        std::unique_ptr<HostNode> node(new HostNode(config));
+        HOST_CHECK(node->start_connected());
+
+        const unsigned long cycles_before = node->climate.nbCompleteCycles_;
+        const uint32_t count_before = esphome::AllocCounter::count();
+        const uint32_t bytes_before = esphome::AllocCounter::bytes();
+        // un cycle complet (7 requêtes à 2400 bauds) dure plus que update_interval: on compte les cycles, borné dans le temps
+        for (int i = 0; i < 600 && node->climate.nbCompleteCycles_ - cycles_before < STEADY_CYCLES; i++) {
+            node->run(1000);
+        }
+        const uint32_t allocations = esphome::AllocCounter::count() - count_before;
+        const uint32_t bytes = esphome::AllocCounter::bytes() - bytes_before;
+        const unsigned long cycles = node->climate.nbCompleteCycles_ - cycles_before;
+
+        std::printf("%-20s %3lu cycles, %u allocations (%u B)\n", label, cycles, (unsigned)allocations, (unsigned)bytes);
+        HOST_CHECK(cycles >= STEADY_CYCLES);
+        HOST_CHECK_EQ(allocations, 0);
+
+        esphome::App.reset();
+    }
+
+}
+
+int main() {
+    FILE* null_log = std::fopen("/dev/null", "w");
+    esphome::host::set_log(ESPHOME_LOG_LEVEL_DEBUG, null_log);
+    esphome::AllocCounter::watch_current_task();
+
+    NodeConfig config;
+    check_scenario("polling", config);
+
+    config.event_driven_loop = true;
+    check_scenario("event driven loop", config);
+
+    // réponses livrées d'un bloc: une seule attente de la tâche RX par trame
+    config.event_driven_loop = false;
+    config.uart_rx_task = true;
+    config.link.wire_speed = false;
+    check_scenario("uart rx task", config);
+
+    config.uart_rx_task = false;
+    config.link.wire_speed = true;
+    config.link.corrupt = 0.05f;
+    config.link.drop = 0.05f;
+    check_scenario("lossy link", config);
+
+    esphome::host::set_log(ESPHOME_LOG_LEVEL_NONE, nullptr);
+    std::fclose(null_log);
+    return HOST_CHECK_RESULT();
+}
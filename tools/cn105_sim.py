@@ -0,0 +1,467 @@
+#!/usr/bin/env python3
+"""CN105 heat pump simulator.
+
+Answers the CN105 protocol the way an indoor unit does, on a pseudo-terminal
+(default) or on a real serial port (USB adapter wired to the ESP CN105 UART):
+
+    CONNECT 0x5A / 0x5B    -> 0x7A / 0x7B
+    SET 0x41 (0x01 settings, 0x07 remote temp, 0x08 run states,
+              0x1F / 0x21 functions)                   -> 0x61
+    INFO 0x42 (0x02 0x03 0x04 0x05 0x06 0x09 0x42,
+               0x20 / 0x22 functions)                  -> 0x62
+
+Room temperature, compressor frequency, input power, kWh and runtime come
+from a small thermal + compressor model, so the values move like on a real
+unit. Link faults (latency, jitter, corrupted or dropped replies) and unit
+quirks can be injected to check throughput, latency and recovery.
+
+Stdlib only, Linux / macOS. Example:
+
+    python3 tools/cn105_sim.py --latency 30 --jitter 20 --corrupt 0.01 --quirk no-0x09
+    # prints: CN105 simulator on /dev/pts/5
+
+The module is also importable: SimulatedUnit is pure (frames in, frames out,
+step(dt) for the models) and is reused by tools/cn105_fleet.py.
+"""
+
+import argparse
+import math
+import os
+import random
+import select
+import sys
+import termios
+import time
+import tty
+
+# --- Protocol ---------------------------------------------------------------
+
+FRAME_START = 0xFC
+PACKET_LEN = 22
+MAX_DATA_BYTES = 64
+
+# 2400 bauds 8E1: 11 bits per byte on the wire
+BAUD = 2400
+BYTE_TIME_S = 11.0 / BAUD
+
+POWER = (0x00, 0x01)
+MODE = {0x01: "HEAT", 0x02: "DRY", 0x03: "COOL", 0x07: "FAN", 0x08: "AUTO"}
+TEMP_MAP = [31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16]  # index = setpoint code
+FAN_SPEED = {0x00: 0.6, 0x01: 0.3, 0x02: 0.4, 0x03: 0.6, 0x05: 0.8, 0x06: 1.0}  # AUTO QUIET 1 2 3 4
+
+# Same bytes as HPEmulator::CONFIG_RESPONSE (extended / installer connect)
+CONFIG_RESPONSE_DATA = bytes([0xC9, 0x03, 0x00, 0x20, 0x00, 0x14, 0x07, 0x75, 0x0C, 0x05,
+                              0xA0, 0xBE, 0x94, 0xBE, 0xA0, 0xBE])
+
+QUIRKS = {
+    "no-0x09": "never answer info 0x09 (older units)",
+    "zero-functions": "0x20 / 0x22 replies are all zero (functions not supported)",
+    "no-installer": "ignore the installer connect 0x5B",
+    "no-widevane": "report wide vane as 0x00",
+    "no-outside-temp": "report outside temperature as 0x00 (no sensor)",
+    "ignore-remote-temp": "ack 0x41/0x07 but keep regulating on the internal sensor",
+}
+
+
+def checksum(frame):
+    return (0xFC - sum(frame)) & 0xFF
+
+
+def make_frame(cmd, data):
+    frame = bytes([FRAME_START, cmd, 0x01, 0x30, len(data)]) + bytes(data)
+    return frame + bytes([checksum(frame)])
+
+
+def encode_half_degree(value):
+    return max(0, min(255, int(round(value * 2)) + 128))
+
+
+class FrameParser:
+    """Byte by byte reassembly, same rules as FrameAssembler (uart_rx_task.cpp)."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.bad_checksums = 0
+        self.overflows = 0
+
+    def feed(self, chunk):
+        frames = []
+        for b in chunk:
+            if not self.buf:
+                if b == FRAME_START:
+                    self.buf.append(b)
+                continue
+            self.buf.append(b)
+            if len(self.buf) >= 5:
+                total = self.buf[4] + 6
+                if total > MAX_DATA_BYTES:
+                    self.overflows += 1
+                    self.buf.clear()
+                elif len(self.buf) == total:
+                    frame = bytes(self.buf)
+                    self.buf.clear()
+                    if checksum(frame[:-1]) == frame[-1]:
+                        frames.append(frame)
+                    else:
+                        self.bad_checksums += 1
+        return frames
+
+
+# --- Unit model -------------------------------------------------------------
+
+class SimulatedUnit:
+    """One indoor + outdoor unit: settings, thermal model, compressor, protocol."""
+
+    # Room: first order model, the unit moves heat proportionally to compressor frequency
+    ROOM_TIME_CONSTANT_S = 3 * 3600.0     # envelope losses toward outside
+    ROOM_HEAT_CAPACITY_J_K = 2.5e6        # air + furniture of a ~30 m2 room
+    MAX_FREQUENCY_HZ = 90
+    MIN_FREQUENCY_HZ = 15
+    FREQUENCY_SLEW_HZ_S = 0.5             # inverter ramp
+    KP_HZ_PER_K = 25.0
+    KI_HZ_PER_KS = 0.02
+    COP = 3.5
+    WATTS_PER_HZ = 11.0
+    FAN_WATTS = 25.0
+    STANDBY_WATTS = 4.0
+
+    def __init__(self, room=19.0, outside=7.0, quirks=(), seed=None):
+        self.rng = random.Random(seed)
+        self.quirks = set(quirks)
+        # settings (raw protocol bytes)
+        self.power = 0x01
+        self.mode = 0x01
+        self.setpoint = 21.0
+        self.fan = 0x00
+        self.vane = 0x00
+        self.wide_vane = 0x03
+        self.isee = False
+        # run states (0x42 options, 0x08 airflow)
+        self.air_purifier = 0
+        self.night_mode = 0
+        self.circulator = 0
+        self.airflow_control = 0x00
+        # functions: code 101..128, value 1..3 (0 = not supported)
+        self.functions = {code: 1 + (code % 3) for code in range(101, 129)}
+        # physics
+        self.room = room
+        self.outside = outside
+        self.remote_temp = None
+        self.frequency = 0.0
+        self.integral = 0.0
+        self.input_watts = self.STANDBY_WATTS
+        self.energy_wh = 0.0
+        self.runtime_s = 0.0
+        self.defrost_s = 0.0
+
+    # -- models --
+
+    def _control_temperature(self):
+        if self.remote_temp is not None and "ignore-remote-temp" not in self.quirks:
+            return self.remote_temp
+        return self.room
+
+    def _demand_sign(self):
+        mode = MODE.get(self.mode, "HEAT")
+        if mode == "HEAT":
+            return 1
+        if mode in ("COOL", "DRY"):
+            return -1
+        if mode == "AUTO":
+            return 1 if self._control_temperature() < self.setpoint else -1
+        return 0
+
+    def step(self, dt):
+        """Advances the models by dt seconds."""
+        sign = self._demand_sign() if self.power else 0
+        target = 0.0
+        if sign != 0 and self.defrost_s <= 0:
+            error = sign * (self.setpoint - self._control_temperature())
+            self.integral = max(-3600.0, min(3600.0, self.integral + error * dt))
+            target = self.KP_HZ_PER_K * error + self.KI_HZ_PER_KS * self.integral
+            if MODE.get(self.mode) == "DRY":
+                target = min(target, 0.4 * self.MAX_FREQUENCY_HZ)
+            target = 0.0 if target < self.MIN_FREQUENCY_HZ else min(target, self.MAX_FREQUENCY_HZ)
+        else:
+            self.integral = 0.0
+
+        delta = target - self.frequency
+        max_delta = self.FREQUENCY_SLEW_HZ_S * dt
+        self.frequency += max(-max_delta, min(max_delta, delta))
+        if target == 0.0 and self.frequency < self.MIN_FREQUENCY_HZ:
+            self.frequency = 0.0
+
+        # outdoor coil icing in heat mode below ~3 °C: a few minutes of defrost every hour of run
+        if self.defrost_s > 0:
+            self.defrost_s -= dt
+        elif sign > 0 and self.outside < 3.0 and self.frequency > 0 and self.rng.random() < dt / 3600.0:
+            self.defrost_s = 300.0
+
+        compressor_watts = self.frequency * self.WATTS_PER_HZ
+        fan_watts = self.FAN_WATTS * FAN_SPEED.get(self.fan, 0.6) if self.power else 0.0
+        self.input_watts = self.STANDBY_WATTS + compressor_watts + fan_watts
+        heat_watts = sign * compressor_watts * self.COP
+        if self.defrost_s > 0:
+            heat_watts = -0.3 * compressor_watts
+
+        losses = (self.outside - self.room) / self.ROOM_TIME_CONSTANT_S
+        self.room += (losses + heat_watts / self.ROOM_HEAT_CAPACITY_J_K) * dt
+        self.outside += self.rng.gauss(0.0, 0.002) * math.sqrt(dt)
+        self.energy_wh += self.input_watts * dt / 3600.0
+        if self.power:
+            self.runtime_s += dt
+
+    # -- protocol --
+
+    def handle(self, frame):
+        """Returns the reply to one valid frame, or None when a real unit stays silent."""
+        cmd = frame[1]
+        data = frame[5:-1]
+        if cmd == 0x5A:
+            return make_frame(0x7A, [0x00])
+        if cmd == 0x5B:
+            return None if "no-installer" in self.quirks else make_frame(0x7B, CONFIG_RESPONSE_DATA)
+        if cmd == 0x41 and data:
+            self._apply_set(data)
+            return make_frame(0x61, [0x00] * 16)
+        if cmd == 0x42 and data:
+            payload = self._info(data[0])
+            return None if payload is None else make_frame(0x62, payload)
+        return None
+
+    def _apply_set(self, data):
+        kind = data[0]
+        if kind == 0x01:
+            mask1, mask2 = data[1], data[2]
+            if mask1 & 0x01:
+                self.power = data[3]
+            if mask1 & 0x02:
+                self.mode = data[4]
+            if mask1 & 0x04:
+                # half degree setpoint (data[14]) wins over the legacy 16 steps code
+                if data[14]:
+                    self.setpoint = (data[14] - 128) / 2.0
+                elif data[5] < len(TEMP_MAP):
+                    self.setpoint = float(TEMP_MAP[data[5]])
+            if mask1 & 0x08:
+                self.fan = data[6]
+            if mask1 & 0x10:
+                self.vane = data[7]
+            if mask2 & 0x01:
+                self.wide_vane = data[13] & 0x0F
+        elif kind == 0x07:
+            if data[1] == 0x01:
+                self.remote_temp = (data[3] - 128) / 2.0
+            else:
+                self.remote_temp = None
+        elif kind == 0x08:
+            self.airflow_control = data[6]
+            self.air_purifier = data[12]
+            self.night_mode = data[13]
+            self.circulator = data[14]
+        elif kind in (0x1F, 0x21):
+            for b in data[1:16]:
+                code = (b >> 2) + 100
+                if b and code in self.functions:
+                    self.functions[code] = b & 0x03
+
+    def _info(self, code):
+        d = [0x00] * 16
+        d[0] = code
+        if code == 0x02:
+            d[3] = self.power
+            d[4] = self.mode + (0x08 if self.isee else 0)
+            d[5] = TEMP_MAP.index(int(min(31, max(16, round(self.setpoint)))))
+            d[6] = self.fan
+            d[7] = self.vane
+            d[10] = 0x00 if "no-widevane" in self.quirks else self.wide_vane
+            d[11] = encode_half_degree(self.setpoint)
+            d[14] = self.airflow_control
+        elif code == 0x03:
+            d[3] = max(0, min(31, int(round(self.room)) - 10))
+            d[5] = 0x00 if "no-outside-temp" in self.quirks else encode_half_degree(self.outside)
+            d[6] = encode_half_degree(self.room)
+            minutes = int(self.runtime_s // 60) & 0xFFFFFF
+            d[11], d[12], d[13] = (minutes >> 16) & 0xFF, (minutes >> 8) & 0xFF, minutes & 0xFF
+        elif code == 0x06:
+            d[3] = int(round(self.frequency))
+            d[4] = 0x01 if self.frequency > 0 else 0x00
+            watts = int(round(self.input_watts)) & 0xFFFF
+            d[5], d[6] = watts >> 8, watts & 0xFF
+            tenths = int(self.energy_wh / 100) & 0xFFFF
+            d[7], d[8] = tenths >> 8, tenths & 0xFF
+        elif code == 0x09:
+            if "no-0x09" in self.quirks:
+                return None
+            d[3] = 0x02 if self.defrost_s > 0 else (0x08 if self.power and self.frequency == 0 else 0x00)
+            stage = 0 if self.frequency == 0 else 1 + min(4, int(self.frequency * 5 / self.MAX_FREQUENCY_HZ))
+            d[4] = stage
+            mode = MODE.get(self.mode)
+            if mode == "AUTO":
+                d[5] = 0x02 if self._demand_sign() > 0 else 0x01
+        elif code == 0x42:
+            d[1], d[2], d[3] = self.air_purifier, self.night_mode, self.circulator
+        elif code in (0x20, 0x22):
+            if "zero-functions" not in self.quirks:
+                codes = range(101, 116) if code == 0x20 else range(116, 129)
+                for i, fcode in enumerate(codes):
+                    d[1 + i] = ((fcode - 100) << 2) | self.functions[fcode]
+        # 0x04 (unknown) and 0x05 (timers) answer with an empty payload, like most units
+        return d
+
+
+# --- Link -------------------------------------------------------------------
+
+class LinkProfile:
+    """Delivery of the replies: latency, jitter, corruption, drops, wire speed."""
+
+    def __init__(self, latency_ms=20.0, jitter_ms=0.0, corrupt=0.0, drop=0.0, wire_speed=True, seed=None):
+        self.latency_s = latency_ms / 1000.0
+        self.jitter_s = jitter_ms / 1000.0
+        self.corrupt = corrupt
+        self.drop = drop
+        self.wire_speed = wire_speed
+        self.rng = random.Random(seed)
+
+    def delay(self):
+        return max(0.0, self.latency_s + self.rng.uniform(-self.jitter_s, self.jitter_s))
+
+    def mangle(self, frame):
+        """Returns the bytes actually sent (None = lost); a corrupted frame keeps its length."""
+        if self.drop and self.rng.random() < self.drop:
+            return None
+        if self.corrupt and self.rng.random() < self.corrupt:
+            frame = bytearray(frame)
+            frame[self.rng.randrange(len(frame))] ^= 1 << self.rng.randrange(8)
+            return bytes(frame)
+        return frame
+
+    def transmit_time(self, nbytes):
+        return nbytes * BYTE_TIME_S if self.wire_speed else 0.0
+
+
+class Stats:
+    def __init__(self):
+        self.rx_frames = 0
+        self.tx_frames = 0
+        self.unanswered = 0
+        self.dropped = 0
+        self.corrupted = 0
+        self.by_code = {}
+
+    def count(self, frame):
+        key = "%02X" % frame[1] if frame[1] != 0x42 else "42/%02X" % frame[5]
+        self.by_code[key] = self.by_code.get(key, 0) + 1
+
+
+def open_port(device):
+    """Opens a pty (device None) or a real tty in raw 8E1 mode; returns (fd, name)."""
+    if device is None:
+        master, slave = os.openpty()
+        tty.setraw(slave)
+        name = os.ttyname(slave)
+        # keep the slave open: the pty would report EIO on every read while no client is attached
+        return master, name, slave
+    fd = os.open(device, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[2] = (attrs[2] & ~(termios.CSIZE | termios.PARODD | termios.CSTOPB)) | termios.CS8 | termios.PARENB | termios.CLOCAL | termios.CREAD
+    attrs[4] = attrs[5] = termios.B2400
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd, device, None
+
+
+def serve(unit, link, fd, speed=1.0, report_s=10.0, log_frames=False):
+    parser = FrameParser()
+    stats = Stats()
+    outbox = []           # (due time, bytes)
+    last = time.monotonic()
+    next_report = last + report_s
+    while True:
+        now = time.monotonic()
+        timeout = 0.05 if not outbox else max(0.0, min(0.05, outbox[0][0] - now))
+        ready, _, _ = select.select([fd], [], [], timeout)
+        now = time.monotonic()
+        unit.step((now - last) * speed)
+        last = now
+
+        if ready:
+            try:
+                chunk = os.read(fd, 256)
+            except OSError:
+                chunk = b""
+            for frame in parser.feed(chunk):
+                stats.rx_frames += 1
+                stats.count(frame)
+                if log_frames:
+                    print("RX " + frame.hex(" "), flush=True)
+                reply = unit.handle(frame)
+                if reply is None:
+                    stats.unanswered += 1
+                    continue
+                sent = link.mangle(reply)
+                if sent is None:
+                    stats.dropped += 1
+                    continue
+                if sent != reply:
+                    stats.corrupted += 1
+                # the request itself is still on the wire when the unit starts counting
+                outbox.append((now + link.transmit_time(len(frame)) + link.delay(), sent))
+                outbox.sort(key=lambda item: item[0])
+
+        while outbox and outbox[0][0] <= time.monotonic():
+            _, data = outbox.pop(0)
+            os.write(fd, data)
+            stats.tx_frames += 1
+            if log_frames:
+                print("TX " + data.hex(" "), flush=True)
+            if link.wire_speed:
+                time.sleep(link.transmit_time(len(data)))
+
+        if report_s and now >= next_report:
+            next_report = now + report_s
+            print("rx=%d tx=%d silent=%d dropped=%d corrupted=%d bad_cs_in=%d | room=%.2f set=%.1f freq=%.0fHz %dW %.2fkWh | %s" % (
+                stats.rx_frames, stats.tx_frames, stats.unanswered, stats.dropped, stats.corrupted,
+                parser.bad_checksums, unit.room, unit.setpoint, unit.frequency, unit.input_watts,
+                unit.energy_wh / 1000.0, " ".join("%s:%d" % kv for kv in sorted(stats.by_code.items()))), flush=True)
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description="CN105 heat pump simulator on a pty or serial port")
+    ap.add_argument("--device", help="real serial port (USB adapter, 2400 8E1) instead of a pty")
+    ap.add_argument("--latency", type=float, default=20.0, help="reply latency in ms (default 20)")
+    ap.add_argument("--jitter", type=float, default=0.0, help="+/- latency jitter in ms")
+    ap.add_argument("--corrupt", type=float, default=0.0, help="probability of one flipped bit per reply")
+    ap.add_argument("--drop", type=float, default=0.0, help="probability of a lost reply")
+    ap.add_argument("--no-wire-speed", action="store_true", help="do not pace bytes at 2400 bauds")
+    ap.add_argument("--quirk", action="append", default=[], choices=sorted(QUIRKS), help="unit quirk (repeatable)")
+    ap.add_argument("--room", type=float, default=19.0, help="initial room temperature °C")
+    ap.add_argument("--outside", type=float, default=7.0, help="outside temperature °C")
+    ap.add_argument("--speed", type=float, default=1.0, help="model time acceleration (60 = 1 min per second)")
+    ap.add_argument("--seed", type=int, help="random seed (reproducible faults)")
+    ap.add_argument("--report", type=float, default=10.0, help="stats period in s (0 = off)")
+    ap.add_argument("--log-frames", action="store_true", help="print every frame")
+    ap.add_argument("--link", help="also create a symlink with this name to the pty")
+    args = ap.parse_args(argv)
+
+    unit = SimulatedUnit(room=args.room, outside=args.outside, quirks=args.quirk, seed=args.seed)
+    link = LinkProfile(args.latency, args.jitter, args.corrupt, args.drop, not args.no_wire_speed, seed=args.seed)
+    fd, name, _keep = open_port(args.device)
+    if args.link and args.device is None:
+        if os.path.islink(args.link):
+            os.unlink(args.link)
+        os.symlink(name, args.link)
+        name = "%s -> %s" % (args.link, name)
+    print("CN105 simulator on %s (quirks: %s)" % (name, ", ".join(args.quirk) or "none"), flush=True)
+    try:
+        serve(unit, link, fd, args.speed, args.report, args.log_frames)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.link and args.device is None and os.path.islink(args.link):
+            os.unlink(args.link)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())